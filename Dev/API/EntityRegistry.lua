@@ -0,0 +1,90 @@
+--- @meta
+error("this is a lua library module")
+
+--- Archetype based entity storage, entities of the same type are packed in dense rows, each per-entity component has its
+--- own column. Entity ids are generational, a despawned id never refers to a recycled slot.
+--- @class TE.EntityRegistry
+local entityRegistry = {}
+
+--- Define per-entity component columns of an entity type.
+--- Existing entities of this type keep components that still exist, new columns are `nil`.
+--- @param typeID integer
+--- @param componentTypeIDs integer[]
+function entityRegistry:registerArchetype(typeID, componentTypeIDs) end
+
+--- @param typeID integer
+--- @return boolean
+function entityRegistry:hasArchetype(typeID) end
+
+--- @param typeID integer
+--- @return integer entityID
+function entityRegistry:spawn(typeID) end
+
+--- Allocate an entity id without spawning it, the entity does not exist until `commit`.
+--- @return integer entityID
+function entityRegistry:reserve() end
+
+--- @param entityID integer
+--- @param typeID integer
+--- @return boolean
+function entityRegistry:commit(entityID, typeID) end
+
+--- The last entity of the same type is moved into the removed row.
+--- @param entityID integer
+--- @return boolean
+function entityRegistry:despawn(entityID) end
+
+--- @param entityID integer
+--- @return boolean
+function entityRegistry:exists(entityID) end
+
+--- @param entityID integer
+--- @return integer?
+function entityRegistry:getTypeID(entityID) end
+
+--- @param entityID integer
+--- @param componentTypeID integer
+--- @return any
+function entityRegistry:getComponent(entityID, componentTypeID) end
+
+--- @param entityID integer
+--- @param componentTypeID integer
+--- @param value any
+--- @return boolean
+function entityRegistry:setComponent(entityID, componentTypeID, value) end
+
+--- @return integer
+function entityRegistry:count() end
+
+--- @param typeID integer
+--- @return integer
+function entityRegistry:countByType(typeID) end
+
+--- @return integer
+function entityRegistry:getMaxTypeID() end
+
+--- @param typeID integer
+--- @param index integer
+--- @return integer? entityID
+function entityRegistry:entityAt(typeID, index) end
+
+--- Copy ids of all entities of a type into `entities[1..n]`, entries after `n` are cleared.
+--- Iterating the filled table avoids a native call per entity, refill it after entities were spawned or despawned.
+--- @param typeID integer
+--- @param entities integer[]
+--- @return integer n
+function entityRegistry:fillEntities(typeID, entities) end
+
+function entityRegistry:clear() end
+
+--- Only columns whose component type id is a key of `serializableComponents` are written.
+--- @param serializableComponents table<integer, boolean>
+--- @return table
+function entityRegistry:serialize(serializableComponents) end
+
+--- Archetypes must be registered before deserialization, columns absent from `data` are `nil`.
+--- @param data table
+function entityRegistry:deserialize(data) end
+
+--- @return TE.EntityRegistry
+function EntityRegistry() end
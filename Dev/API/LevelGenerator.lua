@@ -0,0 +1,53 @@
+--- @meta
+error("this is a lua library module")
+
+--- Seed deterministic level generator: rooms, corridors, noise based floor variation and wall cleanup.
+--- Generation only uses integer math, same params produce same level on every platform.
+--- @class TE.LevelGenerator
+local levelGenerator = {}
+
+--- @class TE.LevelGeneratorParams
+--- @field seed integer
+--- @field x integer? @default 0
+--- @field y integer? @default 0
+--- @field width integer? @default 64
+--- @field height integer? @default 64
+--- @field roomAttempts integer? @default 32
+--- @field roomMinSize integer? @default 4
+--- @field roomMaxSize integer? @default 10
+--- @field noiseScale integer? @default 8 Lattice size of noise field in tiles.
+--- @field noiseThreshold integer? @default 160 Floors with noise above threshold use `altFloorType`, [0, 255].
+--- @field emptyType integer? @default 0
+--- @field floorType integer? @default 1
+--- @field wallType integer? @default 2
+--- @field altFloorType integer? @default floorType
+
+--- @class TE.LevelGeneratorResult
+--- @field requestID integer 0 for levels from `generate`.
+--- @field x integer
+--- @field y integer
+--- @field width integer
+--- @field height integer
+--- @field typeIDs integer[] Row major.
+--- @field rooms integer[] Flat rects `{ x1, y1, w1, h1, ... }` in tile coordinates.
+
+--- Generate on calling thread.
+--- @param params TE.LevelGeneratorParams
+--- @return TE.LevelGeneratorResult
+function levelGenerator:generate(params) end
+
+--- Generate on background thread.
+--- @param params TE.LevelGeneratorParams
+--- @return integer requestID
+function levelGenerator:request(params) end
+
+--- Pop one generated level, levels are popped in request order.
+--- @return TE.LevelGeneratorResult?
+function levelGenerator:poll() end
+
+--- Count of requests not popped yet.
+--- @return integer
+function levelGenerator:getPendingCount() end
+
+--- @return TE.LevelGenerator
+function LevelGenerator() end
@@ -0,0 +1,93 @@
+--- @meta
+error("this is a lua library module")
+
+--- Grid of movement costs in tile coordinates, cost 0 means blocked.
+--- Use `findPath` for single agents, and flow fields when many agents chase the same target: a field is computed once,
+--- then every agent only looks up the direction of its own tile.
+--- @class TE.PathGrid
+local pathGrid = {}
+
+--- @return integer x
+--- @return integer y
+--- @return integer width
+--- @return integer height
+function pathGrid:getBounds() end
+
+--- @param x integer
+--- @param y integer
+--- @return boolean
+function pathGrid:isInBound(x, y) end
+
+--- @param x integer
+--- @param y integer
+--- @return integer cost 0 if blocked or out of bound.
+function pathGrid:getCost(x, y) end
+
+--- Editing costs drops all flow fields.
+--- @param x integer
+--- @param y integer
+--- @param cost integer 0 ~ 255
+function pathGrid:setCost(x, y, cost) end
+
+--- Load costs of all tiles at once.
+--- @param typeIDs integer[] Tile type ids in row major order.
+--- @param costs table<integer, integer> Cost of each type id, missing types cost 1.
+function pathGrid:loadTypeIDs(typeIDs, costs) end
+
+--- Load costs from tile tags of a tile map layer, tiles outside the tile map are blocked.
+--- @param tileMap TE.TileMap
+--- @param tagCosts table<integer, integer> Cost of each tile tag, missing tags cost 1.
+--- @param layer integer? @default 1
+function pathGrid:loadTileMap(tileMap, tagCosts, layer) end
+
+--- @return boolean
+function pathGrid:isDiagonal() end
+
+--- Diagonal moves are enabled by default, they never cut corners of blocked tiles.
+--- @param diagonal boolean
+function pathGrid:setDiagonal(diagonal) end
+
+--- A* search.
+--- @param startX integer
+--- @param startY integer
+--- @param targetX integer
+--- @param targetY integer
+--- @param maxVisits integer? Give up after visiting this many tiles.
+--- @return integer[]? path Flat coordinates `{ x1, y1, x2, y2, ... }` from start to target, nil if unreachable.
+function pathGrid:findPath(startX, startY, targetX, targetY, maxVisits) end
+
+--- Compute flow field towards target immediately.
+--- @param targetX integer
+--- @param targetY integer
+--- @return boolean
+function pathGrid:computeFlowField(targetX, targetY) end
+
+--- Compute flow field towards target on a background thread, does nothing if the field is ready or already requested.
+--- @param targetX integer
+--- @param targetY integer
+--- @return boolean requested
+function pathGrid:requestFlowField(targetX, targetY) end
+
+--- @param targetX integer
+--- @param targetY integer
+--- @return boolean
+function pathGrid:hasFlowField(targetX, targetY) end
+
+--- Direction to move from tile `(x, y)` towards target, both 0 at target.
+--- @param targetX integer
+--- @param targetY integer
+--- @param x integer
+--- @param y integer
+--- @return integer? dx nil if the field is not ready or the target is unreachable.
+--- @return integer? dy
+--- @return integer? distance Weighted distance to target, 10 per straight step and 14 per diagonal step.
+function pathGrid:getFlowDirection(targetX, targetY, x, y) end
+
+function pathGrid:clearFlowFields() end
+
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @return TE.PathGrid
+function PathGrid(x, y, width, height) end
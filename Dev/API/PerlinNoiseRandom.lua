@@ -83,6 +83,42 @@ function noiseRandom:int2(x, y, min, max) end
 function noiseRandom:int3(x, y, z, min, max) end
 
 --- @class TE.PerlinNoiseRandom : TE.NoiseRandom
+local perlinNoiseRandom = {}
+
+--- `noise2` of each tile in a rect, in row major order.
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param buffer number[]? Table to fill instead of creating a new one.
+--- @return number[]
+function perlinNoiseRandom:fillNoise2(x, y, width, height, buffer) end
+
+--- `int2` of each tile in a rect, in row major order. Recent rects are cached natively by seed, frequency, rect and
+--- range, so refilling the same rect is cheap.
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param min integer
+--- @param max integer
+--- @param buffer integer[]? Table to fill instead of creating a new one.
+--- @return integer[]
+function perlinNoiseRandom:fillInt2(x, y, width, height, min, max, buffer) end
+
+--- `noise2` of each coordinate.
+--- @param coords number[] Flat coordinates `{ x1, y1, x2, y2, ... }`.
+--- @param buffer number[]?
+--- @return number[]
+function perlinNoiseRandom:sampleNoise2(coords, buffer) end
+
+--- `int2` of each coordinate.
+--- @param coords number[] Flat coordinates `{ x1, y1, x2, y2, ... }`.
+--- @param min integer
+--- @param max integer
+--- @param buffer integer[]?
+--- @return integer[]
+function perlinNoiseRandom:sampleInt2(coords, min, max, buffer) end
 
 --- @return TE.PerlinNoiseRandom
 function PerlinNoiseRandom() end
@@ -0,0 +1,98 @@
+--- @meta
+error("this is a lua library module")
+
+--- 2D rigid body simulation with a uniform grid broadphase, supports circles and axis aligned rects.
+--- Simulation uses fixed point numbers with 16 fractional bits, inputs are quantized, results are bit-identical on every
+--- platform.
+--- @class TE.PhysicsWorld
+local physicsWorld = {}
+
+--- @param x number
+--- @param y number
+--- @param radius number
+--- @param mass number 0 for static bodies.
+--- @return integer bodyID
+function physicsWorld:addCircle(x, y, radius, mass) end
+
+--- @param x number
+--- @param y number
+--- @param width number
+--- @param height number
+--- @param mass number 0 for static bodies.
+--- @return integer bodyID
+function physicsWorld:addRect(x, y, width, height, mass) end
+
+--- @param bodyID integer
+--- @return boolean
+function physicsWorld:removeBody(bodyID) end
+
+--- @param bodyID integer
+--- @return boolean
+function physicsWorld:hasBody(bodyID) end
+
+--- @return integer
+function physicsWorld:getBodyCount() end
+
+--- @param bodyID integer
+--- @return number x
+--- @return number y
+function physicsWorld:getPosition(bodyID) end
+
+--- @param bodyID integer
+--- @param x number
+--- @param y number
+--- @return boolean
+function physicsWorld:setPosition(bodyID, x, y) end
+
+--- @param bodyID integer
+--- @return number x
+--- @return number y
+function physicsWorld:getVelocity(bodyID) end
+
+--- @param bodyID integer
+--- @param x number
+--- @param y number
+--- @return boolean
+function physicsWorld:setVelocity(bodyID, x, y) end
+
+--- Grid cell size of broadphase, should be around the size of common bodies.
+--- @return number
+function physicsWorld:getCellSize() end
+
+--- @param cellSize number
+function physicsWorld:setCellSize(cellSize) end
+
+--- Integrate, detect and resolve collisions.
+--- @param deltaTime number
+--- @return integer contactCount
+function physicsWorld:step(deltaTime) end
+
+--- @return integer
+function physicsWorld:getContactCount() end
+
+--- Contact found in the latest step, the normal points from `a` to `b`.
+--- @param index integer
+--- @return integer a
+--- @return integer b
+--- @return number normalX
+--- @return number normalY
+--- @return number depth
+function physicsWorld:getContact(index) end
+
+--- FNV-1a hash of simulation state truncated to 53 bits, equal states on different peers have equal hashes.
+--- @return integer
+function physicsWorld:getStateHash() end
+
+--- Binary dump of simulation state, body ids stay valid after `deserialize`.
+--- @return string
+function physicsWorld:serialize() end
+
+--- @param data string
+--- @return boolean success
+function physicsWorld:deserialize(data) end
+
+function physicsWorld:clear() end
+
+--- @param cellSize number? @default 64
+--- @return TE.PhysicsWorld
+function PhysicsWorld(cellSize) end
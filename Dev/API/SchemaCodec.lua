@@ -0,0 +1,43 @@
+--- @meta
+error("this is a lua library module")
+
+--- Binary codec for tables with known fields, layouts are compiled from tables of default values.
+--- Field names are never written, booleans take 2 bits, integers are varints. Values of other types than their
+--- defaults and keys missing from schema are still encoded, so any table survives a round trip.
+--- @class TE.SchemaCodec
+local schemaCodec = {}
+
+--- Compile a schema, field kinds are taken from default values. Compiling an existing id replaces it.
+--- @param schemaID integer
+--- @param defaults table
+function schemaCodec:compile(schemaID, defaults) end
+
+--- @param schemaID integer
+--- @return boolean
+function schemaCodec:hasSchema(schemaID) end
+
+function schemaCodec:clear() end
+
+--- @param schemaID integer
+--- @param record table
+--- @return string
+function schemaCodec:encode(schemaID, record) end
+
+--- @param schemaID integer
+--- @param data string
+--- @return table
+function schemaCodec:decode(schemaID, data) end
+
+--- Encode a list of records sharing one schema.
+--- @param schemaID integer
+--- @param records table[]
+--- @return string
+function schemaCodec:encodeList(schemaID, records) end
+
+--- @param schemaID integer
+--- @param data string
+--- @return table[]
+function schemaCodec:decodeList(schemaID, data) end
+
+--- @return TE.SchemaCodec
+function SchemaCodec() end
@@ -0,0 +1,38 @@
+--- @meta
+error("this is a lua library module")
+
+--- @enum TE.EScriptProfileFormat
+EScriptProfileFormat = {
+	--- "event;handler;frame;frame count" per line, for flamegraph.pl, speedscope, etc.
+	Collapsed = 0,
+	--- Chrome trace event JSON, open with chrome://tracing or Perfetto.
+	ChromeTrace = 1,
+}
+
+--- Sampling profiler built on `jit.profile`, samples are attributed to the invoking event and handler.
+--- @class TE.ScriptProfiler
+local scriptProfiler = {}
+
+--- @param intervalMS integer? Sampling interval in milliseconds, default `1`.
+--- @param stackDepth integer? Maximum lua frames recorded per sample, default `32`.
+--- @return boolean
+function scriptProfiler:start(intervalMS, stackDepth) end
+
+function scriptProfiler:stop() end
+
+--- @return boolean
+function scriptProfiler:isRunning() end
+
+--- Drop all collected samples.
+function scriptProfiler:clear() end
+
+--- @return integer
+function scriptProfiler:getTotalSamples() end
+
+--- Write collected samples to user storage.
+--- @param filePath string
+--- @param format TE.EScriptProfileFormat? Default `EScriptProfileFormat.Collapsed`.
+--- @return boolean
+function scriptProfiler:export(filePath, format) end
+
+TE.scriptProfiler = scriptProfiler
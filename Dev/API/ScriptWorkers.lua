@@ -0,0 +1,32 @@
+--- @meta
+error("this is a lua library module")
+
+--- @class TE.ScriptWorkers
+local scriptWorkers = {}
+
+--- Run `func(args)` on a sandboxed worker state in background.
+--- `func` must be a pure lua function without upvalues, it can only access the same standard globals as mods, and `require`
+--- a few static modules e.g. "TE.Math", "TE.Geometry", "string.buffer", "table.new".
+--- `args` and the first return value of `func` are copied between states by `string.buffer.encode`, so they cannot contain
+--- functions, userdata nor threads.
+--- `callback` is invoked on main thread at the beginning of a tick, with `(result)` on success or `(nil, errorMessage)` on failure.
+--- @param func fun(args: any): any
+--- @param args any
+--- @param callback (fun(result: any, errorMessage: string?))?
+--- @return integer jobID
+function scriptWorkers:submit(func, args, callback) end
+
+--- Drop a job, if the job is already running, its result will be discarded.
+--- @param jobID integer
+--- @return boolean
+function scriptWorkers:cancel(jobID) end
+
+--- Number of submitted jobs whose results are not dispatched yet.
+--- @return integer
+function scriptWorkers:getPendingJobs() end
+
+--- Worker threads are started on first submission, returns `0` before that.
+--- @return integer
+function scriptWorkers:getWorkerCount() end
+
+TE.scriptWorkers = scriptWorkers
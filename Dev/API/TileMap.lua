@@ -0,0 +1,132 @@
+--- @meta
+error("this is a lua library module")
+
+--- Layered tile type storage, types are packed 16 bit integers per layer.
+--- Tags and flags are set per tile type, editing tiles marks the chunks of 16x16 tiles they belong to dirty.
+--- Layer parameters are 1-based and default to the first layer.
+--- @class TE.TileMap
+local tileMap = {}
+
+--- @return integer x
+--- @return integer y
+--- @return integer width
+--- @return integer height
+function tileMap:getBounds() end
+
+--- @param x integer
+--- @param y integer
+--- @return boolean
+function tileMap:isInBound(x, y) end
+
+--- @return integer
+function tileMap:getLayerCount() end
+
+--- Load all types of a layer at once.
+--- @param typeIDs integer[] Type ids in row major order.
+--- @param layer integer?
+function tileMap:loadTypeIDs(typeIDs, layer) end
+
+--- @param x integer
+--- @param y integer
+--- @param layer integer?
+--- @return integer typeID 0 if out of bound.
+function tileMap:getType(x, y, layer) end
+
+--- @param x integer
+--- @param y integer
+--- @param typeID integer
+--- @param layer integer?
+--- @return boolean
+function tileMap:setType(x, y, typeID, layer) end
+
+--- Set types in a rect, the rect is clipped to map bounds.
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param typeID integer
+--- @param layer integer?
+function tileMap:fill(x, y, width, height, typeID, layer) end
+
+--- @param typeID integer
+--- @param tag integer 0 ~ 255
+--- @param flags integer 32 bit flags.
+function tileMap:setTypeInfo(typeID, tag, flags) end
+
+function tileMap:clearTypeInfos() end
+
+--- @param x integer
+--- @param y integer
+--- @param layer integer?
+--- @return integer? tag nil if out of bound or the type has no info.
+function tileMap:getTag(x, y, layer) end
+
+--- @param x integer
+--- @param y integer
+--- @param layer integer?
+--- @return integer? flags nil if out of bound or the type has no info.
+function tileMap:getFlags(x, y, layer) end
+
+--- @param x integer
+--- @param y integer
+--- @param flags integer
+--- @param layer integer?
+--- @return boolean hasAll
+function tileMap:hasFlags(x, y, flags, layer) end
+
+--- Types of a whole row.
+--- @param y integer
+--- @param buffer integer[]? Table to fill instead of creating a new one, entries past the row are set to nil.
+--- @param layer integer?
+--- @return integer[]
+function tileMap:getRow(y, buffer, layer) end
+
+--- Neighbour masks of a whole row, one call instead of 2 ~ 4 `getTag` calls per tile.
+--- Bits: 1 up, 2 right, 4 down, 8 left tile is tagged `tag`; 16 left, 32 right tile has any type info.
+--- @param y integer
+--- @param tag integer
+--- @param buffer integer[]? Table to fill instead of creating a new one, entries past the row are set to nil.
+--- @param layer integer?
+--- @return integer[]
+function tileMap:getNeighbourRow(y, tag, buffer, layer) end
+
+--- Types in a rect in row major order, 0 for tiles out of bound.
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param layer integer?
+--- @return integer[]
+function tileMap:getRect(x, y, width, height, layer) end
+
+--- Find tiles with a tag in a rect.
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param tag integer
+--- @param layer integer?
+--- @return integer[] coords Flat coordinates `{ x1, y1, x2, y2, ... }`.
+function tileMap:queryTag(x, y, width, height, tag, layer) end
+
+--- @return boolean
+function tileMap:isDirty() end
+
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+function tileMap:markDirty(x, y, width, height) end
+
+--- @return integer[] regions Flat rects `{ x1, y1, w1, h1, x2, y2, w2, h2, ... }` of dirty chunks.
+function tileMap:getDirtyRegions() end
+
+function tileMap:clearDirty() end
+
+--- @param x integer
+--- @param y integer
+--- @param width integer
+--- @param height integer
+--- @param layers integer? @default 1
+--- @return TE.TileMap
+function TileMap(x, y, width, height, layers) end
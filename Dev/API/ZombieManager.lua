@@ -0,0 +1,98 @@
+--- @meta
+error("this is a lua library module")
+
+--- Pooled native zombie storage. Zombies are packed in one contiguous array and addressed by generational object ids,
+--- a despawned id never refers to a recycled slot.
+--- @class TE.ZombieManager
+local zombieManager = {}
+
+--- Preallocate storage for `capacity` zombies.
+--- @param capacity integer
+function zombieManager:reserve(capacity) end
+
+--- @param x number
+--- @param y number
+--- @param health number? @default 1
+--- @return integer objectID
+function zombieManager:spawn(x, y, health) end
+
+--- The last zombie is moved into the removed position, so iteration order changes after despawning.
+--- @param objectID integer
+--- @return boolean
+function zombieManager:despawn(objectID) end
+
+--- @param objectID integer
+--- @return boolean
+function zombieManager:exists(objectID) end
+
+--- @return integer
+function zombieManager:count() end
+
+--- Iterate with `for index = 1, manager:count() do local objectID = manager:objectAt(index) end`.
+--- @param index integer 1 based.
+--- @return integer? objectID
+function zombieManager:objectAt(index) end
+
+--- Ids of all zombies in storage order.
+--- @param buffer integer[]? Reused if provided, elements after the last id are cleared.
+--- @return integer[]
+function zombieManager:getObjectIDs(buffer) end
+
+--- @param objectID integer
+--- @return number? x
+--- @return number? y
+function zombieManager:getPosition(objectID) end
+
+--- @param objectID integer
+--- @param x number
+--- @param y number
+--- @return boolean
+function zombieManager:setPosition(objectID, x, y) end
+
+--- @param objectID integer
+--- @return number? velocityX
+--- @return number? velocityY
+function zombieManager:getVelocity(objectID) end
+
+--- @param objectID integer
+--- @param velocityX number
+--- @param velocityY number
+--- @return boolean
+function zombieManager:setVelocity(objectID, velocityX, velocityY) end
+
+--- @param objectID integer
+--- @return number?
+function zombieManager:getHealth(objectID) end
+
+--- @param objectID integer
+--- @param health number
+--- @return boolean
+function zombieManager:setHealth(objectID, health) end
+
+--- @param objectID integer
+--- @return integer?
+function zombieManager:getFlags(objectID) end
+
+--- @param objectID integer
+--- @param flags integer
+--- @return boolean
+function zombieManager:setFlags(objectID, flags) end
+
+--- Move all zombies by their velocities.
+--- @param deltaTime number
+function zombieManager:update(deltaTime) end
+
+function zombieManager:clear() end
+
+--- Raw memory snapshot including slot generations, ids stay valid after `deserialize`.
+--- Only readable by the same build on the same platform.
+--- @return string
+function zombieManager:serialize() end
+
+--- Replace all zombies with a snapshot, nothing changes if data is invalid.
+--- @param data string
+--- @return boolean
+function zombieManager:deserialize(data) end
+
+--- @return TE.ZombieManager
+function ZombieManager() end
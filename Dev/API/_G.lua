@@ -81,6 +81,15 @@ function persist(key, defaultValue, getter) end
 --- @nodiscard
 function persist(key, getter) end
 
+--- @see persist
+--- Persist a table by reference, no getter is called when saving. The table must never be reassigned.
+--- @generic T : table
+--- @param key string
+--- @param value T
+--- @return T
+--- @nodiscard
+function persist(key, value) end
+
 --- *Mod Scope*
 --- Import from lua
 --- You can also assess this value via `modConfig`.
@@ -0,0 +1,231 @@
+--[[
+-- @module TE.FFI
+-- @author JagYayu
+-- @brief Fast paths for hot engine APIs, calls C ABI through LuaJIT FFI when available, falls back to userdata methods otherwise.
+-- @version 1.0
+-- @date 2025
+--
+-- @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+--
+--]]
+
+local hasFFI, ffi = pcall(require, "ffi")
+local exports = rawget(_G, "FFIExports")
+
+--- @class TE.FFI
+local FFI = {}
+
+--- Whether functions in this module are backed by FFI calls.
+FFI.available = not not (hasFFI and ffi and exports)
+
+local colorWhite = 0xFFFFFFFF
+
+if FFI.available then
+	local ffi_cast = ffi.cast
+
+	local drawRect = ffi_cast("void(*)(void*, uint64_t, float, float, float, float, float, float, float, float, uint32_t)", exports.rendererDrawRect)
+	local drawRectNoSource = ffi_cast("void(*)(void*, uint64_t, float, float, float, float, uint32_t)", exports.rendererDrawRectNoSource)
+	local addRectangle = ffi_cast("void(*)(void*, uint64_t, float, float, float, float, float, float, float, float, uint32_t)", exports.renderBufferAddRectangle)
+	local noise2 = ffi_cast("float(*)(void*, float, float)", exports.perlinNoiseRandomNoise2)
+	local noise3 = ffi_cast("float(*)(void*, float, float, float)", exports.perlinNoiseRandomNoise3)
+	local float2 = ffi_cast("float(*)(void*, float, float, float, float)", exports.perlinNoiseRandomFloat2)
+	local int2 = ffi_cast("int32_t(*)(void*, float, float, int32_t, int32_t)", exports.perlinNoiseRandomInt2)
+	local int3 = ffi_cast("int32_t(*)(void*, float, float, float, int32_t, int32_t)", exports.perlinNoiseRandomInt3)
+
+	--- Resolve raw pointers only from genuine userdata, checked on C++ side against their usertype metatable.
+	--- Caches are per type and weak keyed, so that a handle never outlives its owner nor gets reused as another type.
+	--- @param resolve fun(userdata: userdata): lightuserdata
+	--- @return fun(userdata: userdata): ffi.cdata*
+	local function newHandleGetter(resolve)
+		--- @type table<userdata, ffi.cdata*>
+		local handles = setmetatable({}, { __mode = "k" })
+
+		return function(userdata)
+			local handle = handles[userdata]
+			if not handle then
+				handle = ffi_cast("void*", resolve(userdata))
+				handles[userdata] = handle
+			end
+			return handle
+		end
+	end
+
+	local getRendererHandle = newHandleGetter(exports.rendererHandle)
+	local getRenderBufferHandle = newHandleGetter(exports.renderBufferHandle)
+	local getNoiseRandomHandle = newHandleGetter(exports.perlinNoiseRandomHandle)
+
+	--- Same as `renderer:drawRect(args)`, without allocating nor touching a `DrawRectArgs`.
+	--- @param renderer TE.Renderer
+	--- @param imageID TE.ImageID?
+	--- @param dx number
+	--- @param dy number
+	--- @param dw number
+	--- @param dh number
+	--- @param sx number
+	--- @param sy number
+	--- @param sw number
+	--- @param sh number
+	--- @param color Color?
+	function FFI.drawRect(renderer, imageID, dx, dy, dw, dh, sx, sy, sw, sh, color)
+		drawRect(getRendererHandle(renderer), imageID or 0, dx, dy, dw, dh, sx, sy, sw, sh, color or colorWhite)
+	end
+
+	--- @param renderer TE.Renderer
+	--- @param imageID TE.ImageID?
+	--- @param dx number
+	--- @param dy number
+	--- @param dw number
+	--- @param dh number
+	--- @param color Color?
+	function FFI.drawRectNoSource(renderer, imageID, dx, dy, dw, dh, color)
+		drawRectNoSource(getRendererHandle(renderer), imageID or 0, dx, dy, dw, dh, color or colorWhite)
+	end
+
+	--- Same as `renderBuffer:addRectangle(args)`, `imageID` of `0` or `nil` appends an untextured rectangle.
+	--- @param renderBuffer TE.RenderBuffer
+	--- @param imageID TE.ImageID?
+	--- @param dx number
+	--- @param dy number
+	--- @param dw number
+	--- @param dh number
+	--- @param sx number
+	--- @param sy number
+	--- @param sw number
+	--- @param sh number
+	--- @param color Color?
+	function FFI.addRectangle(renderBuffer, imageID, dx, dy, dw, dh, sx, sy, sw, sh, color)
+		addRectangle(getRenderBufferHandle(renderBuffer), imageID or 0, dx, dy, dw, dh, sx, sy, sw, sh, color or colorWhite)
+	end
+
+	--- @param noiseRandom TE.NoiseRandom
+	--- @param x number
+	--- @param y number
+	--- @return number
+	function FFI.noise2(noiseRandom, x, y)
+		return noise2(getNoiseRandomHandle(noiseRandom), x, y)
+	end
+
+	--- @param noiseRandom TE.NoiseRandom
+	--- @param x number
+	--- @param y number
+	--- @param z number
+	--- @return number
+	function FFI.noise3(noiseRandom, x, y, z)
+		return noise3(getNoiseRandomHandle(noiseRandom), x, y, z)
+	end
+
+	--- @param noiseRandom TE.NoiseRandom
+	--- @param x number
+	--- @param y number
+	--- @param min number
+	--- @param max number
+	--- @return number
+	function FFI.float2(noiseRandom, x, y, min, max)
+		return float2(getNoiseRandomHandle(noiseRandom), x, y, min, max)
+	end
+
+	--- @param noiseRandom TE.NoiseRandom
+	--- @param x number
+	--- @param y number
+	--- @param min integer
+	--- @param max integer
+	--- @return integer
+	function FFI.int2(noiseRandom, x, y, min, max)
+		return int2(getNoiseRandomHandle(noiseRandom), x, y, min, max)
+	end
+
+	--- @param noiseRandom TE.NoiseRandom
+	--- @param x number
+	--- @param y number
+	--- @param z number
+	--- @param min integer
+	--- @param max integer
+	--- @return integer
+	function FFI.int3(noiseRandom, x, y, z, min, max)
+		return int3(getNoiseRandomHandle(noiseRandom), x, y, z, min, max)
+	end
+else
+	--- @type TE.DrawRectArgs?
+	local drawRectArgs
+
+	local function getDrawRectArgs()
+		if not drawRectArgs then
+			drawRectArgs = DrawRectArgs()
+		end
+		return drawRectArgs
+	end
+
+	local addRectangleArgs = {
+		destination = { 0, 0, 0, 0 },
+		source = { 0, 0, 0, 0 },
+	}
+
+	--- @param args TE.DrawRectArgs
+	local function setDrawRectDestination(args, dx, dy, dw, dh)
+		local dst = args.destination
+		dst.x = dx
+		dst.y = dy
+		dst.w = dw
+		dst.h = dh
+	end
+
+	function FFI.drawRect(renderer, imageID, dx, dy, dw, dh, sx, sy, sw, sh, color)
+		local args = getDrawRectArgs()
+		args.texture = imageID
+		setDrawRectDestination(args, dx, dy, dw, dh)
+
+		local src = args.source
+		if src then
+			src.x = sx
+			src.y = sy
+			src.w = sw
+			src.h = sh
+		else
+			args.source = { x = sx, y = sy, w = sw, h = sh }
+		end
+
+		args.color = color or colorWhite
+		renderer:drawRect(args)
+	end
+
+	function FFI.drawRectNoSource(renderer, imageID, dx, dy, dw, dh, color)
+		local args = getDrawRectArgs()
+		args.texture = imageID
+		setDrawRectDestination(args, dx, dy, dw, dh)
+		args.source = nil
+		args.color = color or colorWhite
+		renderer:drawRect(args)
+	end
+
+	function FFI.addRectangle(renderBuffer, imageID, dx, dy, dw, dh, sx, sy, sw, sh, color)
+		local dst = addRectangleArgs.destination
+		dst[1], dst[2], dst[3], dst[4] = dx, dy, dw, dh
+		local src = addRectangleArgs.source
+		src[1], src[2], src[3], src[4] = sx, sy, sw, sh
+		addRectangleArgs.texture = imageID
+		addRectangleArgs.color = color or colorWhite
+		renderBuffer:addRectangle(addRectangleArgs)
+	end
+
+	function FFI.noise2(noiseRandom, x, y)
+		return noiseRandom:noise2(x, y)
+	end
+
+	function FFI.noise3(noiseRandom, x, y, z)
+		return noiseRandom:noise3(x, y, z)
+	end
+
+	function FFI.float2(noiseRandom, x, y, min, max)
+		return noiseRandom:float2(x, y, min, max)
+	end
+
+	function FFI.int2(noiseRandom, x, y, min, max)
+		return noiseRandom:int2(x, y, min, max)
+	end
+
+	function FFI.int3(noiseRandom, x, y, z, min, max)
+		return noiseRandom:int3(x, y, z, min, max)
+	end
+end
+
+return FFI
@@ -21,7 +21,7 @@ namespace tudov
 		std::span<const std::byte> _bytes;
 
 	  public:
-		explicit Audio(std::string_view path, const std::vector<std::byte> &bytes) noexcept;
+		explicit Audio(std::string_view path, std::span<const std::byte> bytes) noexcept;
 		explicit Audio(const Audio &) noexcept = default;
 		explicit Audio(Audio &&) noexcept = default;
 		Audio &operator=(const Audio &) noexcept = default;
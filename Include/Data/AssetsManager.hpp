@@ -17,6 +17,8 @@
 #include "System/Log.hpp"
 #include "Util/Version.hpp"
 
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -41,6 +43,7 @@ namespace tudov
 	enum class EPathType : int;
 	class FileSystemWatch;
 	class GlobalStorage;
+	class ZipStorage;
 
 	class AssetsManager : public IAssetsManager, private ILogProvider
 	{
@@ -79,6 +82,11 @@ namespace tudov
 		void LoadAssetsFromDeveloperDirectory() noexcept;
 		void LoadAssetsFromExternalDirectories() noexcept;
 		void DeveloperDirectoryWatchCallback(const std::filesystem::path &filePath, EPathType pathType, EFileChangeType type);
-		std::vector<std::vector<std::byte>> CollectPackageFileBytes() noexcept;
+		std::vector<std::filesystem::path> CollectPackageFiles() noexcept;
+		/**
+		 * Map package file into memory, its contents are served as views of the mapping.
+		 * @throw std::runtime_error Failed to map file, or file is not a zip archive.
+		 */
+		std::shared_ptr<ZipStorage> OpenPackage(const std::filesystem::path &packageFile);
 	};
 } // namespace tudov
@@ -0,0 +1,79 @@
+/**
+ * @file Data/BlobStore.hpp
+ * @author JagYayu
+ * @brief Content addressed store of immutable byte blobs.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace tudov
+{
+	using BlobHash = std::uint64_t;
+
+	struct Blob
+	{
+		BlobHash hash;
+		std::vector<std::byte> bytes;
+	};
+
+	/**
+	 * Blobs are keyed by xxh3 of their contents, interning same bytes twice returns the same blob.
+	 * The store only keeps weak references, a blob is freed once nothing holds it.
+	 */
+	class BlobStore
+	{
+	  protected:
+		// Hash collisions are chained, contents are compared before sharing.
+		std::unordered_map<BlobHash, std::vector<std::weak_ptr<const Blob>>> _blobs;
+		std::size_t _collectThreshold;
+		std::size_t _sharedBytes;
+
+	  public:
+		explicit BlobStore() noexcept;
+		explicit BlobStore(const BlobStore &) noexcept = delete;
+		explicit BlobStore(BlobStore &&) noexcept = delete;
+		BlobStore &operator=(const BlobStore &) noexcept = delete;
+		BlobStore &operator=(BlobStore &&) noexcept = delete;
+		~BlobStore() noexcept = default;
+
+		static BlobHash Hash(std::span<const std::byte> bytes) noexcept;
+
+		std::shared_ptr<const Blob> Intern(std::vector<std::byte> &&bytes) noexcept;
+		std::shared_ptr<const Blob> Intern(std::span<const std::byte> bytes) noexcept;
+		/**
+		 * @return null if no alive blob has these contents.
+		 */
+		std::shared_ptr<const Blob> Find(BlobHash hash, std::span<const std::byte> bytes) noexcept;
+
+		/**
+		 * Drop expired references.
+		 */
+		void Collect() noexcept;
+
+		/**
+		 * @return Count of alive blobs.
+		 */
+		[[nodiscard]] std::size_t GetCount() const noexcept;
+		/**
+		 * @return Total bytes not stored thanks to sharing, since this store was created.
+		 */
+		[[nodiscard]] std::size_t GetSharedBytes() const noexcept;
+
+	  private:
+		// `chain` is set to the chain of `hash` even if not found.
+		std::shared_ptr<const Blob> Find(BlobHash hash, std::span<const std::byte> bytes, std::vector<std::weak_ptr<const Blob>> *&chain) noexcept;
+		std::shared_ptr<const Blob> Emplace(BlobHash hash, std::vector<std::byte> &&bytes, std::vector<std::weak_ptr<const Blob>> &chain) noexcept;
+	};
+} // namespace tudov
@@ -21,6 +21,7 @@ namespace tudov
 		TE_CONSTANT AppName = "DR2CT";
 		TE_CONSTANT AppOrganization = "Tudov";
 		TE_CONSTANT DataConfigFile = "Config.json";
+		TE_CONSTANT DataDecodedImagesDirectory = "Cache/Images";
 		TE_CONSTANT DataUserDirectoryPrefix = "user_";
 		TE_CONSTANT DataDeveloperAssetsDirectory = "Dev";
 		TE_CONSTANT DataVirtualStorageRootApp = "App";
@@ -16,6 +16,7 @@
 #include "System/Log.hpp"
 
 #include <cstdint>
+#include <span>
 
 struct SDL_Storage;
 
@@ -56,6 +57,18 @@ namespace tudov
 
 		std::vector<std::byte> ReadFileToBytes(const Path &filePath) override;
 
+		/**
+		 * Write a whole file, parent directories are created if needed.
+		 * @return false if storage is not writable or failed to write.
+		 */
+		virtual bool WriteFileFromBytes(const Path &filePath, std::span<const std::byte> bytes) noexcept;
+
+		/**
+		 * Remove a file or an empty directory.
+		 * @return false if storage is not writable or failed to remove.
+		 */
+		virtual bool RemovePath(const Path &path) noexcept;
+
 		virtual IGlobalStorageManager &GetGlobalStorageManager() noexcept = 0;
 
 		virtual constexpr EGlobalStorageLocation GetLocation() const noexcept = 0;
@@ -0,0 +1,50 @@
+/**
+ * @file Data/MappedFile.hpp
+ * @author JagYayu
+ * @brief Read only memory mapped file.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace tudov
+{
+	/**
+	 * Maps a whole file into memory once, pages are loaded by the operating system on first access, so only the parts
+	 * actually read count towards memory usage.
+	 */
+	class MappedFile
+	{
+	  protected:
+		const std::byte *_data;
+		std::size_t _size;
+		// Win32 handles, unused on other platforms.
+		void *_fileHandle;
+		void *_mappingHandle;
+
+	  public:
+		/**
+		 * @throw std::runtime_error Failed to open or map file.
+		 */
+		explicit MappedFile(const std::filesystem::path &path);
+		explicit MappedFile(const MappedFile &) noexcept = delete;
+		explicit MappedFile(MappedFile &&) noexcept;
+		MappedFile &operator=(const MappedFile &) noexcept = delete;
+		MappedFile &operator=(MappedFile &&) noexcept;
+		~MappedFile() noexcept;
+
+		[[nodiscard]] std::span<const std::byte> GetBytes() const noexcept;
+		[[nodiscard]] std::size_t GetSize() const noexcept;
+
+	  private:
+		void Close() noexcept;
+	};
+} // namespace tudov
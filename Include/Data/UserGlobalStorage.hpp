@@ -14,24 +14,60 @@
 #include "GlobalStorage.hpp"
 #include "Storage.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace tudov
 {
 	struct GlobalStorageManager;
 
+	/**
+	 * Writes are queued and done on a dedicated I/O thread, so saving never blocks caller. Queued writes of same file
+	 * are coalesced, and reads, path queries and enumeration see queued contents before they reach storage.
+	 * Small files are cached in memory once read or written.
+	 */
 	class UserGlobalStorage : public GlobalStorage
 	{
 	  protected:
+		using Bytes = std::shared_ptr<const std::vector<std::byte>>;
+
+		// Files no larger than this are cached.
+		static constexpr std::size_t CachedFileSizeLimit = 64 * 1024;
+		static constexpr std::size_t CachedTotalSizeLimit = 4 * 1024 * 1024;
+		// Writes requested within this delay after first queued one are done in same batch.
+		static constexpr std::chrono::milliseconds WriteBatchDelay{50};
+
 		std::string _username;
 
+		std::mutex _mutex;
+		std::condition_variable _writeCV;
+		std::condition_variable _flushCV;
+		std::thread _ioThread;
+		bool _stopping;
+		// Sorted by path, so a batch creates parent directories before files.
+		std::map<Path, Bytes> _queuedWrites;
+		// Batch being written by I/O thread, still visible to reads until done.
+		std::map<Path, Bytes> _writingWrites;
+		std::unordered_map<std::string, Bytes> _cache;
+		// Insertion order of cached files, oldest are evicted first.
+		std::deque<std::string> _cacheOrder;
+		std::size_t _cacheSize;
+
 	  public:
 		explicit UserGlobalStorage(GlobalStorageManager &globalStorageManager, std::string_view username) noexcept;
-				explicit UserGlobalStorage(const UserGlobalStorage &) noexcept = default;
-		explicit UserGlobalStorage(UserGlobalStorage &&) noexcept = default;
+		explicit UserGlobalStorage(const UserGlobalStorage &) noexcept = delete;
+		explicit UserGlobalStorage(UserGlobalStorage &&) noexcept = delete;
 		UserGlobalStorage &operator=(const UserGlobalStorage &) noexcept = delete;
 		UserGlobalStorage &operator=(UserGlobalStorage &&) noexcept = delete;
-		~UserGlobalStorage() noexcept override = default;
+		~UserGlobalStorage() noexcept override;
 
 		std::string_view GetUsername() noexcept;
 		IGlobalStorageManager &GetGlobalStorageManager() noexcept override;
@@ -40,6 +76,48 @@ namespace tudov
 		bool CanRead() noexcept override;
 		bool CanWrite() noexcept override;
 
+		EHierarchyIterationResult Foreach(const Path &path, const EnumerationCallbackFunction<> &callback, void *callbackArgs = nullptr) noexcept override;
+		EHierarchyElement Check(const Path &path) noexcept override;
+		PathInfo GetPathInfo(const Path &path) noexcept override;
+		std::uint64_t GetPathSize(const Path &filePath) noexcept override;
+		EPathType GetPathType(const Path &path) noexcept override;
+
+		std::vector<std::byte> ReadFileToBytes(const Path &filePath) override;
+
+		/**
+		 * Queue a whole file write, returns immediately. Failures are logged on I/O thread.
+		 * @return false if storage is not writable.
+		 */
+		bool WriteFileFromBytes(const Path &filePath, std::span<const std::byte> bytes) noexcept override;
+
+		/**
+		 * Queued writes of path, or of files under path if it is a directory, are dropped. Waits if they are being
+		 * written right now.
+		 */
+		bool RemovePath(const Path &path) noexcept override;
+
+		/**
+		 * Block until all queued writes reached storage.
+		 */
+		void Flush() noexcept;
+
 		constexpr EGlobalStorageLocation GetLocation() const noexcept override;
+
+	  private:
+		/**
+		 * Requires `_mutex` locked.
+		 */
+		Bytes FindQueued(const Path &filePath) const noexcept;
+		/**
+		 * Whether any queued write is under `directory`, so the directory exists once writes are done.
+		 * Requires `_mutex` locked.
+		 */
+		bool HasQueuedUnder(const Path &directory) const noexcept;
+		/**
+		 * Requires `_mutex` locked.
+		 */
+		void CacheFile(std::string key, Bytes bytes) noexcept;
+
+		void IOThreadMain() noexcept;
 	};
 } // namespace tudov
@@ -11,11 +11,13 @@
 
 #pragma once
 
+#include "BlobStore.hpp"
 #include "PathListOption.hpp"
 #include "Event/DelegateEvent.hpp"
 #include "Program/Context.hpp"
 #include "Resource/ResourceType.hpp"
 #include "System/Log.hpp"
+#include "Util/StringUtils.hpp"
 
 #include "sol/table.hpp"
 
@@ -23,9 +25,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -41,9 +48,13 @@ namespace tudov
 	  public:
 		using MountDirectoryEvent = DelegateEvent<const std::filesystem::path &>;
 		using DismountDirectoryEvent = MountDirectoryEvent;
-		using MountFileEvent = DelegateEvent<const std::filesystem::path &, const std::vector<std::byte> &, EResourceType &>;
+		using MountFileEvent = DelegateEvent<const std::filesystem::path &, std::span<const std::byte>, EResourceType &>;
 		using DismountFileEvent = MountDirectoryEvent;
-		using RemountFileEvent = DelegateEvent<const std::filesystem::path &, const std::vector<std::byte> &, const std::vector<std::byte> &, EResourceType &>;
+		using RemountFileEvent = DelegateEvent<const std::filesystem::path &, std::span<const std::byte>, std::span<const std::byte>, EResourceType &>;
+		/**
+		 * Reads file contents of a lazily mounted file, may throw.
+		 */
+		using FileLoader = std::function<std::vector<std::byte>()>;
 
 		struct ListEntry
 		{
@@ -78,10 +89,28 @@ namespace tudov
 
 		struct FileNode : public CommonNode
 		{
-			std::vector<std::byte> bytes;
+			// Contents owned by `owner`, a blob shared by files with same contents, or e.g. a memory mapped package.
+			std::span<const std::byte> borrowedBytes;
+			std::shared_ptr<const void> owner;
+			// Set if `owner` is a blob, lets consumers skip hashing contents again.
+			std::optional<BlobHash> blobHash;
+			// Fills contents on first access, set for lazily mounted files only.
+			FileLoader loader;
+			bool loaded;
+			// Size known before loading.
+			std::size_t size;
+			std::uint64_t lastAccess;
 			EResourceType resourceType;
 
-			explicit FileNode(const std::vector<std::byte> &bytes = {}, EResourceType resourceType = EResourceType::Unknown) noexcept;
+			explicit FileNode(std::span<const std::byte> borrowedBytes, std::shared_ptr<const void> owner, EResourceType resourceType = EResourceType::Unknown) noexcept;
+			explicit FileNode(std::shared_ptr<const Blob> blob) noexcept;
+			explicit FileNode(FileLoader loader, std::size_t size) noexcept;
+
+			/**
+			 * Empty if this file is lazy and not loaded yet.
+			 */
+			std::span<const std::byte> GetBytes() const noexcept;
+			std::size_t GetSize() const noexcept;
 		};
 
 	  protected:
@@ -92,11 +121,19 @@ namespace tudov
 		MountFileEvent _onMountFile;
 		DismountFileEvent _onDismountFile;
 		RemountFileEvent _onRemountFile;
+		std::uint64_t _accessCounter;
+		/**
+		 * Normalized path -> node of every mounted file and directory except root, so lookups never walk the tree.
+		 * Keys are path parts joined by '/', tree nodes are never moved so pointers stay valid until dismounted.
+		 */
+		std::unordered_map<std::string, Node *, StringSVHash, StringSVEqual> _pathIndex;
+		// Contents of files read by this file system, identical files share one blob.
+		BlobStore _blobStore;
 
 	  public:
 		explicit VirtualFileSystem(Context &context) noexcept;
-		explicit VirtualFileSystem(const VirtualFileSystem &) noexcept = default;
-		explicit VirtualFileSystem(VirtualFileSystem &&) noexcept = default;
+		explicit VirtualFileSystem(const VirtualFileSystem &) noexcept = delete;
+		explicit VirtualFileSystem(VirtualFileSystem &&) noexcept = delete;
 		VirtualFileSystem &operator=(const VirtualFileSystem &) noexcept = delete;
 		VirtualFileSystem &operator=(VirtualFileSystem &&) noexcept = delete;
 		~VirtualFileSystem() noexcept override = default;
@@ -109,10 +146,29 @@ namespace tudov
 		MountFileEvent &GetOnMountFile() noexcept;
 		DismountFileEvent &GetOnDismountFile() noexcept;
 		RemountFileEvent &GetOnRemountFile() noexcept;
+		BlobStore &GetBlobStore() noexcept;
 
 		void MountDirectory(const std::filesystem::path &path) noexcept;
+		/**
+		 * Mounting a file at a path that already has one replaces it, so later mounts take precedence. Files are never
+		 * mounted over directories.
+		 */
 		void MountFile(const std::filesystem::path &path) noexcept;
 		void MountFile(const std::filesystem::path &path, std::span<const std::byte> bytes) noexcept;
+		/**
+		 * Contents are interned without copying.
+		 */
+		void MountFile(const std::filesystem::path &path, std::vector<std::byte> &&bytes) noexcept;
+		/**
+		 * Mount without copying, `bytes` must stay valid as long as `owner` is alive, the node keeps `owner` alive.
+		 */
+		void MountFileView(const std::filesystem::path &path, std::span<const std::byte> bytes, std::shared_ptr<const void> owner) noexcept;
+		/**
+		 * Mount without reading, `loader` is called on first `GetFileBytes` or `Load`. Mount event of this file is
+		 * deferred until then, so its resources are not created before being used.
+		 * @param size Expected size, used by size queries before loading.
+		 */
+		void MountFileLazy(const std::filesystem::path &path, FileLoader loader, std::size_t size = 0) noexcept;
 		bool DismountDirectory(const std::filesystem::path &path) noexcept;
 		bool DismountFile(const std::filesystem::path &path) noexcept;
 		bool RemountFile(const std::filesystem::path &path, const std::vector<std::byte> &bytes) noexcept;
@@ -120,18 +176,72 @@ namespace tudov
 		bool Exists(const std::filesystem::path &path) noexcept;
 		EPathType GetPathType(const std::filesystem::path &path) noexcept;
 		std::chrono::time_point<std::chrono::system_clock> GetPathDateModified(const std::filesystem::path &path);
-		std::span<std::byte> GetFileBytes(const std::filesystem::path &file);
+		std::span<const std::byte> GetFileBytes(const std::filesystem::path &file);
 		EResourceType GetFileResourceType(const std::filesystem::path &file);
+		/**
+		 * @return Hash of file contents if they are a blob of `GetBlobStore`, nullopt for views and unloaded files.
+		 */
+		std::optional<BlobHash> GetFileBlobHash(const std::filesystem::path &file) noexcept;
 		std::size_t GetPathSize(const std::filesystem::path &file) const;
 
+		/**
+		 * Load a lazily mounted file now, does nothing to other files.
+		 * @return false if file not found or loader failed.
+		 */
+		bool Load(const std::filesystem::path &file) noexcept;
+		/**
+		 * Same as `Load`, but does not allocate if `file` is a plain relative path that is missing or loaded already.
+		 */
+		bool LoadIndexed(std::string_view file) noexcept;
+		/**
+		 * Release contents of a loaded lazy file, it is dismounted from resources and loaded again on next access.
+		 * Views of its contents must not be used after this.
+		 */
+		bool Evict(const std::filesystem::path &file) noexcept;
+		/**
+		 * Evict least recently accessed lazy files until loaded lazy contents fit in `keepBytes`.
+		 * @return Count of bytes released.
+		 */
+		std::size_t EvictCold(std::size_t keepBytes) noexcept;
+		/**
+		 * @return Bytes of loaded lazy files.
+		 */
+		[[nodiscard]] std::size_t GetLazyLoadedSize() const noexcept;
+
 		std::vector<ListEntry> List(const std::filesystem::path &directory, EPathListOption options = EPathListOption::Default) const;
 
 	  protected:
 		Node *FindNode(const std::filesystem::path &path) noexcept;
+		/**
+		 * Does not allocate if `path` is a plain relative path like "App/GFX/Image.png".
+		 */
+		Node *FindIndexedNode(std::string_view path) noexcept;
+		/**
+		 * @param key Normalized key, see `ToIndexKey`.
+		 */
+		Node *FindKeyedNode(std::string_view key) noexcept;
+		std::span<const std::byte> GetIndexedFileBytes(std::string_view file);
+		void UnindexNode(std::string_view key, const Node &node) noexcept;
+		void EmplaceFileNode(const std::filesystem::path &path, FileNode &&fileNode) noexcept;
+		bool LoadFileNode(const std::filesystem::path &path, FileNode &fileNode) noexcept;
+		void EvictFileNode(const std::filesystem::path &path, FileNode &fileNode) noexcept;
+		void ForeachLoadedLazyFileNode(const std::filesystem::path &directory, DirectoryNode &directoryNode, const std::function<void(const std::filesystem::path &, FileNode &)> &func) noexcept;
 		void CollectListEntries(std::vector<ListEntry> &entries, const std::filesystem::path &directory, const DirectoryNode *directoryNode, EPathListOption options, std::uint32_t depth) const noexcept;
 		void ClearParentDirectoriesCache(const std::filesystem::path &path) const;
 
 	  private:
+		static void AppendIndexKey(std::string &key, std::string_view part) noexcept;
+		static std::string ToIndexKey(const std::filesystem::path &path) noexcept;
+		/**
+		 * @return Key in `buffer`, `buffer` keeps its capacity between calls.
+		 */
+		static std::string_view ToIndexKey(const std::filesystem::path &path, std::string &buffer) noexcept;
+		/**
+		 * @return `path` itself if it is a key already, otherwise key normalized into `buffer`.
+		 */
+		static std::string_view ToIndexKey(std::string_view path, std::string &buffer) noexcept;
+		static std::string GetLastPart(const std::filesystem::path &path) noexcept;
+
 		bool LuaExists(sol::object path);
 		sol::table LuaList(sol::object directory, sol::object options);
 		std::string LuaReadFile(sol::object file);
@@ -1,5 +1,5 @@
 /**
- * @file data/ZipStorage.hpp
+ * @file Data/ZipStorage.hpp
  * @author JagYayu
  * @brief
  * @version 1.0
@@ -13,27 +13,71 @@
 
 #include "HierarchyElement.hpp"
 #include "Storage.hpp"
+#include "Util/StringUtils.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <span>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace tudov
 {
 	enum class EPathType;
+	class MappedFile;
 
+	/**
+	 * Read only zip archive in memory, either a copy of given bytes or a shared memory mapped file.
+	 */
 	class ZipStorage : public IStorage
 	{
+	  public:
+		struct MemoryBuffer;
+
+		/**
+		 * Central directory record, parsed once when opened.
+		 */
+		struct Entry
+		{
+			std::string name;
+			// Position of record in central directory, jumping there skips scanning.
+			std::uint64_t directoryPosition;
+			std::uint64_t fileNumber;
+			std::uint64_t compressedSize;
+			std::uint64_t uncompressedSize;
+			// Stored without compression and unencrypted.
+			bool stored;
+		};
+
 	  protected:
-		std::vector<std::byte> _bytes;
+		// Keeps the archive mapped while views are in use, null if constructed from bytes.
+		std::shared_ptr<const MappedFile> _mappedFile;
+		std::vector<std::byte> _ownedBytes;
+		std::span<const std::byte> _bytes;
+		// Read position of minizip, per instance so several archives can be open at once.
+		std::unique_ptr<MemoryBuffer> _memoryBuffer;
 		void *_unzip;
+		// In archive order.
+		std::vector<Entry> _entries;
+		std::unordered_map<std::string, std::size_t, StringSVHash, StringSVEqual> _entryIndices;
+		// Contents of compressed entries, decompressed on first view.
+		std::unordered_map<std::string, std::vector<std::byte>> _decompressed;
 
 	  public:
-		explicit ZipStorage(std::span<std::byte> data);
-		explicit ZipStorage(const ZipStorage &) noexcept = default;
-		explicit ZipStorage(ZipStorage &&) noexcept = default;
-		ZipStorage &operator=(const ZipStorage &) noexcept = default;
-		ZipStorage &operator=(ZipStorage &&) noexcept = default;
+		/**
+		 * @throw std::runtime_error Data is not a zip archive.
+		 */
+		explicit ZipStorage(std::span<const std::byte> data);
+		/**
+		 * @throw std::runtime_error Mapped file is not a zip archive.
+		 */
+		explicit ZipStorage(std::shared_ptr<const MappedFile> mappedFile);
+		explicit ZipStorage(const ZipStorage &) noexcept = delete;
+		explicit ZipStorage(ZipStorage &&) noexcept = delete;
+		ZipStorage &operator=(const ZipStorage &) noexcept = delete;
+		ZipStorage &operator=(ZipStorage &&) noexcept = delete;
 		~ZipStorage() noexcept override;
 
 		virtual bool CanRead() noexcept override;
@@ -55,6 +99,24 @@ namespace tudov
 		virtual std::vector<std::byte> ReadFileToBytes(const std::filesystem::path &filePath) override;
 		// virtual std::string ReadFileToString(const std::filesystem::path& filePath) override;
 
+		/**
+		 * View of file contents without copying. Stored entries point into archive memory directly, compressed entries
+		 * are decompressed once and kept by this storage. Views stay valid as long as this storage is alive.
+		 * @throw std::runtime_error File not found or failed to decompress.
+		 */
+		std::span<const std::byte> ReadFileView(const std::filesystem::path &filePath);
+		/**
+		 * @return true if file is stored without compression, so its view costs nothing.
+		 */
+		bool IsStored(const std::filesystem::path &filePath) noexcept;
+
+		const Entry *FindEntry(const std::filesystem::path &filePath) const noexcept;
+
+	  private:
+		void Open();
+		void BuildIndex();
+		std::vector<std::byte> ReadEntry(void *unzip, const Entry &entry) const;
+
 		// virtual std::uint64_t GetFileCompressedSize(const std::filesystem::path& filePath) noexcept;
 	};
 } // namespace tudov
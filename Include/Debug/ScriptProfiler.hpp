@@ -0,0 +1,126 @@
+/**
+ * @file debug/ScriptProfiler.hpp
+ * @author JagYayu
+ * @brief Sampling profiler of lua scripts, built on `jit.profile`.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "Program/Context.hpp"
+#include "System/Log.hpp"
+#include "Util/StringUtils.hpp"
+
+#include "sol/forward.hpp"
+#include "sol/function.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	enum class EScriptProfileFormat : std::uint8_t
+	{
+		/**
+		 * One line per unique stack: "event;handler;frame;frame count", consumed by flamegraph.pl, speedscope, etc.
+		 */
+		Collapsed,
+		/**
+		 * Chrome trace event JSON, consecutive samples sharing the same frames are merged into complete events.
+		 */
+		ChromeTrace,
+	};
+
+	/**
+	 * Samples are taken by `jit.profile` and attributed to the event and handler which is being invoked at that moment,
+	 * stacks are aggregated here instead of in lua, so profiling itself barely creates garbage.
+	 */
+	class ScriptProfiler : public IContextProvider, private ILogProvider
+	{
+		friend LuaBindings;
+
+	  public:
+		static constexpr std::uint32_t DefaultIntervalMS = 1;
+		static constexpr std::uint32_t DefaultStackDepth = 32;
+		/**
+		 * Maximum samples kept in timeline for chrome trace export, aggregated counts are not limited.
+		 */
+		static constexpr std::size_t TimelineLimit = 1 << 20;
+
+		struct Sample
+		{
+			std::uint64_t timeNS;
+			std::uint32_t stackIndex;
+			std::uint32_t count;
+		};
+
+	  private:
+		Context &_context;
+		std::shared_ptr<Log> _log;
+
+		bool _running;
+		std::uint32_t _intervalMS;
+		std::uint32_t _stackDepth;
+		std::uint64_t _beginNS;
+		std::uint64_t _totalSamples;
+
+		std::string_view _event;
+		std::string_view _handler;
+
+		std::string _key;
+		std::unordered_map<std::string, std::uint32_t, StringSVHash, StringSVEqual> _stackIndices;
+		std::vector<const std::string *> _stacks;
+		std::vector<std::uint64_t> _stackSamples;
+		std::vector<Sample> _timeline;
+
+		sol::protected_function _dumpstack;
+
+	  public:
+		explicit ScriptProfiler(Context &context) noexcept;
+		explicit ScriptProfiler(const ScriptProfiler &) noexcept = delete;
+		explicit ScriptProfiler(ScriptProfiler &&) noexcept = delete;
+		ScriptProfiler &operator=(const ScriptProfiler &) noexcept = delete;
+		ScriptProfiler &operator=(ScriptProfiler &&) noexcept = delete;
+		~ScriptProfiler() noexcept = default;
+
+		Context &GetContext() noexcept override;
+		Log &GetLog() noexcept override;
+
+		bool IsRunning() const noexcept;
+		std::uint64_t GetTotalSamples() const noexcept;
+
+		bool Start(std::uint32_t intervalMS = DefaultIntervalMS, std::uint32_t stackDepth = DefaultStackDepth) noexcept;
+		void Stop() noexcept;
+		void Clear() noexcept;
+
+		/**
+		 * Set the event and handler that following samples belong to, returns the previous ones to restore.
+		 */
+		std::tuple<std::string_view, std::string_view> Attribute(std::string_view event, std::string_view handler) noexcept;
+
+		void AddSample(std::string_view stack, std::uint32_t count, char vmstate) noexcept;
+
+		std::string ExportCollapsed() const noexcept;
+		std::string ExportChromeTrace() const noexcept;
+
+		/**
+		 * Write to user storage.
+		 */
+		bool Export(const std::filesystem::path &filePath, EScriptProfileFormat format) noexcept;
+
+	  private:
+		bool LuaStart(sol::object intervalMS, sol::object stackDepth) noexcept;
+		bool LuaExport(sol::object filePath, sol::object format) noexcept;
+	};
+} // namespace tudov
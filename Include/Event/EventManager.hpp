@@ -30,6 +30,7 @@ namespace tudov
 	class Engine;
 	class LoadtimeEvent;
 	class RuntimeEvent;
+	class ScriptProfiler;
 	struct ICoreEvents;
 
 	struct IEventManager : public IEngineComponent
@@ -40,6 +41,8 @@ namespace tudov
 
 		[[nodiscard]] virtual ICoreEvents &GetCoreEvents() noexcept = 0;
 
+		[[nodiscard]] virtual ScriptProfiler &GetScriptProfiler() noexcept = 0;
+
 		[[nodiscard]] virtual ScriptID GetEventIDByName(std::string_view scriptName) const noexcept = 0;
 
 		[[nodiscard]] virtual std::optional<std::string_view> GetEventNameByID(EventID eventID) const noexcept = 0;
@@ -76,6 +79,7 @@ namespace tudov
 		Context &_context;
 		std::shared_ptr<Log> _log;
 		std::unique_ptr<CoreEvents> _coreEvents;
+		std::unique_ptr<ScriptProfiler> _scriptProfiler;
 
 		EventID _latestEventID;
 		RuntimeEvent *_invokingEvent;
@@ -109,6 +113,7 @@ namespace tudov
 
 		[[nodiscard]] RuntimeEvent *GetInvokingEvent() noexcept override;
 		[[nodiscard]] ICoreEvents &GetCoreEvents() noexcept override;
+		[[nodiscard]] ScriptProfiler &GetScriptProfiler() noexcept override;
 		void InstallToScriptEngine(IScriptEngine &scriptEngine);
 		void UninstallFromScriptEngine(IScriptEngine &scriptEngine);
 
@@ -24,10 +24,16 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
+namespace tudov
+{
+	class ScriptProfiler;
+}
+
 namespace tudov::impl
 {
 	// An internal object
@@ -35,6 +41,9 @@ namespace tudov::impl
 	{
 		RuntimeEvent *event;
 		ScriptID &invokingScriptID;
+		// Not null only if sampling profiler is running.
+		ScriptProfiler *scriptProfiler;
+		std::string_view eventName;
 	};
 
 } // namespace tudov::impl
@@ -0,0 +1,156 @@
+/**
+ * @file Gameplay/EntityRegistry.hpp
+ * @author JagYayu
+ * @brief Archetype based entity storage.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	/**
+	 * Entities are grouped by entity type (archetype), every archetype stores its entities and per-entity components in
+	 * dense columns, a column per component type.
+	 *
+	 * Entity ids are generational: low 32 bits are slot index + 1, higher bits are slot generation, so a stale id never
+	 * resolves to a recycled slot. Ids stay below 2^53 and can be used as lua numbers directly.
+	 * Slots are recycled in LIFO order, so the same sequence of operations always produces the same ids.
+	 */
+	class EntityRegistry
+	{
+		friend LuaBindings;
+
+	  public:
+		using EntityID = std::uint64_t;
+		using EntityTypeID = std::uint32_t;
+		using ComponentTypeID = std::uint32_t;
+
+		static constexpr std::uint32_t GenerationBits = 20;
+		static constexpr std::uint32_t GenerationMask = (1u << GenerationBits) - 1;
+		static constexpr std::uint32_t InvalidColumn = UINT32_MAX;
+
+	  protected:
+		struct Slot
+		{
+			std::uint32_t generation;
+			EntityTypeID typeID;
+			std::uint32_t row;
+			// Handed out by `Reserve` and not committed yet.
+			bool reserved;
+		};
+
+		struct Archetype
+		{
+			std::vector<ComponentTypeID> componentTypeIDs;
+			// Component type id -> column index, `InvalidColumn` if this archetype has no such component.
+			std::vector<std::uint32_t> columnIndices;
+			std::vector<EntityID> entities;
+			std::vector<std::vector<sol::object>> columns;
+		};
+
+	  protected:
+		std::vector<Slot> _slots;
+		std::vector<std::uint32_t> _freeSlots;
+		// Indexed by entity type id, index 0 is unused.
+		std::vector<Archetype> _archetypes;
+		std::size_t _count;
+
+	  public:
+		explicit EntityRegistry() noexcept;
+		explicit EntityRegistry(const EntityRegistry &) noexcept = delete;
+		explicit EntityRegistry(EntityRegistry &&) noexcept = default;
+		EntityRegistry &operator=(const EntityRegistry &) noexcept = delete;
+		EntityRegistry &operator=(EntityRegistry &&) noexcept = default;
+		~EntityRegistry() noexcept = default;
+
+		static constexpr std::uint32_t GetSlotIndex(EntityID entityID) noexcept
+		{
+			return static_cast<std::uint32_t>(entityID & 0xFFFFFFFFull) - 1;
+		}
+
+		static constexpr std::uint32_t GetGeneration(EntityID entityID) noexcept
+		{
+			return static_cast<std::uint32_t>(entityID >> 32) & GenerationMask;
+		}
+
+		static constexpr EntityID MakeEntityID(std::uint32_t slotIndex, std::uint32_t generation) noexcept
+		{
+			return (static_cast<EntityID>(generation & GenerationMask) << 32) | (static_cast<EntityID>(slotIndex) + 1);
+		}
+
+		/**
+		 * Define per-entity component columns of an entity type, existing entities of this type keep components that
+		 * still exist in the new layout.
+		 */
+		void RegisterArchetype(EntityTypeID typeID, const std::vector<ComponentTypeID> &componentTypeIDs);
+
+		[[nodiscard]] bool HasArchetype(EntityTypeID typeID) const noexcept;
+
+		EntityID Spawn(EntityTypeID typeID);
+		/**
+		 * Allocate an entity id without spawning it, the entity does not exist until `Commit` is called.
+		 * Used by deferred spawning, ids are handed out immediately while entities are added on next update.
+		 */
+		EntityID Reserve() noexcept;
+		/**
+		 * @return false if the id was not reserved by this registry, e.g. the registry was cleared or deserialized
+		 * since `Reserve`.
+		 */
+		bool Commit(EntityID entityID, EntityTypeID typeID);
+		bool Despawn(EntityID entityID) noexcept;
+
+		[[nodiscard]] bool Exists(EntityID entityID) const noexcept;
+		[[nodiscard]] std::optional<EntityTypeID> GetTypeID(EntityID entityID) const noexcept;
+
+		[[nodiscard]] sol::object GetComponent(EntityID entityID, ComponentTypeID componentTypeID) const noexcept;
+		/**
+		 * @return nullptr if entity does not exist or has no such component column.
+		 */
+		[[nodiscard]] const sol::object *FindComponent(EntityID entityID, ComponentTypeID componentTypeID) const noexcept;
+		bool SetComponent(EntityID entityID, ComponentTypeID componentTypeID, sol::object value) noexcept;
+
+		[[nodiscard]] std::size_t Count() const noexcept;
+		[[nodiscard]] std::size_t CountByType(EntityTypeID typeID) const noexcept;
+		[[nodiscard]] EntityTypeID GetMaxTypeID() const noexcept;
+		/**
+		 * @param index 0 based row index.
+		 * @return 0 if out of range.
+		 */
+		[[nodiscard]] EntityID GetEntityAt(EntityTypeID typeID, std::size_t index) const noexcept;
+
+		void Clear() noexcept;
+
+	  private:
+		std::uint32_t AllocateSlot() noexcept;
+		void Emplace(std::uint32_t slotIndex, EntityTypeID typeID) noexcept;
+		Slot *FindSlot(EntityID entityID) noexcept;
+		const Slot *FindSlot(EntityID entityID) const noexcept;
+
+		void LuaRegisterArchetype(EntityTypeID typeID, sol::table componentTypeIDs);
+		std::optional<EntityTypeID> LuaGetTypeID(EntityID entityID) const noexcept;
+		std::optional<EntityID> LuaGetEntityAt(EntityTypeID typeID, std::size_t index) const noexcept;
+
+		// Raw lua C functions, values are pushed from their registry references directly instead of through a temporary
+		// `sol::object`, which would take and release another reference per call.
+		static int LuaGetComponent(lua_State *L);
+		static int LuaFillEntities(lua_State *L);
+		static EntityRegistry &LuaCheckSelf(lua_State *L);
+		sol::table LuaSerialize(sol::table serializableComponents, sol::this_state ts) const;
+		void LuaDeserialize(sol::table data);
+	};
+} // namespace tudov
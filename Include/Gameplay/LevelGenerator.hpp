@@ -0,0 +1,137 @@
+/**
+ * @file Gameplay/LevelGenerator.hpp
+ * @author JagYayu
+ * @brief Seed deterministic level generation, runs on a background thread.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	/**
+	 * Generates tile type grids in passes: fill with walls, place rooms, connect rooms with corridors, vary floors with
+	 * a noise field, then remove walls not touching any floor.
+	 *
+	 * Every pass only uses integer math and a fixed pseudo random sequence derived from seed, so all peers generate
+	 * identical levels from identical parameters regardless of platform or compiler.
+	 */
+	class LevelGenerator
+	{
+		friend LuaBindings;
+
+	  public:
+		using TypeID = std::uint16_t;
+
+		struct Params
+		{
+			std::uint64_t seed;
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t width;
+			std::int32_t height;
+			std::int32_t roomAttempts;
+			std::int32_t roomMinSize;
+			std::int32_t roomMaxSize;
+			// Lattice size of noise field in tiles, it is sampled in world coordinates so adjacent segments connect.
+			std::int32_t noiseScale;
+			// Floors with noise value above threshold use `altFloorType`, in range [0, 255].
+			std::int32_t noiseThreshold;
+			TypeID emptyType;
+			TypeID floorType;
+			TypeID wallType;
+			TypeID altFloorType;
+		};
+
+		struct Room
+		{
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t width;
+			std::int32_t height;
+		};
+
+		struct Level
+		{
+			std::uint64_t requestID;
+			Params params;
+			// Row major, relative to `params.x` and `params.y`.
+			std::vector<TypeID> types;
+			std::vector<Room> rooms;
+		};
+
+	  protected:
+		struct Job
+		{
+			std::uint64_t requestID;
+			Params params;
+		};
+
+	  protected:
+		std::uint64_t _latestRequestID;
+
+		std::thread _thread;
+		std::atomic<bool> _stopping;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		std::deque<Job> _jobs;
+		std::deque<Level> _completed;
+		std::size_t _pending;
+
+	  public:
+		explicit LevelGenerator() noexcept;
+		explicit LevelGenerator(const LevelGenerator &) noexcept = delete;
+		explicit LevelGenerator(LevelGenerator &&) noexcept = delete;
+		LevelGenerator &operator=(const LevelGenerator &) noexcept = delete;
+		LevelGenerator &operator=(LevelGenerator &&) noexcept = delete;
+		~LevelGenerator() noexcept;
+
+		/**
+		 * Generate on calling thread.
+		 */
+		static Level Generate(const Params &params) noexcept;
+
+		/**
+		 * Generate on background thread.
+		 * @return Request id, also stored in the generated level.
+		 */
+		std::uint64_t Request(const Params &params) noexcept;
+		/**
+		 * Pop one generated level, levels are popped in request order.
+		 */
+		std::optional<Level> Poll() noexcept;
+		/**
+		 * @return Count of requests not popped yet.
+		 */
+		[[nodiscard]] std::size_t GetPendingCount() noexcept;
+
+	  private:
+		void WorkerMain() noexcept;
+
+		static Params LuaToParams(sol::table params) noexcept;
+		static sol::table LuaFromLevel(const Level &level, sol::this_state ts) noexcept;
+
+		sol::table LuaGenerate(sol::table params, sol::this_state ts) noexcept;
+		std::uint64_t LuaRequest(sol::table params) noexcept;
+		sol::object LuaPoll(sol::this_state ts) noexcept;
+	};
+} // namespace tudov
@@ -1,7 +1,7 @@
 /**
- * @file program/Window.cpp
+ * @file Gameplay/ObjectManager.hpp
  * @author JagYayu
- * @brief
+ * @brief Pooled storage of plain native objects.
  * @version 1.0
  * @date 2025
  *
@@ -11,52 +11,429 @@
 
 #pragma once
 
-#include <exception>
-#include <sstream>
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/state_view.hpp"
+#include "sol/table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace tudov
 {
 	class LuaBindings;
 
-	using ObjectID = std::uint32_t;
+	/**
+	 * Generational object id: low 32 bits are slot index + 1, higher bits are slot generation, 0 is never a valid id.
+	 * Ids stay below 2^53 and can be used as lua numbers directly.
+	 */
+	using ObjectID = std::uint64_t;
 
+	/**
+	 * Slot map over a dense array of objects. Objects are stored contiguously in `_objects`, a slot maps an id to its
+	 * dense index, despawning moves the last object into the hole.
+	 *
+	 * Iteration follows dense order, it is stable as long as nothing is despawned, spawning only appends.
+	 * Slots are recycled in LIFO order, so the same sequence of operations always produces the same ids.
+	 */
 	template <typename TObject>
 	class ObjectManager
 	{
 		friend LuaBindings;
 
 	  public:
-		void Spawn()
+		static constexpr std::uint32_t GenerationBits = 20;
+		static constexpr std::uint32_t GenerationMask = (1u << GenerationBits) - 1;
+		static constexpr std::uint32_t InvalidIndex = UINT32_MAX;
+
+		static constexpr std::uint32_t SerialMagic = 0x4A424F54; // "TOBJ"
+		static constexpr std::uint32_t SerialVersion = 1;
+
+	  protected:
+		struct Slot
+		{
+			std::uint32_t generation;
+			// Dense index, `InvalidIndex` if slot is free.
+			std::uint32_t index;
+		};
+
+		struct SerialHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t objectSize;
+			std::uint32_t slotCount;
+			std::uint32_t freeSlotCount;
+			std::uint32_t objectCount;
+		};
+
+	  protected:
+		std::vector<TObject> _objects;
+		// Parallel to `_objects`.
+		std::vector<ObjectID> _objectIDs;
+		std::vector<Slot> _slots;
+		std::vector<std::uint32_t> _freeSlots;
+
+	  public:
+		explicit ObjectManager() noexcept = default;
+		explicit ObjectManager(const ObjectManager &) noexcept = delete;
+		explicit ObjectManager(ObjectManager &&) noexcept = default;
+		ObjectManager &operator=(const ObjectManager &) noexcept = delete;
+		ObjectManager &operator=(ObjectManager &&) noexcept = default;
+		~ObjectManager() noexcept = default;
+
+		static constexpr std::uint32_t GetSlotIndex(ObjectID objectID) noexcept
+		{
+			return static_cast<std::uint32_t>(objectID & 0xFFFFFFFFull) - 1;
+		}
+
+		static constexpr std::uint32_t GetGeneration(ObjectID objectID) noexcept
+		{
+			return static_cast<std::uint32_t>(objectID >> 32) & GenerationMask;
+		}
+
+		static constexpr ObjectID MakeObjectID(std::uint32_t slotIndex, std::uint32_t generation) noexcept
+		{
+			return (static_cast<ObjectID>(generation & GenerationMask) << 32) | (static_cast<ObjectID>(slotIndex) + 1);
+		}
+
+		void Reserve(std::size_t capacity)
+		{
+			_objects.reserve(capacity);
+			_objectIDs.reserve(capacity);
+			_slots.reserve(capacity);
+		}
+
+		template <typename... TArgs>
+		ObjectID Spawn(TArgs &&...args)
+		{
+			std::uint32_t slotIndex;
+			if (!_freeSlots.empty())
+			{
+				slotIndex = _freeSlots.back();
+				_freeSlots.pop_back();
+			}
+			else
+			{
+				slotIndex = static_cast<std::uint32_t>(_slots.size());
+				_slots.emplace_back(Slot{
+				    .generation = 0,
+				    .index = InvalidIndex,
+				});
+			}
+
+			Slot &slot = _slots[slotIndex];
+			ObjectID objectID = MakeObjectID(slotIndex, slot.generation);
+			slot.index = static_cast<std::uint32_t>(_objects.size());
+
+			_objects.emplace_back(std::forward<TArgs>(args)...);
+			_objectIDs.emplace_back(objectID);
+			return objectID;
+		}
+
+		bool Despawn(ObjectID objectID) noexcept
 		{
-			//
+			Slot *slot = FindSlot(objectID);
+			if (slot == nullptr)
+			{
+				return false;
+			}
+
+			std::uint32_t index = slot->index;
+			std::uint32_t last = static_cast<std::uint32_t>(_objects.size() - 1);
+			if (index != last)
+			{
+				_objects[index] = std::move(_objects[last]);
+				_objectIDs[index] = _objectIDs[last];
+				_slots[GetSlotIndex(_objectIDs[index])].index = index;
+			}
+			_objects.pop_back();
+			_objectIDs.pop_back();
+
+			slot->generation = (slot->generation + 1) & GenerationMask;
+			slot->index = InvalidIndex;
+			_freeSlots.emplace_back(GetSlotIndex(objectID));
+			return true;
+		}
+
+		[[nodiscard]] bool Exists(ObjectID objectID) const noexcept
+		{
+			return FindSlot(objectID) != nullptr;
+		}
+
+		/**
+		 * @return Pointer into dense storage, invalidated by spawning or despawning.
+		 */
+		[[nodiscard]] TObject *Get(ObjectID objectID) noexcept
+		{
+			Slot *slot = FindSlot(objectID);
+			return slot != nullptr ? &_objects[slot->index] : nullptr;
 		}
 
-		ObjectID Despawn()
+		[[nodiscard]] const TObject *Get(ObjectID objectID) const noexcept
 		{
-			//
+			const Slot *slot = FindSlot(objectID);
+			return slot != nullptr ? &_objects[slot->index] : nullptr;
 		}
 
-		std::stringbuf Serialize()
+		[[nodiscard]] std::size_t Count() const noexcept
 		{
-			//
+			return _objects.size();
 		}
 
-		void Deserialize()
+		/**
+		 * @param index 0 based dense index.
+		 * @return 0 if out of range.
+		 */
+		[[nodiscard]] ObjectID GetObjectIDAt(std::size_t index) const noexcept
 		{
-			//
+			return index < _objectIDs.size() ? _objectIDs[index] : 0;
+		}
+
+		[[nodiscard]] std::span<TObject> GetObjects() noexcept
+		{
+			return _objects;
+		}
+
+		[[nodiscard]] std::span<const TObject> GetObjects() const noexcept
+		{
+			return _objects;
+		}
+
+		[[nodiscard]] std::span<const ObjectID> GetObjectIDs() const noexcept
+		{
+			return _objectIDs;
+		}
+
+		/**
+		 * @param func `void(ObjectID, TObject &)`, must not spawn or despawn.
+		 */
+		template <typename TFunc>
+		void ForEach(TFunc &&func)
+		{
+			for (std::size_t index = 0; index < _objects.size(); ++index)
+			{
+				func(_objectIDs[index], _objects[index]);
+			}
+		}
+
+		void Clear() noexcept
+		{
+			_objects.clear();
+			_objectIDs.clear();
+			_slots.clear();
+			_freeSlots.clear();
+		}
+
+		/**
+		 * Write slots, free list and objects as raw memory. Slot generations are kept, so ids held by other systems stay
+		 * valid after deserializing. Layout depends on `TObject` and platform endianness, for local snapshots only.
+		 */
+		void Serialize(std::vector<std::byte> &bytes) const
+		{
+			static_assert(std::is_trivially_copyable_v<TObject>, "Serialized objects must be trivially copyable");
+
+			SerialHeader header{
+			    .magic = SerialMagic,
+			    .version = SerialVersion,
+			    .objectSize = static_cast<std::uint32_t>(sizeof(TObject)),
+			    .slotCount = static_cast<std::uint32_t>(_slots.size()),
+			    .freeSlotCount = static_cast<std::uint32_t>(_freeSlots.size()),
+			    .objectCount = static_cast<std::uint32_t>(_objects.size()),
+			};
+
+			bytes.clear();
+			bytes.reserve(GetSerialSize(header));
+			Append(bytes, &header, sizeof(SerialHeader));
+			Append(bytes, _slots.data(), _slots.size() * sizeof(Slot));
+			Append(bytes, _freeSlots.data(), _freeSlots.size() * sizeof(std::uint32_t));
+			Append(bytes, _objectIDs.data(), _objectIDs.size() * sizeof(ObjectID));
+			Append(bytes, _objects.data(), _objects.size() * sizeof(TObject));
+		}
+
+		[[nodiscard]] std::vector<std::byte> Serialize() const
+		{
+			std::vector<std::byte> bytes;
+			Serialize(bytes);
+			return bytes;
+		}
+
+		/**
+		 * Replace all objects with serialized data, current objects are kept if data is invalid.
+		 * @return false if data is truncated, or was serialized from another object layout or version.
+		 */
+		bool Deserialize(std::span<const std::byte> bytes)
+		{
+			static_assert(std::is_trivially_copyable_v<TObject>, "Serialized objects must be trivially copyable");
+
+			SerialHeader header;
+			if (bytes.size() < sizeof(SerialHeader)) [[unlikely]]
+			{
+				return false;
+			}
+			std::memcpy(&header, bytes.data(), sizeof(SerialHeader));
+
+			if (header.magic != SerialMagic || header.version != SerialVersion || header.objectSize != sizeof(TObject) ||
+			    header.objectCount > header.slotCount || header.freeSlotCount > header.slotCount ||
+			    bytes.size() != GetSerialSize(header)) [[unlikely]]
+			{
+				return false;
+			}
+
+			std::vector<Slot> slots(header.slotCount);
+			std::vector<std::uint32_t> freeSlots(header.freeSlotCount);
+			std::vector<ObjectID> objectIDs(header.objectCount);
+			std::vector<TObject> objects(header.objectCount);
+
+			std::size_t offset = sizeof(SerialHeader);
+			Read(bytes, offset, slots.data(), slots.size() * sizeof(Slot));
+			Read(bytes, offset, freeSlots.data(), freeSlots.size() * sizeof(std::uint32_t));
+			Read(bytes, offset, objectIDs.data(), objectIDs.size() * sizeof(ObjectID));
+			Read(bytes, offset, objects.data(), objects.size() * sizeof(TObject));
+
+			// Reject mappings that would index out of range later on, or let two objects share a slot.
+			// Every object maps to an occupied slot that maps back to it.
+			for (std::size_t index = 0; index < objectIDs.size(); ++index)
+			{
+				std::uint32_t slotIndex = GetSlotIndex(objectIDs[index]);
+				if (slotIndex >= slots.size() || slots[slotIndex].index != index ||
+				    slots[slotIndex].generation != GetGeneration(objectIDs[index])) [[unlikely]]
+				{
+					return false;
+				}
+			}
+			// Every occupied slot points to an object that maps back to it.
+			std::size_t occupiedSlotCount = 0;
+			for (std::size_t slotIndex = 0; slotIndex < slots.size(); ++slotIndex)
+			{
+				std::uint32_t index = slots[slotIndex].index;
+				if (index == InvalidIndex)
+				{
+					continue;
+				}
+				if (index >= objectIDs.size() || GetSlotIndex(objectIDs[index]) != slotIndex) [[unlikely]]
+				{
+					return false;
+				}
+				++occupiedSlotCount;
+			}
+			// Every free slot is listed exactly once, so it is never handed out twice.
+			std::vector<bool> listedFreeSlots(slots.size(), false);
+			for (std::uint32_t slotIndex : freeSlots)
+			{
+				if (slotIndex >= slots.size() || slots[slotIndex].index != InvalidIndex || listedFreeSlots[slotIndex]) [[unlikely]]
+				{
+					return false;
+				}
+				listedFreeSlots[slotIndex] = true;
+			}
+			if (occupiedSlotCount + freeSlots.size() != slots.size()) [[unlikely]]
+			{
+				return false;
+			}
+
+			_slots = std::move(slots);
+			_freeSlots = std::move(freeSlots);
+			_objectIDs = std::move(objectIDs);
+			_objects = std::move(objects);
+			return true;
+		}
+
+	  protected:
+		Slot *FindSlot(ObjectID objectID) noexcept
+		{
+			return const_cast<Slot *>(std::as_const(*this).FindSlot(objectID));
+		}
+
+		const Slot *FindSlot(ObjectID objectID) const noexcept
+		{
+			std::uint32_t slotIndex = GetSlotIndex(objectID);
+			if (slotIndex >= _slots.size())
+			{
+				return nullptr;
+			}
+
+			const Slot &slot = _slots[slotIndex];
+			if (slot.index == InvalidIndex || slot.generation != GetGeneration(objectID))
+			{
+				return nullptr;
+			}
+			return &slot;
 		}
 
 	  private:
-		void LuaSerialize()
+		static std::size_t GetSerialSize(const SerialHeader &header) noexcept
+		{
+			return sizeof(SerialHeader) + header.slotCount * sizeof(Slot) + header.freeSlotCount * sizeof(std::uint32_t) +
+			       header.objectCount * (sizeof(ObjectID) + sizeof(TObject));
+		}
+
+		static void Append(std::vector<std::byte> &bytes, const void *data, std::size_t size)
+		{
+			const std::byte *begin = static_cast<const std::byte *>(data);
+			bytes.insert(bytes.end(), begin, begin + size);
+		}
+
+		static void Read(std::span<const std::byte> bytes, std::size_t &offset, void *data, std::size_t size) noexcept
+		{
+			if (size != 0)
+			{
+				std::memcpy(data, bytes.data() + offset, size);
+			}
+			offset += size;
+		}
+
+		/**
+		 * @param index 1 based dense index.
+		 */
+		sol::object LuaGetObjectAt(std::size_t index, sol::this_state ts) const noexcept
+		{
+			ObjectID objectID = index != 0 ? GetObjectIDAt(index - 1) : 0;
+			return objectID != 0 ? sol::make_object(ts, objectID) : sol::lua_nil;
+		}
+
+		/**
+		 * Fill ids in dense order, elements after the last id are cleared when reusing a buffer.
+		 */
+		sol::table LuaGetObjectIDs(sol::object buffer, sol::this_state ts) const noexcept
 		{
-			try
+			sol::table result;
+			if (buffer.is<sol::table>())
 			{
-				return Serialize();
+				result = buffer.as<sol::table>();
+				for (std::size_t index = result.size(); index > _objectIDs.size(); --index)
+				{
+					result[index] = sol::lua_nil;
+				}
 			}
-			catch (std::exception &e)
+			else
 			{
-				// TODO
+				result = sol::state_view(ts).create_table(static_cast<int>(_objectIDs.size()), 0);
 			}
+
+			for (std::size_t index = 0; index < _objectIDs.size(); ++index)
+			{
+				result[index + 1] = _objectIDs[index];
+			}
+			return result;
+		}
+
+		std::string LuaSerialize() const
+		{
+			std::vector<std::byte> bytes = Serialize();
+			return std::string(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+		}
+
+		bool LuaDeserialize(std::string_view data)
+		{
+			return Deserialize(std::span<const std::byte>(reinterpret_cast<const std::byte *>(data.data()), data.size()));
 		}
 	};
 } // namespace tudov
@@ -0,0 +1,167 @@
+/**
+ * @file Gameplay/PathGrid.hpp
+ * @author JagYayu
+ * @brief Grid pathfinding, A* for single agents and flow fields for crowds.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+	class TileMap;
+
+	/**
+	 * A grid of movement costs in tile coordinates, cost `0` means blocked.
+	 *
+	 * `FindPath` runs A* with a binary heap, node arrays are kept between searches and invalidated by a search stamp
+	 * instead of being cleared.
+	 *
+	 * Flow fields are distance fields towards one target, computed once and shared by all agents chasing that target,
+	 * each agent then only looks up the direction of its own tile. Fields can be computed on a background thread from
+	 * a snapshot of costs, editing the grid drops all fields.
+	 */
+	class PathGrid
+	{
+		friend LuaBindings;
+
+	  public:
+		using Cost = std::uint8_t;
+		using Distance = std::uint32_t;
+
+		static constexpr Distance Unreachable = UINT32_MAX;
+		static constexpr std::uint8_t NoDirection = 8;
+		static constexpr Distance StraightStep = 10;
+		static constexpr Distance DiagonalStep = 14;
+		static constexpr std::size_t MaxFlowFields = 32;
+
+		struct FlowField
+		{
+			std::uint64_t version;
+			std::int32_t targetIndex;
+			std::vector<Distance> distances;
+			// Index of neighbour offset to move towards, `NoDirection` at target or unreachable tiles.
+			std::vector<std::uint8_t> directions;
+		};
+
+	  protected:
+		struct FlowFieldJob
+		{
+			std::uint64_t version;
+			std::int32_t targetIndex;
+			std::shared_ptr<const std::vector<Cost>> costs;
+			std::int32_t width;
+			std::int32_t height;
+			bool diagonal;
+		};
+
+		struct HeapNode
+		{
+			Distance priority;
+			std::int32_t index;
+		};
+
+	  protected:
+		std::int32_t _x;
+		std::int32_t _y;
+		std::int32_t _width;
+		std::int32_t _height;
+		bool _diagonal;
+		// Shared with background jobs, replaced instead of modified when a job still holds it.
+		std::shared_ptr<std::vector<Cost>> _costs;
+		std::uint64_t _version;
+
+		std::uint32_t _searchStamp;
+		std::vector<std::uint32_t> _searchStamps;
+		std::vector<Distance> _searchDistances;
+		std::vector<std::int32_t> _searchParents;
+		std::vector<HeapNode> _searchHeap;
+
+		std::unordered_map<std::int32_t, std::shared_ptr<FlowField>> _flowFields;
+		std::deque<std::int32_t> _flowFieldOrder;
+		std::unordered_map<std::int32_t, std::uint64_t> _requestedFlowFields;
+
+		std::thread _thread;
+		std::atomic<bool> _stopping;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		std::deque<FlowFieldJob> _jobs;
+		std::vector<std::shared_ptr<FlowField>> _completed;
+
+	  public:
+		explicit PathGrid(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept;
+		explicit PathGrid(const PathGrid &) noexcept = delete;
+		explicit PathGrid(PathGrid &&) noexcept = delete;
+		PathGrid &operator=(const PathGrid &) noexcept = delete;
+		PathGrid &operator=(PathGrid &&) noexcept = delete;
+		~PathGrid() noexcept;
+
+		[[nodiscard]] std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t> GetBounds() const noexcept;
+		[[nodiscard]] bool IsInBound(std::int32_t x, std::int32_t y) const noexcept;
+
+		[[nodiscard]] Cost GetCost(std::int32_t x, std::int32_t y) const noexcept;
+		void SetCost(std::int32_t x, std::int32_t y, Cost cost) noexcept;
+		/**
+		 * Load costs from tile tags of a tile map layer, tiles outside the tile map are blocked.
+		 * @param[in] tagCosts Cost of each tag, tags without cost or tiles without type info cost 1.
+		 */
+		void LoadTileMap(const TileMap &tileMap, std::size_t layer, std::span<const Cost> tagCosts) noexcept;
+
+		[[nodiscard]] bool IsDiagonal() const noexcept;
+		/**
+		 * Allow diagonal moves, corners are never cut.
+		 */
+		void SetDiagonal(bool diagonal) noexcept;
+
+		/**
+		 * @return Tiles from start to target, both included, empty if unreachable.
+		 */
+		std::vector<std::tuple<std::int32_t, std::int32_t>> FindPath(std::int32_t startX, std::int32_t startY, std::int32_t targetX, std::int32_t targetY, std::size_t maxVisits = SIZE_MAX) noexcept;
+
+		const FlowField *ComputeFlowField(std::int32_t targetX, std::int32_t targetY) noexcept;
+		/**
+		 * Compute flow field on background thread, does nothing if the field is ready or already requested.
+		 */
+		bool RequestFlowField(std::int32_t targetX, std::int32_t targetY) noexcept;
+		[[nodiscard]] const FlowField *GetFlowField(std::int32_t targetX, std::int32_t targetY) noexcept;
+		void ClearFlowFields() noexcept;
+
+	  private:
+		std::int32_t ToIndex(std::int32_t x, std::int32_t y) const noexcept;
+		std::vector<Cost> &MutableCosts() noexcept;
+		void InvalidateFlowFields() noexcept;
+		void StoreFlowField(std::shared_ptr<FlowField> flowField) noexcept;
+		void CollectFlowFields() noexcept;
+		void WorkerMain() noexcept;
+
+		static std::shared_ptr<FlowField> BuildFlowField(const FlowFieldJob &job) noexcept;
+
+		void LuaLoadTypeIDs(sol::table typeIDs, sol::table costs);
+		void LuaLoadTileMap(const TileMap &tileMap, sol::table tagCosts, sol::object layer);
+		sol::object LuaFindPath(std::int32_t startX, std::int32_t startY, std::int32_t targetX, std::int32_t targetY, sol::object maxVisits, sol::this_state ts) noexcept;
+		bool LuaComputeFlowField(std::int32_t targetX, std::int32_t targetY) noexcept;
+		bool LuaHasFlowField(std::int32_t targetX, std::int32_t targetY) noexcept;
+		std::tuple<sol::object, sol::object, sol::object> LuaGetFlowDirection(std::int32_t targetX, std::int32_t targetY, std::int32_t x, std::int32_t y, sol::this_state ts) noexcept;
+	};
+} // namespace tudov
@@ -0,0 +1,178 @@
+/**
+ * @file Gameplay/PhysicsWorld.hpp
+ * @author JagYayu
+ * @brief 2D rigid body physics with a uniform grid broadphase.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	enum class EPhysicsShape : std::uint8_t
+	{
+		Circle,
+		Rect,
+	};
+
+	/**
+	 * Bodies are stored in dense arrays (one array per field), removal swaps the last body into the hole.
+	 * Body ids are generational like entity ids: low 32 bits are slot index + 1, higher bits are slot generation.
+	 *
+	 * A step integrates velocities, finds candidate pairs by bucketing body bounds into grid cells, then tests and
+	 * resolves them. No memory is allocated once buffers reached their peak size.
+	 *
+	 * All simulation math is fixed point with 16 fractional bits, floating point values are only converted at the API
+	 * boundary. Given the same sequence of calls, every platform produces bit-identical states, which is required by
+	 * rollback, see `GetStateHash`.
+	 */
+	class PhysicsWorld
+	{
+		friend LuaBindings;
+
+	  public:
+		using BodyID = std::uint64_t;
+		using Fixed = std::int64_t;
+
+		static constexpr std::uint32_t FractionBits = 16;
+		static constexpr Fixed FixedOne = Fixed(1) << FractionBits;
+
+		static constexpr std::uint32_t GenerationBits = 20;
+		static constexpr std::uint32_t GenerationMask = (1u << GenerationBits) - 1;
+		static constexpr std::uint32_t InvalidIndex = UINT32_MAX;
+		static constexpr std::double_t DefaultCellSize = 64.0;
+
+		struct Contact
+		{
+			BodyID a;
+			BodyID b;
+			// Unit normal points from `a` to `b`.
+			Fixed normalX;
+			Fixed normalY;
+			Fixed depth;
+		};
+
+	  protected:
+		struct Slot
+		{
+			std::uint32_t generation;
+			std::uint32_t index;
+		};
+
+		struct CellEntry
+		{
+			std::uint64_t cell;
+			std::uint32_t index;
+		};
+
+	  protected:
+		Fixed _cellSize;
+
+		std::vector<Slot> _slots;
+		std::vector<std::uint32_t> _freeSlots;
+
+		std::vector<BodyID> _ids;
+		std::vector<EPhysicsShape> _shapes;
+		std::vector<Fixed> _positionsX;
+		std::vector<Fixed> _positionsY;
+		std::vector<Fixed> _velocitiesX;
+		std::vector<Fixed> _velocitiesY;
+		// Circle: radius, radius. Rect: half width, half height.
+		std::vector<Fixed> _extentsX;
+		std::vector<Fixed> _extentsY;
+		std::vector<Fixed> _inverseMasses;
+
+		std::vector<CellEntry> _cellEntries;
+		std::vector<Contact> _contacts;
+
+	  public:
+		explicit PhysicsWorld(std::double_t cellSize = DefaultCellSize) noexcept;
+		explicit PhysicsWorld(const PhysicsWorld &) noexcept = delete;
+		explicit PhysicsWorld(PhysicsWorld &&) noexcept = default;
+		PhysicsWorld &operator=(const PhysicsWorld &) noexcept = delete;
+		PhysicsWorld &operator=(PhysicsWorld &&) noexcept = default;
+		~PhysicsWorld() noexcept = default;
+
+		static Fixed ToFixed(std::double_t value) noexcept;
+		static std::double_t FromFixed(Fixed value) noexcept;
+
+		/**
+		 * @param mass 0 for static bodies.
+		 */
+		BodyID AddCircle(std::double_t x, std::double_t y, std::double_t radius, std::double_t mass) noexcept;
+		/**
+		 * @param mass 0 for static bodies.
+		 */
+		BodyID AddRect(std::double_t x, std::double_t y, std::double_t width, std::double_t height, std::double_t mass) noexcept;
+		bool RemoveBody(BodyID bodyID) noexcept;
+		[[nodiscard]] bool HasBody(BodyID bodyID) const noexcept;
+		[[nodiscard]] std::size_t GetBodyCount() const noexcept;
+
+		[[nodiscard]] std::tuple<std::double_t, std::double_t> GetPosition(BodyID bodyID) const noexcept;
+		bool SetPosition(BodyID bodyID, std::double_t x, std::double_t y) noexcept;
+		[[nodiscard]] std::tuple<std::double_t, std::double_t> GetVelocity(BodyID bodyID) const noexcept;
+		bool SetVelocity(BodyID bodyID, std::double_t x, std::double_t y) noexcept;
+
+		[[nodiscard]] std::double_t GetCellSize() const noexcept;
+		void SetCellSize(std::double_t cellSize) noexcept;
+
+		/**
+		 * Integrate, detect and resolve collisions.
+		 * @param deltaTime Should be a constant tick interval, it is quantized to fixed point as well.
+		 * @return Number of contacts found in this step.
+		 */
+		std::size_t Step(std::double_t deltaTime) noexcept;
+
+		[[nodiscard]] const std::vector<Contact> &GetContacts() const noexcept;
+
+		/**
+		 * FNV-1a hash of all simulation state, peers running the same ticks must have the same hash.
+		 */
+		[[nodiscard]] std::uint64_t GetStateHash() const noexcept;
+
+		/**
+		 * Binary dump of all simulation state, including slots, so body ids stay valid after deserialization.
+		 */
+		[[nodiscard]] std::string Serialize() const noexcept;
+		/**
+		 * Data may come from peers, it is fully validated. On failure the world is left empty.
+		 */
+		bool Deserialize(std::string_view data) noexcept;
+
+		void Clear() noexcept;
+
+	  private:
+		BodyID AddBody(EPhysicsShape shape, Fixed x, Fixed y, Fixed extentX, Fixed extentY, Fixed mass) noexcept;
+		std::uint32_t FindIndex(BodyID bodyID) const noexcept;
+		/**
+		 * Check slots, free slots and bodies refer to each other correctly, used on deserialized data.
+		 */
+		[[nodiscard]] bool IsConsistent() const noexcept;
+
+		void Integrate(Fixed deltaTime) noexcept;
+		void Broadphase() noexcept;
+		void Narrowphase(std::uint32_t a, std::uint32_t b) noexcept;
+		bool Collide(std::uint32_t a, std::uint32_t b, Fixed &normalX, Fixed &normalY, Fixed &depth) const noexcept;
+		void Resolve(std::uint32_t a, std::uint32_t b, Fixed normalX, Fixed normalY) noexcept;
+
+		std::size_t LuaGetContactCount() const noexcept;
+		std::tuple<BodyID, BodyID, std::double_t, std::double_t, std::double_t> LuaGetContact(std::size_t index) const noexcept;
+		/**
+		 * Lua numbers are doubles, the hash is truncated to 53 bits.
+		 */
+		std::uint64_t LuaGetStateHash() const noexcept;
+	};
+} // namespace tudov
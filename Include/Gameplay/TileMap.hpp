@@ -0,0 +1,145 @@
+/**
+ * @file Gameplay/TileMap.hpp
+ * @author JagYayu
+ * @brief Layered tile type storage with per type tags and flags, and dirty region tracking.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	/**
+	 * Tile types are packed `uint16` arrays in row major order, one array per layer.
+	 * Tags and flags belong to tile types, they are kept in a table indexed by type id so lookups never leave C++.
+	 *
+	 * The map is split into chunks of `ChunkSize` tiles, editing tiles marks their chunks dirty, so renderers and
+	 * pathfinding only rebuild what changed.
+	 */
+	class TileMap
+	{
+		friend LuaBindings;
+
+	  public:
+		using TypeID = std::uint16_t;
+		using Tag = std::uint8_t;
+		using Flags = std::uint32_t;
+
+		static constexpr std::int32_t ChunkSize = 16;
+
+		/**
+		 * Bits of neighbour masks, see `GetNeighbourMask`.
+		 */
+		enum ENeighbour : std::uint8_t
+		{
+			NeighbourUp = 1 << 0,
+			NeighbourRight = 1 << 1,
+			NeighbourDown = 1 << 2,
+			NeighbourLeft = 1 << 3,
+			NeighbourLeftHasInfo = 1 << 4,
+			NeighbourRightHasInfo = 1 << 5,
+		};
+
+		struct TypeInfo
+		{
+			Tag tag;
+			Flags flags;
+			bool valid;
+		};
+
+	  protected:
+		std::int32_t _x;
+		std::int32_t _y;
+		std::int32_t _width;
+		std::int32_t _height;
+		std::vector<std::vector<TypeID>> _layers;
+		std::vector<TypeInfo> _typeInfos;
+
+		std::int32_t _chunksX;
+		std::int32_t _chunksY;
+		std::vector<std::uint8_t> _dirtyChunks;
+		std::size_t _dirtyChunkCount;
+
+	  public:
+		explicit TileMap(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::size_t layers = 1) noexcept;
+		explicit TileMap(const TileMap &) noexcept = delete;
+		explicit TileMap(TileMap &&) noexcept = default;
+		TileMap &operator=(const TileMap &) noexcept = delete;
+		TileMap &operator=(TileMap &&) noexcept = default;
+		~TileMap() noexcept = default;
+
+		[[nodiscard]] std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t> GetBounds() const noexcept;
+		[[nodiscard]] bool IsInBound(std::int32_t x, std::int32_t y) const noexcept;
+		[[nodiscard]] std::size_t GetLayerCount() const noexcept;
+
+		/**
+		 * @return Type id at tile, `0` if out of bound.
+		 */
+		[[nodiscard]] TypeID GetType(std::size_t layer, std::int32_t x, std::int32_t y) const noexcept;
+		bool SetType(std::size_t layer, std::int32_t x, std::int32_t y, TypeID type) noexcept;
+		/**
+		 * Set types in a rect, the rect is clipped to map bounds.
+		 */
+		void Fill(std::size_t layer, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TypeID type) noexcept;
+
+		[[nodiscard]] std::span<const TypeID> GetLayer(std::size_t layer) const noexcept;
+		[[nodiscard]] std::span<const TypeID> GetRow(std::size_t layer, std::int32_t y) const noexcept;
+
+		[[nodiscard]] const TypeInfo *GetTypeInfo(TypeID type) const noexcept;
+		void SetTypeInfo(TypeID type, Tag tag, Flags flags) noexcept;
+		void ClearTypeInfos() noexcept;
+		/**
+		 * @return Info of tile type at tile, nullptr if out of bound or type has no info.
+		 */
+		[[nodiscard]] const TypeInfo *GetTileInfo(std::size_t layer, std::int32_t x, std::int32_t y) const noexcept;
+		/**
+		 * @return `ENeighbour` bits, four sides with type tagged `tag`, and left/right sides with any type info.
+		 */
+		[[nodiscard]] std::uint8_t GetNeighbourMask(std::size_t layer, std::int32_t x, std::int32_t y, Tag tag) const noexcept;
+
+		[[nodiscard]] bool IsDirty() const noexcept;
+		/**
+		 * Mark chunks overlapping the rect dirty.
+		 */
+		void MarkDirty(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept;
+		void MarkAllDirty() noexcept;
+		/**
+		 * @return Rects of dirty chunks in tile coordinates, clipped to map bounds.
+		 */
+		[[nodiscard]] std::vector<std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t>> GetDirtyRegions() const noexcept;
+		void ClearDirty() noexcept;
+
+	  private:
+		std::size_t ToIndex(std::int32_t x, std::int32_t y) const noexcept;
+
+		static std::size_t ToLayer(sol::object layer) noexcept;
+
+		void LuaLoadTypeIDs(sol::table typeIDs, sol::object layer) noexcept;
+		std::uint32_t LuaGetType(std::int32_t x, std::int32_t y, sol::object layer) const noexcept;
+		bool LuaSetType(std::int32_t x, std::int32_t y, TypeID type, sol::object layer) noexcept;
+		void LuaFill(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TypeID type, sol::object layer) noexcept;
+		sol::object LuaGetTag(std::int32_t x, std::int32_t y, sol::object layer, sol::this_state ts) const noexcept;
+		sol::object LuaGetFlags(std::int32_t x, std::int32_t y, sol::object layer, sol::this_state ts) const noexcept;
+		bool LuaHasFlags(std::int32_t x, std::int32_t y, Flags flags, sol::object layer) const noexcept;
+		sol::table LuaGetRow(std::int32_t y, sol::object buffer, sol::object layer, sol::this_state ts) const noexcept;
+		sol::table LuaGetNeighbourRow(std::int32_t y, Tag tag, sol::object buffer, sol::object layer, sol::this_state ts) const noexcept;
+		sol::table LuaGetRect(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, sol::object layer, sol::this_state ts) const noexcept;
+		sol::table LuaQueryTag(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, Tag tag, sol::object layer, sol::this_state ts) const noexcept;
+		sol::table LuaGetDirtyRegions(sol::this_state ts) const noexcept;
+	};
+} // namespace tudov
@@ -60,7 +60,7 @@ namespace tudov
 		std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _lruMap;
 
 	  public:
-		explicit Font(std::string_view path, const std::vector<std::byte> &bytes) noexcept;
+		explicit Font(std::string_view path, std::span<const std::byte> bytes) noexcept;
 		explicit Font(const Font &) noexcept = default;
 		explicit Font(Font &&) noexcept = default;
 		Font &operator=(const Font &) noexcept = default;
@@ -11,9 +11,13 @@
 
 #pragma once
 
+#include "Data/BlobStore.hpp"
 #include "Resource/Resource.hpp"
 
 #include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -24,19 +28,26 @@ namespace tudov::impl
 
 namespace tudov
 {
+	class DecodedImageCache;
+
 	class Image : public IResource
 	{
 	  private:
 		std::string_view _path;
-		impl::SDL_Surface *_sdlSurface;
+		// May be shared with other images of identical contents.
+		std::shared_ptr<impl::SDL_Surface> _sdlSurface;
 
 	  public:
-		explicit Image(std::string_view path, const std::vector<std::byte> &bytes);
+		/**
+		 * @param[in] cache Decodes through this cache if not null, so identical contents are decoded once.
+		 * @param[in] hash Content hash if known already, saves cache from hashing `bytes`.
+		 */
+		explicit Image(std::string_view path, std::span<const std::byte> bytes, DecodedImageCache *cache = nullptr, std::optional<BlobHash> hash = std::nullopt);
 		explicit Image(const Image &) noexcept = default;
 		explicit Image(Image &&) noexcept = default;
 		Image &operator=(const Image &) noexcept = default;
 		Image &operator=(Image &&) noexcept = default;
-		~Image() noexcept;
+		~Image() noexcept = default;
 
 		std::string_view GetFilePath() const noexcept override;
 
@@ -129,6 +129,7 @@ namespace tudov
 		std::shared_ptr<RenderBuffer> NewRenderBuffer() noexcept;
 
 		std::shared_ptr<Texture> ExtractTexture(sol::table args) noexcept;
+		std::shared_ptr<Texture> GetOrCreateImageTexture(ImageID imageID);
 
 		SDL_Renderer *GetSDLRendererHandle() noexcept;
 
@@ -141,8 +142,6 @@ namespace tudov
 		void SetRenderTexture(const std::shared_ptr<Texture> &texture = nullptr) noexcept;
 
 	  private:
-		std::shared_ptr<Texture> GetOrCreateImageTexture(ImageID imageID);
-
 		void LuaBeginTarget(sol::object renderTarget) noexcept;
 		std::shared_ptr<RenderTarget> LuaEndTarget() noexcept;
 		void LuaDrawRect(DrawRectArgs *args) noexcept;
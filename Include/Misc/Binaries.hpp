@@ -26,7 +26,7 @@ namespace tudov
 		std::span<const std::byte> _bytes;
 
 	  public:
-		explicit Binaries(std::string_view path, const std::vector<std::byte> &bytes) noexcept;
+		explicit Binaries(std::string_view path, std::span<const std::byte> bytes) noexcept;
 		explicit Binaries(const Binaries &) noexcept = default;
 		explicit Binaries(Binaries &&) noexcept = default;
 		Binaries &operator=(const Binaries &) noexcept = default;
@@ -14,6 +14,7 @@
 #include "Resource/Resource.hpp"
 
 #include <cstddef>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -33,7 +34,7 @@ namespace tudov
 		Text &operator=(Text &&) noexcept = default;
 		~Text() noexcept override = default;
 
-		explicit Text(std::string_view path, const std::vector<std::byte> &bytes) noexcept;
+		explicit Text(std::string_view path, std::span<const std::byte> bytes) noexcept;
 
 		std::string_view GetFilePath() const noexcept override;
 
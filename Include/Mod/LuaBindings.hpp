@@ -132,6 +132,8 @@ namespace tudov
 
 	  private:
 		void InstallEvent(sol::state &lua, Context &context) noexcept;
+		void InstallFFI(sol::state &lua, Context &context) noexcept;
+		void InstallGameplay(sol::state &lua, Context &context) noexcept;
 		void InstallKeyModifier(sol::state &lua, Context &context) noexcept;
 		void InstallMod(sol::state &lua, Context &context) noexcept;
 		void InstallNetwork(sol::state &lua, Context &context) noexcept;
@@ -0,0 +1,38 @@
+/**
+ * @file Mod/LuaFFI.hpp
+ * @author JagYayu
+ * @brief C ABI entry points for LuaJIT FFI fast paths.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#define TE_FFI_EXPORT extern "C" __declspec(dllexport)
+#else
+#define TE_FFI_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+/**
+ * Every function below is handed to lua as a function pointer (see `FFIExports` table), and casted by `#TE.FFI`.
+ * Handles are raw object pointers resolved by `FFIExports` handle functions from genuine userdata, image ids are the same values
+ * accepted by `DrawRectArgs.texture`, `0` means no texture.
+ * None of these functions may throw or raise lua errors, since they are called from inside FFI frames.
+ */
+
+TE_FFI_EXPORT void TE_FFI_Renderer_DrawRect(void *renderer, std::uint64_t imageID, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, std::uint32_t color) noexcept;
+TE_FFI_EXPORT void TE_FFI_Renderer_DrawRectNoSource(void *renderer, std::uint64_t imageID, float dx, float dy, float dw, float dh, std::uint32_t color) noexcept;
+
+TE_FFI_EXPORT void TE_FFI_RenderBuffer_AddRectangle(void *renderBuffer, std::uint64_t imageID, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, std::uint32_t color) noexcept;
+
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Noise2(void *noiseRandom, float x, float y) noexcept;
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Noise3(void *noiseRandom, float x, float y, float z) noexcept;
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Float2(void *noiseRandom, float x, float y, float min, float max) noexcept;
+TE_FFI_EXPORT std::int32_t TE_FFI_PerlinNoiseRandom_Int2(void *noiseRandom, float x, float y, std::int32_t min, std::int32_t max) noexcept;
+TE_FFI_EXPORT std::int32_t TE_FFI_PerlinNoiseRandom_Int3(void *noiseRandom, float x, float y, float z, std::int32_t min, std::int32_t max) noexcept;
@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 namespace tudov
 {
@@ -25,6 +26,15 @@ namespace tudov
 	{
 		virtual ~IMod() noexcept = default;
 
+		/**
+		 * Discover files to load, and return independent jobs reading them. Jobs run on loader threads, they must
+		 * only touch this mod. `Load` then uses what jobs have read, without preparing it reads everything itself.
+		 */
+		virtual std::vector<std::function<void()>> Prepare()
+		{
+			return {};
+		}
+
 		virtual void Load() = 0;
 		virtual void Unload() = 0;
 
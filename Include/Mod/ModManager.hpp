@@ -22,8 +22,11 @@
 #include "ScriptProvider.hpp"
 #include "System/Log.hpp"
 
+#include <cmath>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <string_view>
 
 namespace tudov
 {
@@ -152,6 +155,10 @@ namespace tudov
 	  private:
 		bool IsModAvailableImpl(std::string_view modUID, const Version *version) const noexcept;
 		void UpdateScripts() noexcept;
+		/**
+		 * Run `job` for indices [0, count) on worker threads, and report stage progress in [progressBegin, progressEnd].
+		 */
+		void RunParallel(std::string_view stage, std::float_t progressBegin, std::float_t progressEnd, std::size_t count, const std::function<void(std::size_t)> &job) noexcept;
 
 		std::vector<DebugConsoleResult> DebugAdd(std::string_view arg);
 	};
@@ -15,6 +15,7 @@
 #include "Program/Memory.hpp"
 #include "System/Log.hpp"
 #include "Util/Definitions.hpp"
+#include "Util/StringUtils.hpp"
 #include "Util/Utils.hpp"
 
 #include "sol/load_result.hpp"
@@ -25,6 +26,7 @@
 #include <map>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace tudov
@@ -94,6 +96,11 @@ namespace tudov
 
 		virtual sol::table &GetModGlobals(std::string_view sandboxKey, bool sandboxed) noexcept = 0;
 
+		/**
+		 * Register a persist variable of a script, returns the value saved from previous load or `defaultValue`.
+		 * If `getter` is invalid, the variable is persisted by reference: `defaultValue` itself is kept and no getter will be
+		 * called when saving, used for tables that are never reassigned.
+		 */
 		virtual sol::object RegisterPersistVariable(std::string_view scriptName, std::string_view key, sol::object defaultValue, const sol::protected_function &getter) = 0;
 
 		virtual std::unordered_map<std::string_view, sol::object> GetScriptPersistVariables(std::string_view scriptName) noexcept = 0;
@@ -102,6 +109,11 @@ namespace tudov
 
 		virtual void SavePersistVariables() noexcept = 0;
 
+		/**
+		 * Save persist variables of scripts in one pass, e.g. all scripts that are going to be hot reloaded.
+		 */
+		virtual void SavePersistVariables(const std::vector<ScriptID> &scriptIDs) noexcept = 0;
+
 		virtual bool ClearScriptPersistVariables(std::string_view scriptName) noexcept = 0;
 
 		virtual void ClearPersistVariables() noexcept = 0;
@@ -131,11 +143,16 @@ namespace tudov
 		struct PersistVariable
 		{
 			sol::object value;
+			// Invalid if variable was persisted by reference.
 			sol::protected_function getter;
 
 			void Save() noexcept;
 		};
 
+		// Interned script name id in high 32 bits, interned key id in low 32 bits.
+		using PersistVariableKey = std::uint64_t;
+		using PersistNameID = std::uint32_t;
+
 	  private:
 		Context &_context;
 		std::unique_ptr<Memory> _memory;
@@ -143,7 +160,10 @@ namespace tudov
 		sol::state _lua;
 		bool _luaInit;
 
-		std::map<std::string, std::map<std::string, PersistVariable>> _persistVariables;
+		std::unordered_map<std::string, PersistNameID, StringSVHash, StringSVEqual> _persistNameIDs;
+		std::vector<std::string_view> _persistNames;
+		std::unordered_map<PersistVariableKey, PersistVariable> _persistVariables;
+		std::unordered_map<PersistNameID, std::vector<PersistNameID>> _scriptPersistKeys;
 		std::map<std::string_view, sol::table> _modsGlobals;
 
 		sol::protected_function _luaThrowModifyReadonlyGlobalError;
@@ -157,6 +177,7 @@ namespace tudov
 		std::vector<std::shared_ptr<ScriptError>> _scriptRuntimeErrors;
 
 		DelegateEventHandlerID _handlerIDUnloadScript = 0;
+		DelegateEventHandlerID _handlerIDPreHotReloadScripts = 0;
 
 	  public:
 		explicit ScriptEngine(Context &context) noexcept;
@@ -200,12 +221,16 @@ namespace tudov
 		std::unordered_map<std::string_view, sol::object> GetScriptPersistVariables(std::string_view scriptName) noexcept override;
 		void SaveScriptPersistVariables(std::string_view scriptName) noexcept override;
 		void SavePersistVariables() noexcept override;
+		void SavePersistVariables(const std::vector<ScriptID> &scriptIDs) noexcept override;
 		bool ClearScriptPersistVariables(std::string_view scriptName) noexcept override;
 		void ClearPersistVariables() noexcept override;
 
 	  private:
 		std::array<ILuaBindings *, 2> GetLuaBindingsComponents() noexcept;
 		void AssertLuaValue(sol::object value, std::string_view name) noexcept;
+		PersistNameID InternPersistName(std::string_view name) noexcept;
+		void SaveScriptPersistVariables(PersistNameID scriptNameID) noexcept;
+		sol::object RegisterPersistVariable(PersistNameID scriptNameID, std::string_view key, sol::object defaultValue, const sol::protected_function &getter);
 		sol::object MakeReadonlyGlobalImpl(sol::object obj, std::unordered_map<sol::table, sol::table, LuaTableHash, LuaTableEqual> &visited) noexcept;
 
 		sol::object LuaRequire(sol::string_view targetScriptName, ScriptRequire *script) noexcept;
@@ -24,6 +24,7 @@
 #include <optional>
 #include <set>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -121,6 +122,12 @@ namespace tudov
 		 */
 		virtual std::vector<ScriptID> GetScriptDependencies(ScriptID scriptID) const = 0;
 
+		/**
+		 * Collect scripts that must be reloaded once given scripts changed, i.e. themselves and all scripts depend on them.
+		 * Result vector is topologically sorted, a script always comes after the scripts it depends on.
+		 */
+		virtual std::vector<ScriptID> CollectDirtyScripts(const std::vector<ScriptID> &scriptIDs) const = 0;
+
 		/**
 		 * Link script dependency, e.g. "A.lua" has script `require "B.lua"`, then "B.lua"'s hot-reload procession will also affect "A.lua".
 		 * I know its a bad naming yeah, just ignore the "Reverse" part. Consider it as a "AddScriptDependency" function.
@@ -166,9 +173,9 @@ namespace tudov
 		virtual std::vector<ScriptID> UnloadInvalidScripts() = 0;
 
 		/**
-		 * Hot reload a vector of scripts.
-		 * Note that this is an internal implementation of the lua script system. To ensure the correctness of overloading,
-		 * ensure that the passed vector of hot reload scripts contains all scripts that depend on them.
+		 * Hot reload a vector of changed scripts.
+		 * Scripts depend on them are collected by `CollectDirtyScripts` and reloaded as well, untouched scripts keep their
+		 * modules and event handlers.
 		 */
 		virtual void HotReloadScripts(const std::vector<ScriptID> &scriptIDs) = 0;
 
@@ -260,7 +267,10 @@ namespace tudov
 		Context &_context;
 		std::shared_ptr<Log> _log;
 		std::unordered_map<ScriptID, std::shared_ptr<ScriptModule>> _scriptModules;
+		// target -> sources, scripts that require the target.
 		std::unordered_map<ScriptID, std::set<ScriptID>> _scriptReversedDependencies;
+		// source -> targets, scripts that the source requires. Keep unlinking O(degree) on unload.
+		std::unordered_map<ScriptID, std::set<ScriptID>> _scriptDependencies;
 		EFlag _flags;
 
 		// Set this value when a script module is doing whatever loads.
@@ -282,6 +292,10 @@ namespace tudov
 		mutable std::unordered_set<ScriptID> _parseErrorScripts;
 		mutable std::uint64_t _scriptProviderVersion;
 
+		// Reused by `CollectDirtyScripts` to avoid allocating on every hot reload.
+		mutable std::unordered_set<ScriptID> _dirtyVisited;
+		mutable std::vector<std::tuple<ScriptID, bool>> _dirtyStack;
+
 	  public:
 		explicit ScriptLoader(Context &context) noexcept;
 		explicit ScriptLoader(const ScriptLoader &) noexcept = delete;
@@ -312,6 +326,7 @@ namespace tudov
 		ScriptID GetLoadingScriptID() const noexcept override;
 		std::optional<std::string_view> GetLoadingScriptName() const noexcept override;
 		std::vector<ScriptID> GetScriptDependencies(ScriptID scriptID) const override;
+		std::vector<ScriptID> CollectDirtyScripts(const std::vector<ScriptID> &scriptIDs) const override;
 		void AddReverseDependency(ScriptID source, ScriptID target) override;
 
 		void LoadAllScripts() override;
@@ -327,7 +342,8 @@ namespace tudov
 	  protected:
 		void CheckScriptProvider() const noexcept;
 		std::shared_ptr<ScriptModule> LoadImpl(ScriptID scriptID, std::string_view scriptName, std::string_view code, std::string_view mod);
-		void UnloadImpl(ScriptID scriptID, std::vector<ScriptID> *unloadedScripts);
+		bool UnloadImpl(ScriptID scriptID);
+		void UnloadDirtyScripts(const std::vector<ScriptID> &dirtyScripts, std::vector<ScriptID> *unloadedScripts);
 		void PostLoadScripts();
 
 	  private:
@@ -0,0 +1,147 @@
+/**
+ * @file Mod/ScriptWorkers.hpp
+ * @author JagYayu
+ * @brief Sandboxed lua worker states, run pure script jobs off the main thread.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "Program/EngineComponent.hpp"
+#include "System/Log.hpp"
+#include "sol/forward.hpp"
+#include "sol/function.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct lua_State;
+
+namespace tudov
+{
+	class LuaBindings;
+
+	using ScriptWorkerJobID = std::uint64_t;
+
+	/**
+	 * A pool of lua states living on their own threads.
+	 * Jobs are pure lua functions: no upvalues, no access to engine objects, arguments and results cross states by
+	 * `string.buffer` encoding. Results are dispatched to callbacks on the main thread at the beginning of each tick.
+	 */
+	struct IScriptWorkers : public IEngineComponent
+	{
+		/**
+		 * @param bytecode Function bytecode, produced by `string.dump` / `lua_dump`.
+		 * @param encodedArgs Argument encoded by `string.buffer.encode`.
+		 * @return Job id, `0` if the job was rejected, e.g. no worker thread could be started.
+		 */
+		virtual ScriptWorkerJobID Submit(std::string bytecode, std::string encodedArgs, sol::protected_function callback) noexcept = 0;
+
+		/**
+		 * Drop the callback of a pending job, the job itself may still run but its result will be discarded.
+		 */
+		virtual bool Cancel(ScriptWorkerJobID jobID) noexcept = 0;
+
+		virtual std::size_t GetPendingJobs() const noexcept = 0;
+
+		virtual std::size_t GetWorkerCount() const noexcept = 0;
+	};
+
+	class ScriptWorkers final : public IScriptWorkers, private ILogProvider
+	{
+		friend LuaBindings;
+
+	  protected:
+		struct Job
+		{
+			ScriptWorkerJobID id;
+			std::string bytecode;
+			std::string encodedArgs;
+		};
+
+		struct JobResult
+		{
+			ScriptWorkerJobID id;
+			bool success;
+			// Encoded result if succeeded, otherwise error message.
+			std::string data;
+		};
+
+	  private:
+		Context &_context;
+		std::shared_ptr<Log> _log;
+
+		ScriptWorkerJobID _latestJobID;
+		// Jobs submitted but not dispatched yet, main thread only.
+		std::size_t _pendingJobs;
+		std::vector<std::thread> _threads;
+		std::atomic<bool> _stopping;
+
+		std::mutex _jobsMutex;
+		std::condition_variable _jobsCV;
+		std::deque<Job> _jobs;
+
+		std::mutex _resultsMutex;
+		std::vector<JobResult> _results;
+		std::vector<JobResult> _dispatchingResults;
+
+		/**
+		 * Sources of static modules that jobs are allowed to `require`, snapshotted before threads start, read only after.
+		 */
+		std::unordered_map<std::string, std::string> _moduleSources;
+		/**
+		 * Globals of mod environments, jobs never see more than mods submitting them. Snapshotted like `_moduleSources`.
+		 */
+		std::unordered_set<std::string> _globalNames;
+
+		std::unordered_map<ScriptWorkerJobID, sol::protected_function> _callbacks;
+		sol::protected_function _encode;
+		sol::protected_function _decode;
+
+	  public:
+		explicit ScriptWorkers(Context &context) noexcept;
+		explicit ScriptWorkers(const ScriptWorkers &) noexcept = delete;
+		explicit ScriptWorkers(ScriptWorkers &&) noexcept = delete;
+		ScriptWorkers &operator=(const ScriptWorkers &) noexcept = delete;
+		ScriptWorkers &operator=(ScriptWorkers &&) noexcept = delete;
+		~ScriptWorkers() noexcept override;
+
+		Context &GetContext() noexcept override;
+		Log &GetLog() noexcept override;
+
+		void Deinitialize() noexcept override;
+		void ProcessTick() noexcept override;
+
+		ScriptWorkerJobID Submit(std::string bytecode, std::string encodedArgs, sol::protected_function callback) noexcept override;
+		bool Cancel(ScriptWorkerJobID jobID) noexcept override;
+		std::size_t GetPendingJobs() const noexcept override;
+		std::size_t GetWorkerCount() const noexcept override;
+
+	  private:
+		/**
+		 * @return false if not even one worker thread could be created.
+		 */
+		bool StartWorkers() noexcept;
+		void StopWorkers() noexcept;
+		void WorkerMain(std::size_t index) noexcept;
+		void InstallWorkerState(sol::state &lua) noexcept;
+		void BindStringBuffer(lua_State *L) noexcept;
+
+		ScriptWorkerJobID LuaSubmit(sol::object func, sol::object args, sol::object callback) noexcept;
+		bool LuaCancel(sol::object jobID) noexcept;
+	};
+} // namespace tudov
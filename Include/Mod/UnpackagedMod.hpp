@@ -14,11 +14,15 @@
 #include "Mod.hpp"
 #include "Program/Context.hpp"
 #include "System/Log.hpp"
+#include "Util/FileChangeJournal.hpp"
+#include "Util/FilePattern.hpp"
 
 #include <memory>
-#include <queue>
-#include <regex>
+#include <optional>
+#include <span>
+#include <string>
 #include <tuple>
+#include <vector>
 
 namespace tudov
 {
@@ -33,18 +37,32 @@ namespace tudov
 
 	class UnpackagedMod final : public Mod, public IUnpackagedMod, public IContextProvider, private ILogProvider
 	{
+	  private:
+		struct PreparedFile
+		{
+			std::filesystem::path path;
+			bool script;
+			std::vector<std::byte> bytes;
+			// Set if reading failed, the file is skipped by `Load`.
+			std::string error;
+		};
+
 	  private:
 		std::shared_ptr<Log> _log;
 
 		bool _loaded;
+		// Declared before watcher, watcher callbacks record into it until watcher is destroyed.
+		FileChangeJournal _fileChangeJournal;
 		std::unique_ptr<FileSystemWatch> _fileWatcher;
 		std::filesystem::path _directory;
 
-		std::vector<std::regex> _scriptFilePatterns;
-		std::vector<std::regex> _fontFilePatterns;
-
-		std::queue<std::tuple<std::filesystem::path, EPathType, EFileChangeType>> _fileWatchQueue;
-		std::mutex _fileWatchMutex;
+		std::vector<FilePattern> _scriptFilePatterns;
+		std::vector<FilePattern> _fontFilePatterns;
+		// Lexically normal scripts directory ending with '/'.
+		std::string _scriptsDirectory;
+		// Filled by `Prepare` jobs, consumed by `Load`.
+		std::vector<PreparedFile> _preparedFiles;
+		bool _prepared;
 
 	  public:
 		explicit UnpackagedMod(ModManager &modManager, const std::filesystem::path &directory);
@@ -74,15 +92,22 @@ namespace tudov
 		bool IsValidDirectory(const std::filesystem::path &directory);
 		ModConfig LoadConfig(const std::filesystem::path &directory);
 
+		std::vector<std::function<void()>> Prepare() override;
 		void Load() override;
 		void Unload() override;
 
 	  private:
 		void UpdateFileMatchPatterns();
+		/**
+		 * @return nullopt if reading failed, the error is logged.
+		 */
+		std::optional<std::vector<std::byte>> ReadModFile(const std::filesystem::path &file) noexcept;
 		void ScriptAdded(const std::filesystem::path &file) noexcept;
+		void ScriptAdded(const std::filesystem::path &file, std::vector<std::byte> &&scriptCode) noexcept;
 		bool ScriptRemoved(const std::filesystem::path &file) noexcept;
 		bool ScriptModified(const std::filesystem::path &file) noexcept;
 		void FileAdded(const std::filesystem::path &file) noexcept;
+		void FileAdded(const std::filesystem::path &file, std::vector<std::byte> &&bytes) noexcept;
 		void FileRemoved(const std::filesystem::path &file) noexcept;
 		void FileModified(const std::filesystem::path &file) noexcept;
 	};
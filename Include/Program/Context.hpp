@@ -26,6 +26,7 @@ namespace tudov
 	struct IScriptErrors;
 	struct IScriptLoader;
 	struct IScriptProvider;
+	struct IScriptWorkers;
 	struct ILocalization;
 	class Config;
 	class Engine;
@@ -64,6 +65,7 @@ namespace tudov
 		[[nodiscard]] IScriptErrors &GetScriptErrors();
 		[[nodiscard]] IScriptLoader &GetScriptLoader();
 		[[nodiscard]] IScriptProvider &GetScriptProvider();
+		[[nodiscard]] IScriptWorkers &GetScriptWorkers();
 		[[nodiscard]] IGlobalStorageManager &GetGlobalStorageManager();
 		[[nodiscard]] ILocalization &GetLocalization();
 		[[nodiscard]] INetworkManager &GetNetworkManager();
@@ -118,6 +120,11 @@ namespace tudov
 			return This()->GetScriptProvider();
 		}
 
+		[[nodiscard]] TE_FORCEINLINE const IScriptWorkers &GetScriptWorkers() const
+		{
+			return This()->GetScriptWorkers();
+		}
+
 		[[nodiscard]] TE_FORCEINLINE const IGlobalStorageManager &GetGlobalStorageManager() const
 		{
 			return This()->GetGlobalStorageManager();
@@ -269,6 +276,16 @@ namespace tudov
 			return GetContext().GetScriptProvider();
 		}
 
+		[[nodiscard]] TE_FORCEINLINE IScriptWorkers &GetScriptWorkers() noexcept
+		{
+			return GetContext().GetScriptWorkers();
+		}
+
+		[[nodiscard]] TE_FORCEINLINE const IScriptWorkers &GetScriptWorkers() const noexcept
+		{
+			return GetContext().GetScriptWorkers();
+		}
+
 		[[nodiscard]] TE_FORCEINLINE IGlobalStorageManager &GetGlobalStorageManager() noexcept
 		{
 			return GetContext().GetGlobalStorageManager();
@@ -36,6 +36,7 @@ namespace tudov
 	struct IScriptErrors;
 	struct IScriptLoader;
 	struct IScriptProvider;
+	struct IScriptWorkers;
 
 	class EngineData
 	{
@@ -62,6 +63,7 @@ namespace tudov
 		std::shared_ptr<IScriptErrors> _scriptErrors;
 		std::shared_ptr<IScriptLoader> _scriptLoader;
 		std::shared_ptr<IScriptProvider> _scriptProvider;
+		std::shared_ptr<IScriptWorkers> _scriptWorkers;
 
 	  public:
 		explicit EngineData(Context &context) noexcept;
@@ -0,0 +1,82 @@
+/**
+ * @file Resource/DecodedImageCache.hpp
+ * @author JagYayu
+ * @brief Decoded image surfaces keyed by content hash.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "Data/BlobStore.hpp"
+#include "System/Log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace tudov
+{
+	class GlobalStorage;
+
+	namespace impl
+	{
+		using SDL_Surface = void;
+	}
+
+	/**
+	 * Images with identical contents share one decoded surface. Decoded pixels are also written to a storage
+	 * directory named by content hash, so unchanged images skip decoding on next launch.
+	 * Persisted files are bounded in total size, least recently used ones are removed when storage is set.
+	 */
+	class DecodedImageCache : private ILogProvider
+	{
+	  public:
+		// New images are not persisted once files in directory reach this size.
+		static constexpr std::uint64_t PersistedSizeLimit = 256ull * 1024 * 1024;
+		// Sweeping removes files until this size is left, so new images still fit.
+		static constexpr std::uint64_t PersistedSweepSize = PersistedSizeLimit / 4 * 3;
+
+	  protected:
+		std::unordered_map<BlobHash, std::weak_ptr<impl::SDL_Surface>> _surfaces;
+		GlobalStorage *_storage;
+		std::filesystem::path _directory;
+		std::uint64_t _persistedSize;
+
+	  public:
+		explicit DecodedImageCache() noexcept;
+		explicit DecodedImageCache(const DecodedImageCache &) noexcept = delete;
+		explicit DecodedImageCache(DecodedImageCache &&) noexcept = delete;
+		DecodedImageCache &operator=(const DecodedImageCache &) noexcept = delete;
+		DecodedImageCache &operator=(DecodedImageCache &&) noexcept = delete;
+		~DecodedImageCache() noexcept override = default;
+
+		Log &GetLog() noexcept override;
+
+		/**
+		 * Persist decoded images to `directory` of `storage`, null to keep them in memory only.
+		 */
+		void SetStorage(GlobalStorage *storage, const std::filesystem::path &directory) noexcept;
+
+		/**
+		 * @param[in] hash `BlobStore::Hash` of `bytes` if known already, e.g. bytes of a blob.
+		 * @throw std::runtime_error Failed to decode.
+		 */
+		std::shared_ptr<impl::SDL_Surface> Decode(std::span<const std::byte> bytes, std::optional<BlobHash> hash = std::nullopt);
+
+		void Clear() noexcept;
+
+	  private:
+		std::filesystem::path GetPersistedFile(BlobHash hash) const noexcept;
+		std::shared_ptr<impl::SDL_Surface> ReadPersisted(BlobHash hash) noexcept;
+		void WritePersisted(BlobHash hash, impl::SDL_Surface *surface) noexcept;
+		void SweepPersisted() noexcept;
+	};
+} // namespace tudov
@@ -23,6 +23,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace tudov
@@ -76,11 +77,11 @@ namespace tudov
 
 		TextResources &GetTextResources() noexcept;
 
-		std::tuple<EResourceType, ResourceID> LoadResource(const std::filesystem::path &path, const std::vector<std::byte> &bytes);
+		std::tuple<EResourceType, ResourceID> LoadResource(const std::filesystem::path &path, std::span<const std::byte> bytes);
 
 		EResourceType UnloadResource(const std::filesystem::path &path);
 
-		std::tuple<EResourceType, ResourceID, ResourceID> ReloadResource(const std::filesystem::path &path, const std::vector<std::byte> &bytes);
+		std::tuple<EResourceType, ResourceID, ResourceID> ReloadResource(const std::filesystem::path &path, std::span<const std::byte> bytes);
 
 		const BinariesResources &GetBinariesResources() const noexcept
 		{
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "DecodedImageCache.hpp"
 #include "Resources.hpp"
 #include "Graphic/Image.hpp"
 #include "Util/Definitions.hpp"
@@ -32,6 +33,9 @@ namespace tudov
 	{
 		friend LuaBindings;
 
+	  protected:
+		DecodedImageCache _decodedCache;
+
 	  public:
 		explicit ImageResources() noexcept;
 		explicit ImageResources(const ImageResources &) noexcept = delete;
@@ -40,6 +44,8 @@ namespace tudov
 		ImageResources &operator=(ImageResources &&) noexcept = delete;
 		~ImageResources() noexcept = default;
 
+		DecodedImageCache &GetDecodedCache() noexcept;
+
 		void InstallToScriptEngine(std::string_view name, ScriptEngine &scriptEngine) noexcept;
 		void UninstallFromScriptEngine(std::string_view name, ScriptEngine &scriptEngine) noexcept;
 
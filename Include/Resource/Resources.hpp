@@ -15,6 +15,7 @@
 #include "System/LogMicros.hpp"
 #include "Util/Definitions.hpp"
 
+#include <functional>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -30,9 +31,15 @@ namespace tudov
 			std::shared_ptr<TResource> resource;
 		};
 
+		/**
+		 * Called when looking up a path that is not loaded, e.g. to load a lazily mounted file.
+		 */
+		using Resolver = std::function<void(std::string_view path)>;
+
 	  protected:
 		std::shared_ptr<Log> _log;
 		ResourceID _latestID = 0;
+		Resolver _resolver;
 
 		std::unordered_map<std::string_view, ResourceID> _path2ID;
 		std::unordered_map<ResourceID, Entry> _id2Entry;
@@ -75,8 +82,25 @@ namespace tudov
 
 		inline ResourceID GetResourceID(std::string_view path) const noexcept
 		{
-			auto it = _path2ID.find(path);
-			return it != _path2ID.end() ? it->second : 0;
+			if (auto it = _path2ID.find(path); it != _path2ID.end()) [[likely]]
+			{
+				return it->second;
+			}
+
+			if (_resolver)
+			{
+				_resolver(path);
+
+				auto it = _path2ID.find(path);
+				return it != _path2ID.end() ? it->second : 0;
+			}
+
+			return 0;
+		}
+
+		inline void SetResolver(Resolver resolver) noexcept
+		{
+			_resolver = std::move(resolver);
 		}
 
 		template <typename TDerived = TResource, typename... TArgs>
@@ -130,7 +154,9 @@ namespace tudov
 
 		inline void Unload(std::string_view path) noexcept
 		{
-			Unload(GetResourceID(path));
+			// Not resolving, unloading must never load anything.
+			auto it = _path2ID.find(path);
+			Unload(it != _path2ID.end() ? it->second : 0);
 		}
 
 		inline void UnloadAllFromDirectory(std::string_view directory)
@@ -1,5 +1,5 @@
 /**
- * @file Resource/Scripts/Client.hpp
+ * @file Scripts/Client/Zombie.hpp
  * @author JagYayu
  * @brief
  * @version 1.0
@@ -11,9 +11,20 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace tudov
 {
+	/**
+	 * Plain data of a horde member, kept trivially copyable so zombie pools can be snapshotted as raw memory.
+	 */
 	struct Zombie
 	{
+		float x;
+		float y;
+		float velocityX;
+		float velocityY;
+		float health;
+		std::uint32_t flags;
 	};
-} // namespace tudov
\ No newline at end of file
+} // namespace tudov
@@ -1,5 +1,5 @@
 /**
- * @file Resource/Scripts/Client.hpp
+ * @file Scripts/Client/ZombieManager.hpp
  * @author JagYayu
  * @brief
  * @version 1.0
@@ -9,14 +9,43 @@
  *
  */
 
- #pragma once
+#pragma once
 
 #include "Gameplay/ObjectManager.hpp"
 #include "Scripts/Client/Zombie.hpp"
 
+#include <tuple>
+
 namespace tudov
 {
+	class LuaBindings;
+
 	class ZombieManager : public ObjectManager<Zombie>
 	{
+		friend LuaBindings;
+
+	  public:
+		explicit ZombieManager() noexcept = default;
+		explicit ZombieManager(const ZombieManager &) noexcept = delete;
+		explicit ZombieManager(ZombieManager &&) noexcept = default;
+		ZombieManager &operator=(const ZombieManager &) noexcept = delete;
+		ZombieManager &operator=(ZombieManager &&) noexcept = default;
+		~ZombieManager() noexcept = default;
+
+		/**
+		 * Move all zombies by their velocities.
+		 */
+		void Update(float deltaTime) noexcept;
+
+	  private:
+		ObjectID LuaSpawn(float x, float y, sol::object health);
+		std::tuple<sol::object, sol::object> LuaGetPosition(ObjectID objectID, sol::this_state ts) const noexcept;
+		bool LuaSetPosition(ObjectID objectID, float x, float y) noexcept;
+		std::tuple<sol::object, sol::object> LuaGetVelocity(ObjectID objectID, sol::this_state ts) const noexcept;
+		bool LuaSetVelocity(ObjectID objectID, float velocityX, float velocityY) noexcept;
+		sol::object LuaGetHealth(ObjectID objectID, sol::this_state ts) const noexcept;
+		bool LuaSetHealth(ObjectID objectID, float health) noexcept;
+		sol::object LuaGetFlags(ObjectID objectID, sol::this_state ts) const noexcept;
+		bool LuaSetFlags(ObjectID objectID, std::uint32_t flags) noexcept;
 	};
-} // namespace tudov
\ No newline at end of file
+} // namespace tudov
@@ -0,0 +1,84 @@
+/**
+ * @file Util/FileChangeJournal.hpp
+ * @author JagYayu
+ * @brief Debounced and coalesced file system changes.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace tudov
+{
+	enum class EFileChangeType : int;
+	enum class EPathType : int;
+
+	/**
+	 * Collects changes from file watch threads, changes of same path are merged into their net effect, e.g. added then
+	 * modified is added, added then removed is nothing. Changes are only taken once no change was recorded for a
+	 * whole window, so a burst like saving in an editor or switching git branches comes out as one changeset.
+	 */
+	class FileChangeJournal
+	{
+	  public:
+		struct Change
+		{
+			std::filesystem::path path;
+			EPathType pathType;
+			// Renames are recorded as removed and added.
+			EFileChangeType changeType;
+		};
+
+		/**
+		 * Called on journal thread once changes are settled, and again every window until they are taken.
+		 */
+		using SettledCallback = std::function<void()>;
+
+	  protected:
+		std::chrono::steady_clock::duration _window;
+		SettledCallback _onSettled;
+		// Sorted by path, so changesets are processed in a stable order.
+		std::map<std::filesystem::path, std::tuple<EPathType, EFileChangeType>> _changes;
+		std::chrono::steady_clock::time_point _lastRecordTime;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		std::thread _thread;
+		bool _stopping;
+
+	  public:
+		explicit FileChangeJournal(std::chrono::steady_clock::duration window, SettledCallback onSettled) noexcept;
+		explicit FileChangeJournal(const FileChangeJournal &) noexcept = delete;
+		explicit FileChangeJournal(FileChangeJournal &&) noexcept = delete;
+		FileChangeJournal &operator=(const FileChangeJournal &) noexcept = delete;
+		FileChangeJournal &operator=(FileChangeJournal &&) noexcept = delete;
+		~FileChangeJournal() noexcept;
+
+		/**
+		 * Thread safe.
+		 */
+		void Record(const std::filesystem::path &path, EPathType pathType, EFileChangeType changeType) noexcept;
+
+		/**
+		 * @return Coalesced changes, empty if nothing recorded or changes are still coming.
+		 */
+		std::vector<Change> TakeSettled() noexcept;
+
+		void Clear() noexcept;
+
+	  private:
+		void WorkerMain() noexcept;
+	};
+} // namespace tudov
@@ -0,0 +1,68 @@
+/**
+ * @file Util/FilePattern.hpp
+ * @author JagYayu
+ * @brief Case insensitive file path pattern.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace tudov
+{
+	/**
+	 * Regex pattern matching whole file paths, ignoring case.
+	 * Common forms like ".*\\.lua$", ".*" or plain literals are compiled into string comparisons, others fall back
+	 * to `std::regex`.
+	 */
+	class FilePattern
+	{
+	  public:
+		enum class EKind : std::uint8_t
+		{
+			Any,
+			Exact,
+			Suffix,
+			Regex,
+		};
+
+	  protected:
+		EKind _kind;
+		// Lower case literal of exact and suffix patterns.
+		std::string _literal;
+		std::unique_ptr<std::regex> _regex;
+
+	  public:
+		/**
+		 * @throw std::regex_error Pattern falls back to regex and is invalid.
+		 */
+		explicit FilePattern(std::string_view pattern);
+		explicit FilePattern(const FilePattern &) noexcept = delete;
+		FilePattern(FilePattern &&) noexcept = default;
+		FilePattern &operator=(const FilePattern &) noexcept = delete;
+		FilePattern &operator=(FilePattern &&) noexcept = default;
+		~FilePattern() noexcept = default;
+
+		[[nodiscard]] EKind GetKind() const noexcept;
+		[[nodiscard]] bool Match(std::string_view file) const noexcept;
+
+		[[nodiscard]] static bool MatchAny(std::string_view file, std::span<const FilePattern> patterns) noexcept;
+
+	  private:
+		/**
+		 * Unescape a regex without special characters.
+		 * @return false if `pattern` has unescaped special characters.
+		 */
+		static bool ToLiteral(std::string_view pattern, std::string &literal) noexcept;
+	};
+} // namespace tudov
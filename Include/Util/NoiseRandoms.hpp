@@ -11,7 +11,14 @@
 
 #pragma once
 
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
 #include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace tudov
 {
@@ -77,10 +84,28 @@ namespace tudov
 	{
 		friend LuaBindings;
 
+	  public:
+		static constexpr std::size_t MaxCachedGrids = 8;
+
 	  private:
+		struct CachedGrid
+		{
+			std::int32_t seed;
+			std::float_t frequency;
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t width;
+			std::int32_t height;
+			std::int32_t min;
+			std::int32_t max;
+			std::vector<std::int32_t> values;
+		};
+
 		void *_data;
 		std::int32_t _seed;
 		std::float_t _frequency;
+		// Most recently used at back.
+		std::vector<CachedGrid> _cachedGrids;
 
 	  public:
 		explicit PerlinNoiseRandom() noexcept;
@@ -106,5 +131,30 @@ namespace tudov
 		std::int32_t Int1(std::float_t x, std::int32_t min, std::int32_t max) noexcept override;
 		std::int32_t Int2(std::float_t x, std::float_t y, std::int32_t min, std::int32_t max) noexcept override;
 		std::int32_t Int3(std::float_t x, std::float_t y, std::float_t z, std::int32_t min, std::int32_t max) noexcept override;
+
+		/**
+		 * Sample noise of a rect with 1 unit step into `output` in row major order, stops when `output` is full.
+		 */
+		void FillNoise2(std::span<std::float_t> output, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept;
+		/**
+		 * Same as `Int2` over each tile of a rect, stops when `output` is full.
+		 */
+		void FillInt2(std::span<std::int32_t> output, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max) noexcept;
+		/**
+		 * @param[in] coords Flat coordinates `x1, y1, x2, y2, ...`.
+		 */
+		void SampleNoise2(std::span<const std::float_t> coords, std::span<std::float_t> output) noexcept;
+		void SampleInt2(std::span<const std::float_t> coords, std::span<std::int32_t> output, std::int32_t min, std::int32_t max) noexcept;
+		/**
+		 * Cached result of `FillInt2`, keyed by seed, frequency, rect and range. The span stays valid until
+		 * `MaxCachedGrids` other grids are requested, or seed or frequency changes.
+		 */
+		std::span<const std::int32_t> GetInt2Grid(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max) noexcept;
+
+	  private:
+		sol::table LuaFillNoise2(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, sol::object buffer, sol::this_state ts) noexcept;
+		sol::table LuaFillInt2(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max, sol::object buffer, sol::this_state ts) noexcept;
+		sol::table LuaSampleNoise2(sol::table coords, sol::object buffer, sol::this_state ts) noexcept;
+		sol::table LuaSampleInt2(sol::table coords, std::int32_t min, std::int32_t max, sol::object buffer, sol::this_state ts) noexcept;
 	};
 } // namespace tudov
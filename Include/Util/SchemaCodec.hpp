@@ -0,0 +1,105 @@
+/**
+ * @file Util/SchemaCodec.hpp
+ * @author JagYayu
+ * @brief Schema compiled binary codec for lua tables.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#pragma once
+
+#include "sol/forward.hpp"
+#include "sol/object.hpp"
+#include "sol/table.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tudov
+{
+	class LuaBindings;
+
+	/**
+	 * Encodes lua tables with known fields in a fixed layout, field names are never written.
+	 *
+	 * Schemas are compiled from tables of default values, field kinds are taken from default values. Each record
+	 * starts with 2 bits per field packed together, telling whether the field is nil, holds a value of its schema kind
+	 * (booleans are stored in these bits directly), or holds something else. Integers are zigzag varints, other
+	 * numbers are doubles. Values not matching their schema kind and keys missing from schema are still encoded with
+	 * type tags, so any record survives a round trip. Tagged tables are written array part first then keys in sorted
+	 * order, so equal records encode to equal bytes on every peer.
+	 */
+	class SchemaCodec
+	{
+		friend LuaBindings;
+
+	  public:
+		using SchemaID = std::uint32_t;
+
+		static constexpr std::uint8_t FormatVersion = 1;
+		static constexpr std::size_t MaxDepth = 32;
+
+		enum class EFieldKind : std::uint8_t
+		{
+			Any = 0,
+			Boolean,
+			Number,
+			String,
+		};
+
+		struct Field
+		{
+			std::string key;
+			EFieldKind kind;
+		};
+
+		struct Schema
+		{
+			// Sorted by key.
+			std::vector<Field> fields;
+			std::unordered_map<std::string, std::size_t> indices;
+		};
+
+	  protected:
+		std::unordered_map<SchemaID, Schema> _schemas;
+
+	  public:
+		explicit SchemaCodec() noexcept = default;
+		explicit SchemaCodec(const SchemaCodec &) noexcept = delete;
+		explicit SchemaCodec(SchemaCodec &&) noexcept = default;
+		SchemaCodec &operator=(const SchemaCodec &) noexcept = delete;
+		SchemaCodec &operator=(SchemaCodec &&) noexcept = default;
+		~SchemaCodec() noexcept = default;
+
+		/**
+		 * Compile schema from default values, string keys only, other keys are encoded as extra fields.
+		 */
+		void Compile(SchemaID schemaID, sol::table defaults) noexcept;
+		[[nodiscard]] bool HasSchema(SchemaID schemaID) const noexcept;
+		[[nodiscard]] const Schema *GetSchema(SchemaID schemaID) const noexcept;
+		void Clear() noexcept;
+
+		/**
+		 * @throw std::runtime_error Schema not found, or record contains values that can not be encoded.
+		 */
+		std::string Encode(SchemaID schemaID, sol::table record) const;
+		/**
+		 * Encode a list of records sharing one schema.
+		 */
+		std::string EncodeList(SchemaID schemaID, sol::table records) const;
+
+		/**
+		 * @throw std::runtime_error Schema not found, or data is corrupted.
+		 */
+		sol::table Decode(SchemaID schemaID, const std::string &data, sol::this_state ts) const;
+		sol::table DecodeList(SchemaID schemaID, const std::string &data, sol::this_state ts) const;
+
+	  private:
+		const Schema &GetSchemaOrThrow(SchemaID schemaID) const;
+	};
+} // namespace tudov
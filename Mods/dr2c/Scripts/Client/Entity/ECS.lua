@@ -9,7 +9,6 @@
 --
 --]]
 
-local List = require("TE.List")
 local Table = require("TE.Table")
 local String = require("TE.String")
 
@@ -28,7 +27,9 @@ local CEntityECSSchema_getEntityTypeID = CEntityECSSchema.getEntityTypeID
 local String_bufferDecode = String.bufferDecode
 local assert = assert
 local ipairs = ipairs
+local math_floor = math.floor
 local setmetatable = setmetatable
+local table_concat = table.concat
 local type = type
 
 --- @class dr2c.EntityECS
@@ -36,21 +37,14 @@ local CEntityECS = {}
 
 --- @class dr2c.EntityID : integer
 
---- @class dr2c.Entity
---- @field [1] dr2c.EntityID
---- @field [2] dr2c.EntityTypeID
-
-local entityFieldID = 1
-local entityFieldTypeID = 2
-
---- @type dr2c.Entity[]
-local entities = {}
---- @type table<dr2c.EntityID, dr2c.Entity>
-local entitiesID2EntityMap = {}
---- @type dr2c.EntityID
-local entitiesLatestID = 0
---- @type boolean
-local entitiesSorted = true
+--- Entities and their per-entity components are stored in a native archetype registry, entities of the same type are
+--- packed in dense rows and every per-entity component has its own column.
+--- @type TE.EntityRegistry
+local registry = EntityRegistry()
+--- Per-entity serializable component columns are encoded with layouts compiled from component schemas, instead of
+--- self-describing buffers carrying every field name.
+--- @type TE.SchemaCodec
+local schemaCodec = SchemaCodec()
 --- @type table
 local entitiesOperations = {}
 
@@ -59,22 +53,18 @@ local entitiesOperations = {}
 --- @class dr2c.ComponentPoolTypeBased
 --- @field [dr2c.EntityType] dr2c.Component
 
---- @class dr2c.ComponentPoolIDBased
---- @field [dr2c.EntityTypeID] dr2c.Component
-
 --- @class dr2c.EntityFilterKey : string
 
 --- @class dr2c.EntityFilter
 --- @field key string
+--- @field requires (dr2c.ComponentType | dr2c.ComponentTypeID)[]
+--- @field excludes (dr2c.ComponentType | dr2c.ComponentTypeID)[]
+--- @field entityTypeIDs dr2c.EntityTypeID[] Entity types that match this filter, refreshed on schema load.
 
 --- @class dr2c.EntityFilters
 --- @field [integer] dr2c.EntityFilter
 --- @field [string] dr2c.EntityFilter
 
---- @class dr2c.EntityIterationState
---- @field [1] dr2c.EntityFilter
---- @field [2] integer
-
 --- @class dr2c.ECSSerialTable
 
 --- @type table<dr2c.ComponentTypeID, dr2c.ComponentPoolTypeBased>
@@ -83,51 +73,69 @@ local componentsPoolArchetypeConstant = {}
 local componentsPoolArchetypeSerializable = {}
 --- @type table<dr2c.ComponentTypeID, dr2c.ComponentPoolTypeBased>
 local componentsPoolArchetypeTransient = {}
---- @type table<dr2c.ComponentTypeID, dr2c.ComponentPoolIDBased>
-local componentsPoolEntitySerializable = {}
---- @type table<dr2c.ComponentTypeID, dr2c.ComponentPoolIDBased>
-local componentsPoolEntityTransient = {}
+
+--- Component type ids whose trait is `EntitySerializable`, built from schema on demand.
+--- @type table<dr2c.ComponentTypeID, true>?
+local entitySerializableComponents
 
 --- @type dr2c.EntityFilters
 local entityFilters = {}
 --- @type table<dr2c.EntityFilter, table>
 local entityFilterValidations = setmetatable({}, { __mode = "k" })
---- @type table<dr2c.EntityFilter, fun(entityTypeID: dr2c.EntityTypeID): boolean>
-local entityFilterCheckFunctions = setmetatable({}, { __mode = "k" })
 
 --- @type boolean
 local isIteratingEntities = false
 
-entities = persist("entities", function()
+--- Entity ids per entity type copied from registry, iterations index these instead of calling into registry per entity.
+--- Copies are refilled on demand after any registry operation that moves rows.
+--- @type table<dr2c.EntityTypeID, dr2c.EntityID[]>
+local entitiesByType = {}
+--- @type table<dr2c.EntityTypeID, true>
+local entitiesByTypeFilled = {}
+
+--- @param entityTypeID dr2c.EntityTypeID
+--- @return dr2c.EntityID[]
+local function getEntitiesByType(entityTypeID)
+	local entities = entitiesByType[entityTypeID]
+	if not entitiesByTypeFilled[entityTypeID] then
+		if not entities then
+			entities = {}
+			entitiesByType[entityTypeID] = entities
+		end
+
+		registry:fillEntities(entityTypeID, entities)
+		entitiesByTypeFilled[entityTypeID] = true
+	end
 	return entities
+end
+
+local function invalidateEntitiesByType()
+	for entityTypeID in pairs(entitiesByTypeFilled) do
+		entitiesByTypeFilled[entityTypeID] = nil
+	end
+end
+
+--- Iteration index packs position in `entityFilter.entityTypeIDs` (or entity type id) and row:
+--- `position * iterationStride + row`.
+local iterationStride = 2 ^ 32
+
+registry = persist("registry", function()
+	return registry
 end)
-entitiesID2EntityMap = persist("entitiesID2EntityMap", function()
-	return entitiesID2EntityMap
-end)
-entitiesLatestID = persist("entitiesLatestID", function()
-	return entitiesLatestID
-end)
-entitiesSorted = persist("entitiesSorted", function()
-	return entitiesSorted
+schemaCodec = persist("schemaCodec", function()
+	return schemaCodec
 end)
 entitiesOperations = persist("entitiesOperations", function()
 	return entitiesOperations
 end)
-componentsPoolArchetypeConstant = persist("componentsPoolArchetypeConstant", function()
-	return componentsPoolArchetypeConstant
+entityFilters = persist("entityFilters", function()
+	return entityFilters
 end)
+componentsPoolArchetypeConstant = persist("componentsPoolArchetypeConstant", componentsPoolArchetypeConstant)
 componentsPoolArchetypeSerializable = persist("componentsPoolArchetypeSerializable", function()
 	return componentsPoolArchetypeSerializable
 end)
-componentsPoolArchetypeTransient = persist("componentsPoolArchetypeTransient", function()
-	return componentsPoolArchetypeTransient
-end)
-componentsPoolEntitySerializable = persist("componentsPoolEntitySerializable", function()
-	return componentsPoolEntitySerializable
-end)
-componentsPoolEntityTransient = persist("componentsPoolEntityTransient", function()
-	return componentsPoolEntityTransient
-end)
+componentsPoolArchetypeTransient = persist("componentsPoolArchetypeTransient", componentsPoolArchetypeTransient)
 
 CEntityECS.eventEntitySpawned = TE.events:new(N_("CEntitySpawn"), {
 	"", -- TODO
@@ -137,50 +145,22 @@ CEntityECS.eventEntityDespawned = TE.events:new(N_("CEntityDespawn"), {
 	"", -- TODO
 })
 
-local function newIDBasedComponentPool()
-	return {}
-end
-
---- @param l dr2c.Entity
---- @param r dr2c.Entity
---- @nodiscard
-local function compareEntityInstance(l, r)
-	if l[entityFieldTypeID] ~= r[entityFieldTypeID] then
-		return l[entityFieldTypeID] < r[entityFieldTypeID]
-	else
-		return l[entityFieldID] < r[entityFieldID]
-	end
-end
-
---- @return dr2c.Entity[]
-local function sortAndGetEntities()
-	if not entitiesSorted then
-		table.sort(entities, compareEntityInstance)
-		entitiesSorted = true
-	end
-
-	return entities
-end
-
 --- @param entityID dr2c.EntityID
 --- @return boolean
 --- @nodiscard
 function CEntityECS.entityExists(entityID)
-	return not not entitiesID2EntityMap[entityID]
+	return registry:exists(entityID)
 end
 
 --- @param entityTypeID dr2c.EntityTypeID
 --- @return dr2c.EntityID
 function CEntityECS.spawnEntityByID(entityTypeID, components, ...)
-	local entityID = entitiesLatestID + 1
-	entitiesLatestID = entityID
+	local entityID = registry:reserve()
 
 	entitiesOperations[#entitiesOperations + 1] = {
 		operation = "spawn",
-		entity = {
-			entityID,
-			entityTypeID,
-		},
+		entityID = entityID,
+		entityTypeID = entityTypeID,
 		components = components,
 		...,
 	}
@@ -202,7 +182,7 @@ end
 --- @param entityID dr2c.EntityID
 --- @return boolean
 function CEntityECS.despawnEntity(entityID, ...)
-	if not entitiesID2EntityMap[entityID] then
+	if not registry:exists(entityID) then
 		return false
 	end
 
@@ -220,7 +200,7 @@ end
 --- @param ... unknown
 --- @return boolean
 function CEntityECS.convertEntityByID(entityID, entityTypeID, ...)
-	if entitiesID2EntityMap[entityID][entityFieldTypeID] == entityTypeID then
+	if registry:getTypeID(entityID) == entityTypeID then
 		return false
 	end
 
@@ -244,26 +224,42 @@ function CEntityECS.convertEntity(entityID, entityType, ...)
 	return entityTypeID and CEntityECS_convertEntityByID(entityID, entityType, ...) or false
 end
 
-local function spawnEntityImpl(entry)
-	local entity = entry.entity
-	local entityID = entity[entityFieldID]
-	local entityTypeID = entity[entityFieldTypeID]
-
-	assert(entityID == #entities + 1)
+--- Decode default values of per-entity components that an entity does not have yet.
+--- @param entityID dr2c.EntityID
+--- @param entityTypeID dr2c.EntityTypeID
+local function fillEntityComponents(entityID, entityTypeID)
+	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntityTransient(entityTypeID))) do
+		local componentTypeID = component.componentSchema.typeID
+		if registry:getComponent(entityID, componentTypeID) == nil then
+			registry:setComponent(entityID, componentTypeID, String_bufferDecode(component.mergedFieldsBuffer))
+		end
+	end
 
-	entities[entityID] = entity
-	entitiesID2EntityMap[entityID] = entity
-	entitiesSorted = false
+	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntitySerializable(entityTypeID))) do
+		local componentTypeID = component.componentSchema.typeID
+		if registry:getComponent(entityID, componentTypeID) == nil then
+			registry:setComponent(entityID, componentTypeID, String_bufferDecode(component.mergedFieldsBuffer))
+		end
+	end
+end
 
-	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntityTransient(entity[2]))) do
-		componentsPoolEntityTransient[component.componentSchema.typeID][entityID] =
-			String_bufferDecode(component.mergedFieldsBuffer)
+--- @param entityTypeID dr2c.EntityTypeID
+local function fillEntitiesComponents(entityTypeID)
+	for _, entityID in ipairs(getEntitiesByType(entityTypeID)) do
+		fillEntityComponents(entityID, entityTypeID)
 	end
+end
+
+local function spawnEntityImpl(entry)
+	local entityID = entry.entityID
+	local entityTypeID = entry.entityTypeID
 
-	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntitySerializable(entity[2]))) do
-		componentsPoolEntitySerializable[component.componentSchema.typeID][entityID] =
-			String_bufferDecode(component.mergedFieldsBuffer)
+	if not registry:commit(entityID, entityTypeID) then
+		return
 	end
+	invalidateEntitiesByType()
+
+	fillEntityComponents(entityID, entityTypeID)
 
 	if type(entry.components) == "table" then
 		-- TODO
@@ -284,31 +280,14 @@ local function spawnEntityImpl(entry)
 	TE.events:invoke(CEntityECS.eventEntitySpawned, e)
 end
 
-local function isEntityIDMatched(entity, entityID)
-	return entity[entityFieldID] == entityID
-end
-
 local function despawnEntityImpl(entry)
-	local entity = entry.entity
-	local entityID = entity[entityFieldID]
-	local entityTypeID = entity[entityFieldTypeID]
+	local entityID = entry.entityID
+	local entityTypeID = registry:getTypeID(entityID)
 
-	local index = List.findLastIfV(entities, isEntityIDMatched, entityID)
-	if not index then
+	if not entityTypeID or not registry:despawn(entityID) then
 		return
 	end
-
-	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntityTransient(entity[2]))) do
-		componentsPoolEntityTransient[component.componentSchema.typeID][entityID] = nil
-	end
-
-	for _, component in ipairs(assert(CEntityECSSchema.getEntityComponentsEntitySerializable(entity[2]))) do
-		componentsPoolEntitySerializable[component.componentSchema.typeID][entityID] = nil
-	end
-
-	entities[index] = entities[#entities]
-	entities[#entities] = nil
-	entitiesSorted = false
+	invalidateEntitiesByType()
 
 	--- @class dr2c.E.EntityDespawned
 	local e = {
@@ -331,12 +310,6 @@ function CEntityECS.update()
 		error("Attempt to update ECS while iterating entities", 2)
 	end
 
-	-- print("componentsPoolArchetypeConstant", componentsPoolArchetypeConstant)
-	-- print("componentsPoolArchetypeSerializable", componentsPoolArchetypeSerializable)
-	-- print("componentsPoolArchetypeTransient", componentsPoolArchetypeTransient)
-	-- print("componentsPoolEntitySerializable", componentsPoolEntitySerializable)
-	-- print("componentsPoolEntityTransient", componentsPoolEntityTransient)
-
 	if entitiesOperations[1] then
 		for _, entry in ipairs(entitiesOperations) do
 			if entry.operation == "spawn" then
@@ -358,22 +331,22 @@ function CEntityECS.update()
 	end
 end
 
+local function getEntityComponentByID(entityID, componentTypeID)
+	return registry:getComponent(entityID, componentTypeID)
+end
+
 local getComponentByIDHandles = {
 	[CEntityECSSchema_ComponentTrait_ArchetypeConstant] = function(entityID, componentTypeID)
-		return componentsPoolArchetypeConstant[componentTypeID][entitiesID2EntityMap[entityID][2]]
+		return componentsPoolArchetypeConstant[componentTypeID][registry:getTypeID(entityID)]
 	end,
 	[CEntityECSSchema_ComponentTrait_ArchetypeSerializable] = function(entityID, componentTypeID)
-		return componentsPoolArchetypeSerializable[componentTypeID][entitiesID2EntityMap[entityID][2]]
+		return componentsPoolArchetypeSerializable[componentTypeID][registry:getTypeID(entityID)]
 	end,
 	[CEntityECSSchema_ComponentTrait_ArchetypeTransient] = function(entityID, componentTypeID)
-		return componentsPoolArchetypeTransient[componentTypeID][entitiesID2EntityMap[entityID][2]]
-	end,
-	[CEntityECSSchema_ComponentTrait_EntityTransient] = function(entityID, componentTypeID)
-		return componentsPoolEntityTransient[componentTypeID][entityID]
-	end,
-	[CEntityECSSchema_ComponentTrait_EntitySerializable] = function(entityID, componentTypeID)
-		return componentsPoolEntitySerializable[componentTypeID][entityID]
+		return componentsPoolArchetypeTransient[componentTypeID][registry:getTypeID(entityID)]
 	end,
+	[CEntityECSSchema_ComponentTrait_EntityTransient] = getEntityComponentByID,
+	[CEntityECSSchema_ComponentTrait_EntitySerializable] = getEntityComponentByID,
 }
 
 --- Get an entity's component by component type id.
@@ -409,15 +382,36 @@ function CEntityECS.getComponent(entityID, componentType)
 	end
 end
 
+--- @param entityFilter dr2c.EntityFilter
+local function updateEntityFilter(entityFilter)
+	local requires = entityFilter.requires
+	local excludes = entityFilter.excludes
+	local entityTypeIDs = {}
+
+	for entityTypeID = 1, CEntityECSSchema.getEntitiesCount() do
+		if
+			CEntityECSSchema_entityHasAllComponents(entityTypeID, requires)
+			and CEntityECSSchema_entityHasNonComponents(entityTypeID, excludes)
+		then
+			entityTypeIDs[#entityTypeIDs + 1] = entityTypeID
+		end
+	end
+
+	entityFilter.entityTypeIDs = entityTypeIDs
+end
+
 --- @param key string
 --- @param requires (dr2c.ComponentType | dr2c.ComponentTypeID)[]
 --- @param excludes (dr2c.ComponentType | dr2c.ComponentTypeID)[]
 --- @return dr2c.EntityFilter
 local function createEntityFilter(key, requires, excludes)
 	--- @class dr2c.EntityFilter
-	local entityFilter = {}
-
-	entityFilter.key = key
+	local entityFilter = {
+		key = key,
+		requires = requires,
+		excludes = excludes,
+		entityTypeIDs = {},
+	}
 
 	if log.canWarn() then
 		entityFilterValidations[entityFilter] = {
@@ -427,49 +421,36 @@ local function createEntityFilter(key, requires, excludes)
 		}
 	end
 
-	--- @type boolean[]
-	local filterEntityTypeIDCache = Table.new(CEntityECSSchema.getComponentsCount(), 0)
-
-	--- @param entityTypeID dr2c.EntityTypeID
-	--- @return boolean
-	entityFilterCheckFunctions[entityFilter] = function(entityTypeID)
-		local result = filterEntityTypeIDCache[entityTypeID]
-
-		if result == nil then
-			result = not not (
-				CEntityECSSchema_entityHasAllComponents(entityTypeID, requires)
-				and CEntityECSSchema_entityHasNonComponents(entityTypeID, excludes)
-			)
-			filterEntityTypeIDCache[entityTypeID] = result
-		end --- @cast result boolean
-
-		return result
-	end
+	updateEntityFilter(entityFilter)
 
 	return entityFilter
 end
 
+local emptyComponents = {}
+
+--- Filters are cached by their components, calling this function multiple times with same components returns the same
+--- filter, but it's still recommended to create filters once and store them in upvalues.
 --- @param requiredComponents (dr2c.ComponentType | dr2c.ComponentTypeID)[]?
 --- @param excludedComponents (dr2c.ComponentType | dr2c.ComponentTypeID)[]?
 --- @return dr2c.EntityFilter
 function CEntityECS.filter(requiredComponents, excludedComponents)
-	requiredComponents = requiredComponents or {}
-	excludedComponents = excludedComponents or {}
-
-	local requires = Table.new(#requiredComponents, 0)
-	local excludes = Table.new(#excludedComponents, 0)
-	for i, requiredComponent in ipairs(requiredComponents) do
-		requires[i] = requiredComponent
-	end
-	for i, excludedComponent in ipairs(excludedComponents) do
-		excludes[i] = excludedComponent
-	end
+	requiredComponents = requiredComponents or emptyComponents
+	excludedComponents = excludedComponents or emptyComponents
 
 	--- @type dr2c.EntityFilterKey
-	local key = String.bufferEncode({ requires, "|", excludes })
+	local key = table_concat(requiredComponents, ",") .. "|" .. table_concat(excludedComponents, ",")
 	local entityFilter = entityFilters[key]
 
 	if not entityFilter then
+		local requires = Table.new(#requiredComponents, 0)
+		local excludes = Table.new(#excludedComponents, 0)
+		for i, requiredComponent in ipairs(requiredComponents) do
+			requires[i] = requiredComponent
+		end
+		for i, excludedComponent in ipairs(excludedComponents) do
+			excludes[i] = excludedComponent
+		end
+
 		entityFilter = createEntityFilter(key, requires, excludes)
 
 		entityFilters[#entityFilters + 1] = entityFilter
@@ -485,16 +466,21 @@ end
 --- @return dr2c.EntityID id
 --- @return dr2c.EntityTypeID typeID
 local function entitiesIterator(entityFilter, index)
-	local check = entityFilterCheckFunctions[entityFilter]
+	local entityTypeIDs = entityFilter.entityTypeIDs
 
-	local entity = entities[index]
-	while entity do
-		if check(entity[2]) then
-			return index + 1, entity[entityFieldID], entity[entityFieldTypeID]
-		else
-			index = index + 1
-			entity = entities[index]
+	local position = math_floor(index / iterationStride)
+	local row = index % iterationStride
+	local entityTypeID = entityTypeIDs[position]
+
+	while entityTypeID do
+		local entityID = getEntitiesByType(entityTypeID)[row]
+		if entityID then
+			return position * iterationStride + row + 1, entityID, entityTypeID
 		end
+
+		position = position + 1
+		row = 1
+		entityTypeID = entityTypeIDs[position]
 	end
 
 	isIteratingEntities = false
@@ -509,9 +495,8 @@ end
 --- @return integer index
 --- @nodiscard
 function CEntityECS.iterateEntities(entityFilter)
-	sortAndGetEntities()
 	isIteratingEntities = true
-	return entitiesIterator, entityFilter, 1
+	return entitiesIterator, entityFilter, iterationStride + 1
 end
 
 --- @param entityTypeOrID dr2c.EntityTypeOrID
@@ -536,14 +521,9 @@ end
 --- @return integer? index
 --- @return dr2c.EntityID id
 local function entitiesTypedIterator(entityTypeID, index)
-	local entity = entities[index]
-	while entity do
-		if entity[entityFieldTypeID] == entityTypeID then
-			return index + 1, entity[entityFieldID]
-		else
-			index = index + 1
-			entity = entities[index]
-		end
+	local entityID = getEntitiesByType(entityTypeID)[index]
+	if entityID then
+		return index + 1, entityID
 	end
 
 	isIteratingEntities = false
@@ -556,7 +536,6 @@ end
 --- @return dr2c.EntityTypeID
 --- @nodiscard
 function CEntityECS.iterateEntitiesByType(entityTypeOrID)
-	sortAndGetEntities()
 	isIteratingEntities = true
 	return entitiesTypedIterator, toEntityTypeID(entityTypeOrID), 1
 end
@@ -564,20 +543,17 @@ end
 --- @return integer count
 --- @nodiscard
 function CEntityECS.countTotal()
-	return #entities
+	return registry:count()
 end
 
---- Iterate over entities and return the entity counts.
+--- Return counts of entities that match the given filter.
 --- @param entityFilter dr2c.EntityFilter
 --- @nodiscard
 function CEntityECS.countEntities(entityFilter)
 	local counter = 0
-	local check = entityFilterCheckFunctions[entityFilter]
 
-	for _, entity in ipairs(sortAndGetEntities()) do
-		if check(entity[2]) then
-			counter = counter + 1
-		end
+	for _, entityTypeID in ipairs(entityFilter.entityTypeIDs) do
+		counter = counter + registry:countByType(entityTypeID)
 	end
 
 	return counter
@@ -587,16 +563,7 @@ end
 --- @return integer
 --- @nodiscard
 function CEntityECS.countEntitiesByType(entityTypeOrID)
-	local counter = 0
-	local entityTypeID = toEntityTypeID(entityTypeOrID)
-
-	for _, entity in ipairs(sortAndGetEntities()) do
-		if entity[2] == entityTypeID then
-			counter = counter + 1
-		end
-	end
-
-	return counter
+	return registry:countByType(toEntityTypeID(entityTypeOrID))
 end
 
 --- @param entitySchemaField string
@@ -617,10 +584,8 @@ local function newTypeBasedComponentPool(entitySchemaField)
 end
 
 function CEntityECS.clearEntities()
-	entities = {}
-	entitiesID2EntityMap = {}
-	entitiesLatestID = 0
-	entitiesSorted = true
+	registry:clear()
+	invalidateEntitiesByType()
 	entitiesOperations = {}
 
 	for typeID in pairs(componentsPoolArchetypeSerializable) do
@@ -629,12 +594,40 @@ function CEntityECS.clearEntities()
 	for typeID in pairs(componentsPoolArchetypeTransient) do
 		componentsPoolArchetypeTransient[typeID] = newTypeBasedComponentPool("componentsArchetypeTransient")
 	end
-	for typeID in pairs(componentsPoolEntitySerializable) do
-		componentsPoolEntitySerializable[typeID] = newIDBasedComponentPool()
+end
+
+--- @return table<dr2c.ComponentTypeID, true>
+local function getEntitySerializableComponents()
+	if not entitySerializableComponents then
+		entitySerializableComponents = {}
+
+		for componentTypeID, componentSchema in ipairs(CEntityECSSchema.getComponentsSchema()) do
+			if componentSchema.trait == CEntityECSSchema_ComponentTrait_EntitySerializable then
+				entitySerializableComponents[componentTypeID] = true
+			end
+		end
 	end
-	for typeID in pairs(componentsPoolEntityTransient) do
-		componentsPoolEntityTransient[typeID] = newIDBasedComponentPool()
+
+	return entitySerializableComponents
+end
+
+--- Replace component columns of serialized registry with encoded strings, or the reverse.
+--- @param registryData table
+--- @param encode boolean
+local function transcodeRegistryColumns(registryData, encode)
+	for _, archetypeData in pairs(registryData.archetypes) do
+		for componentTypeID, column in pairs(archetypeData) do
+			if type(componentTypeID) ~= "number" or not schemaCodec:hasSchema(componentTypeID) then
+				-- Not a component column, or component was removed.
+			elseif encode then
+				archetypeData[componentTypeID] = schemaCodec:encodeList(componentTypeID, column)
+			elseif type(column) == "string" then
+				archetypeData[componentTypeID] = schemaCodec:decodeList(componentTypeID, column)
+			end
+		end
 	end
+
+	return registryData
 end
 
 --- @return dr2c.ECSSerialTable
@@ -643,24 +636,22 @@ function CEntityECS.getSerialTable()
 	CEntityECS.update()
 
 	return {
-		sortAndGetEntities(),
-		entitiesLatestID,
-		componentsPoolEntitySerializable,
+		transcodeRegistryColumns(registry:serialize(getEntitySerializableComponents()), true),
 		componentsPoolArchetypeSerializable,
 	}
 end
 
 --- @param data dr2c.ECSSerialTable
 function CEntityECS.setSerialTable(data)
-	entities = data[1]
-	entitiesLatestID = data[2]
-	componentsPoolEntitySerializable = data[3]
-	componentsPoolArchetypeSerializable = data[4]
+	registry:deserialize(transcodeRegistryColumns(data[1], false))
+	invalidateEntitiesByType()
+	-- Pending operations reference slots of the replaced registry.
+	entitiesOperations = {}
+	componentsPoolArchetypeSerializable = data[2]
 
-	entitiesSorted = true
-	entitiesID2EntityMap = {}
-	for _, entity in ipairs(entities) do
-		entitiesID2EntityMap[entity[entityFieldID]] = entity
+	-- Transient components are not serialized, give them default values.
+	for entityTypeID = 1, registry:getMaxTypeID() do
+		fillEntitiesComponents(entityTypeID)
 	end
 end
 
@@ -686,14 +677,6 @@ local componentTrait2Utility = {
 			return newTypeBasedComponentPool("componentsArchetypeTransient")
 		end,
 	},
-	[CEntityECSSchema_ComponentTrait_EntitySerializable] = {
-		componentsPoolEntitySerializable,
-		newIDBasedComponentPool,
-	},
-	[CEntityECSSchema_ComponentTrait_EntityTransient] = {
-		componentsPoolEntityTransient,
-		newIDBasedComponentPool,
-	},
 }
 
 --#region Events
@@ -743,19 +726,40 @@ TE.events:add(N_("CEntitySchemaLoaded"), function(e)
 	removeComponentPoolIfNotExists(componentsPoolArchetypeConstant)
 	removeComponentPoolIfNotExists(componentsPoolArchetypeSerializable)
 	removeComponentPoolIfNotExists(componentsPoolArchetypeTransient)
-	removeComponentPoolIfNotExists(componentsPoolEntityTransient)
-	removeComponentPoolIfNotExists(componentsPoolEntitySerializable)
 
 	for componentTypeID, componentSchema in ipairs(componentsSchema) do
-		local trait = componentSchema.trait
-		if trait then
-			local utility = componentTrait2Utility[trait]
+		local utility = componentTrait2Utility[componentSchema.trait]
+		if utility then
 			local pool = utility[utilityFieldPool]
-			--- @diagnostic disable-next-line: need-check-nil
 			pool[componentTypeID] = pool[componentTypeID] or utility[utilityFieldNewPool]()
 		end
 	end
 
+	entitySerializableComponents = nil
+
+	schemaCodec:clear()
+	for componentTypeID, componentSchema in ipairs(componentsSchema) do
+		schemaCodec:compile(componentTypeID, componentSchema.fields)
+	end
+
+	for entityTypeID, entitySchema in ipairs(CEntityECSSchema.getEntitiesSchema()) do
+		local componentTypeIDs = {}
+		for _, component in ipairs(entitySchema.componentsEntityTransient) do
+			componentTypeIDs[#componentTypeIDs + 1] = component.componentSchema.typeID
+		end
+		for _, component in ipairs(entitySchema.componentsEntitySerializable) do
+			componentTypeIDs[#componentTypeIDs + 1] = component.componentSchema.typeID
+		end
+
+		registry:registerArchetype(entityTypeID, componentTypeIDs)
+		invalidateEntitiesByType()
+		fillEntitiesComponents(entityTypeID)
+	end
+
+	for _, entityFilter in ipairs(entityFilters) do
+		updateEntityFilter(entityFilter)
+	end
+
 	if not entityFilters[1] or not log.canWarn() then
 		return
 	end
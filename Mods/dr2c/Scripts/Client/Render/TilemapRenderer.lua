@@ -9,6 +9,8 @@
 --
 --]]
 
+local FFI = require("TE.FFI")
+
 local CEntityECS = require("dr2c.Client.Entity.ECS")
 local CRenderFocus = require("dr2c.Client.Render.Focus")
 local CWorldScenes = require("dr2c.Client.World.Scenes")
@@ -17,15 +19,31 @@ local CRenderSprites = require("dr2c.Client.Render.Sprites")
 local CTileMap = require("dr2c.Client.Tile.Map")
 local CTileSchema = require("dr2c.Client.Tile.Schema")
 
+local bit_band = bit.band
+local FFI_drawRect = FFI.drawRect
 local CRenderSprites_getSpriteTable = CRenderSprites.getSpriteTable
-local CTileMap_getTileInfoAt = CTileMap.getTileInfoAt
-local CTileMap_getTileTagAt = CTileMap.getTileTagAt
+local CTileSchema_getTypeInfo = CTileSchema.getTypeInfo
 local CTileSchema_Tag_Floor = CTileSchema.Tag.Floor
 local CTileSchema_Tag_Wall = CTileSchema.Tag.Wall
 
---- @type TE.NoiseRandom
+--- @type TE.PerlinNoiseRandom
 local noiseRandom
 
+--- Sprite variants of current tile map, sampled from `noiseRandom` once per map bounds instead of per tile per frame.
+--- @type integer[]
+local floorVariants = {}
+--- @type integer[]
+local wallVariants = {}
+local variantsX, variantsY, variantsWidth, variantsHeight
+
+--- @param variants integer[]
+--- @param tx integer
+--- @param ty integer
+--- @return integer
+local function getVariant(variants, tx, ty)
+	return variants[(ty - variantsY) * variantsWidth + (tx - variantsX) + 1]
+end
+
 local tileSize = 16
 local ceilSize = 8
 local halfTileSize = tileSize * 0.5
@@ -36,102 +54,67 @@ local halfTileSize = tileSize * 0.5
 local function getFloorSpriteTable(tx, ty, info)
 	local sprite = info.sprite
 	if sprite then
-		return CRenderSprites_getSpriteTable(sprite, noiseRandom:int2(tx, ty, 1, 4))
+		return CRenderSprites_getSpriteTable(sprite, getVariant(floorVariants, tx, ty))
 	end
 end
 
 --- @param renderer TE.Renderer
---- @param args TE.DrawRectArgs
 --- @param tx integer
 --- @param ty integer
 --- @param info dr2c.TileInfo
-local function drawTileFloor(renderer, args, tileMap, tx, ty, info)
+local function drawTileFloor(renderer, tileMap, tx, ty, info)
 	local spriteTable = getFloorSpriteTable(tx, ty, info)
 	if not spriteTable then
 		return
 	end
 
-	local argsSrc = args.source
-	local argsDst = args.destination
-
-	args.texture = spriteTable[0]
-	argsSrc.x = spriteTable[1]
-	argsSrc.y = spriteTable[2]
-	argsSrc.w = spriteTable[3]
-	argsSrc.h = spriteTable[4]
-	argsDst.x = (tx - 1) * tileSize
-	argsDst.y = (ty - 1) * tileSize
-	argsDst.w = tileSize
-	argsDst.h = tileSize
-
-	renderer:drawRect(args)
+	FFI_drawRect(renderer, spriteTable[0], (tx - 1) * tileSize, (ty - 1) * tileSize, tileSize, tileSize, spriteTable[1], spriteTable[2], spriteTable[3], spriteTable[4])
 end
 
 --- @param renderer TE.Renderer
---- @param args TE.DrawRectArgs
---- @param tileMap dr2c.TileMap
+--- @param tileMap TE.TileMap
 --- @param tx integer
 --- @param ty integer
 --- @param info dr2c.TileInfo
-local function drawTileFloorLeftPart(renderer, args, tileMap, tx, ty, info)
+local function drawTileFloorLeftPart(renderer, tileMap, tx, ty, info)
 	local spriteTable = getFloorSpriteTable(tx, ty, info)
 	if not spriteTable then
 		return
 	end
 
-	local argsSrc = args.source
-	local argsDst = args.destination
-
-	args.texture = spriteTable[0]
-	argsSrc.x = spriteTable[1]
-	argsSrc.y = spriteTable[2]
-	argsSrc.w = spriteTable[3] * 0.5
-	argsSrc.h = spriteTable[4]
-	argsDst.x = (tx - 1) * tileSize
-	argsDst.y = (ty - 1) * tileSize
-	argsDst.w = halfTileSize
-	argsDst.h = tileSize
-
-	renderer:drawRect(args)
+	FFI_drawRect(renderer, spriteTable[0], (tx - 1) * tileSize, (ty - 1) * tileSize, halfTileSize, tileSize, spriteTable[1], spriteTable[2], spriteTable[3] * 0.5, spriteTable[4])
 end
 
 --- @param renderer TE.Renderer
---- @param args TE.DrawRectArgs
---- @param tileMap dr2c.TileMap
+--- @param tileMap TE.TileMap
 --- @param tx integer
 --- @param ty integer
 --- @param info dr2c.TileInfo
-local function drawTileFloorRightPart(renderer, args, tileMap, tx, ty, info)
+local function drawTileFloorRightPart(renderer, tileMap, tx, ty, info)
 	local spriteTable = getFloorSpriteTable(tx, ty, info)
 	if not spriteTable then
 		return
 	end
 
-	local argsSrc = args.source
-	local argsDst = args.destination
-
 	local srcW = spriteTable[3] * 0.5
 
-	args.texture = spriteTable[0]
-	argsSrc.x = spriteTable[1] + srcW
-	argsSrc.y = spriteTable[2]
-	argsSrc.w = srcW
-	argsSrc.h = spriteTable[4]
-	argsDst.x = (tx - 1) * tileSize + halfTileSize
-	argsDst.y = (ty - 1) * tileSize
-	argsDst.w = halfTileSize
-	argsDst.h = tileSize
-
-	renderer:drawRect(args)
+	FFI_drawRect(renderer, spriteTable[0], (tx - 1) * tileSize + halfTileSize, (ty - 1) * tileSize, halfTileSize, tileSize, spriteTable[1] + srcW, spriteTable[2], srcW, spriteTable[4])
 end
 
+--- Bits of `tileMap:getNeighbourRow` masks.
+local neighbourLeftHasInfo = 16
+local neighbourRightHasInfo = 32
+local neighbourWalls = 15
+local neighbourWallRight = 2
+local neighbourWallLeft = 8
+
 --- @param renderer TE.Renderer
---- @param args TE.DrawRectArgs
---- @param tileMap dr2c.TileMap
+--- @param tileMap TE.TileMap
 --- @param tx integer
 --- @param ty integer
 --- @param info dr2c.TileInfo
-local function drawTileFloorUnderWall(renderer, args, tileMap, tx, ty, info)
+--- @param mask integer
+local function drawTileFloorUnderWall(renderer, tileMap, tx, ty, info, mask)
 	if not info.floor then
 		return
 	end
@@ -141,136 +124,67 @@ local function drawTileFloorUnderWall(renderer, args, tileMap, tx, ty, info)
 		return
 	end
 
-	local left = CTileMap_getTileTagAt(tileMap, tx - 1, ty)
-	local right = CTileMap_getTileTagAt(tileMap, tx + 1, ty)
+	local left = bit_band(mask, neighbourLeftHasInfo) ~= 0
+	local right = bit_band(mask, neighbourRightHasInfo) ~= 0
 	if left then
 		if right then
-			drawTileFloor(renderer, args, tileMap, tx, ty, floorInfo)
+			drawTileFloor(renderer, tileMap, tx, ty, floorInfo)
 		else
-			drawTileFloorLeftPart(renderer, args, tileMap, tx, ty, floorInfo)
+			drawTileFloorLeftPart(renderer, tileMap, tx, ty, floorInfo)
 		end
 	else
 		if right then
-			drawTileFloorRightPart(renderer, args, tileMap, tx, ty, floorInfo)
+			drawTileFloorRightPart(renderer, tileMap, tx, ty, floorInfo)
 		end
 	end
 end
 
---- @param tileMap dr2c.TileMap
+--- Wall sprites only depend on left and right walls, ceiling sprites are ordered by all four sides.
 --- @param tx integer
 --- @param ty integer
+--- @param mask integer
 --- @return integer? wallIndex
 --- @return integer wallCeilingIndex
-local function getWallSpriteIndices(tileMap, tx, ty)
-	local up = CTileMap_getTileTagAt(tileMap, tx, ty - 1) == CTileSchema_Tag_Wall
-	local right = CTileMap_getTileTagAt(tileMap, tx + 1, ty) == CTileSchema_Tag_Wall
-	local down = CTileMap_getTileTagAt(tileMap, tx, ty + 1) == CTileSchema_Tag_Wall
-	local left = CTileMap_getTileTagAt(tileMap, tx - 1, ty) == CTileSchema_Tag_Wall
+local function getWallSpriteIndices(tx, ty, mask)
+	local walls = bit_band(mask, neighbourWalls)
+	local wallIndex
 
-	if up then
-		if right then
-			if down then
-				if left then
-					return noiseRandom:int2(tx, ty, 4, 8), 16
-				else
-					return 2, 8
-				end
-			else
-				if left then
-					return noiseRandom:int2(tx, ty, 4, 8), 12
-				else
-					return 2, 4
-				end
-			end
+	if bit_band(walls, neighbourWallRight) ~= 0 then
+		if bit_band(walls, neighbourWallLeft) ~= 0 then
+			wallIndex = getVariant(wallVariants, tx, ty)
 		else
-			if down then
-				if left then
-					return 3, 14
-				else
-					return 1, 6
-				end
-			else
-				if left then
-					return 3, 10
-				else
-					return 1, 2
-				end
-			end
+			wallIndex = 2
 		end
 	else
-		if right then
-			if down then
-				if left then
-					return noiseRandom:int2(tx, ty, 4, 8), 15
-				else
-					return 2, 7
-				end
-			else
-				if left then
-					return noiseRandom:int2(tx, ty, 4, 8), 11
-				else
-					return 2, 3
-				end
-			end
+		if bit_band(walls, neighbourWallLeft) ~= 0 then
+			wallIndex = 3
 		else
-			if down then
-				if left then
-					return 3, 13
-				else
-					return 1, 5
-				end
-			else
-				if left then
-					return 3, 9
-				else
-					return 1, 1
-				end
-			end
+			wallIndex = 1
 		end
 	end
+
+	return wallIndex, walls + 1
 end
 
 --- @param renderer TE.Renderer
---- @param args TE.DrawRectArgs
 --- @param tx integer
 --- @param ty integer
 --- @param info dr2c.TileInfo
-local function drawTileWall(renderer, args, tileMap, tx, ty, info)
-	drawTileFloorUnderWall(renderer, args, tileMap, tx, ty, info)
+--- @param mask integer
+local function drawTileWall(renderer, tileMap, tx, ty, info, mask)
+	drawTileFloorUnderWall(renderer, tileMap, tx, ty, info, mask)
 
 	local spriteTable
-	local argsSrc = args.source
-	local argsDst = args.destination
-	local wallIndex, wellCeilingIndex = getWallSpriteIndices(tileMap, tx, ty)
+	local wallIndex, wellCeilingIndex = getWallSpriteIndices(tx, ty, mask)
 
 	spriteTable = wallIndex and info.sprite and CRenderSprites_getSpriteTable(info.sprite, wallIndex)
 	if spriteTable then
-		args.texture = spriteTable[0]
-		argsSrc.x = spriteTable[1]
-		argsSrc.y = spriteTable[2]
-		argsSrc.w = spriteTable[3]
-		argsSrc.h = spriteTable[4]
-		argsDst.x = (tx - 1) * tileSize
-		argsDst.y = (ty - 1) * tileSize
-		argsDst.w = tileSize
-		argsDst.h = tileSize
-
-		renderer:drawRect(args)
+		FFI_drawRect(renderer, spriteTable[0], (tx - 1) * tileSize, (ty - 1) * tileSize, tileSize, tileSize, spriteTable[1], spriteTable[2], spriteTable[3], spriteTable[4])
 	end
 
 	spriteTable = CRenderSprites_getSpriteTable("WallCeiling", wellCeilingIndex)
 	if spriteTable then
-		args.texture = spriteTable[0]
-		argsSrc.x = spriteTable[1]
-		argsSrc.y = spriteTable[2]
-		argsSrc.w = spriteTable[3]
-		argsSrc.h = spriteTable[4]
-		argsDst.x = (tx - 1) * tileSize
-		argsDst.y = (ty - 2) * tileSize
-		argsDst.w = tileSize
-		argsDst.h = tileSize
-
-		renderer:drawRect(args)
+		FFI_drawRect(renderer, spriteTable[0], (tx - 1) * tileSize, (ty - 2) * tileSize, tileSize, tileSize, spriteTable[1], spriteTable[2], spriteTable[3], spriteTable[4])
 	end
 end
 
@@ -279,8 +193,16 @@ local drawTileFunctions = {
 	[CTileSchema_Tag_Wall] = drawTileWall,
 }
 
+--- Reused by `getRow` to avoid creating a table per row per frame.
+--- @type dr2c.TileTypeID[]
+local rowBuffer = {}
+
+--- Reused by `getNeighbourRow`, wall neighbours of each tile in row.
+--- @type integer[]
+local maskBuffer = {}
+
 --- @param renderer TE.Renderer
---- @param tileMap dr2c.TileMap
+--- @param tileMap TE.TileMap
 local function drawTileMap(renderer, tileMap)
 	if not noiseRandom then
 		noiseRandom = PerlinNoiseRandom()
@@ -288,18 +210,24 @@ local function drawTileMap(renderer, tileMap)
 		noiseRandom:setFrequency(0.875)
 	end
 
-	local mapX, mapY, mapWidth, mapHeight = CTileMap.getBounds(tileMap)
-	local args = DrawRectArgs()
-	args.source = { x = 0, y = 0, w = 0, h = 0 }
+	local mapX, mapY, mapWidth, mapHeight = tileMap:getBounds()
+	if mapX ~= variantsX or mapY ~= variantsY or mapWidth ~= variantsWidth or mapHeight ~= variantsHeight then
+		variantsX, variantsY, variantsWidth, variantsHeight = mapX, mapY, mapWidth, mapHeight
+		floorVariants = noiseRandom:fillInt2(mapX, mapY, mapWidth, mapHeight, 1, 4)
+		wallVariants = noiseRandom:fillInt2(mapX, mapY, mapWidth, mapHeight, 4, 8)
+	end
 
 	for ty = mapY, mapY + mapHeight - 1 do
+		tileMap:getRow(ty, rowBuffer)
+		tileMap:getNeighbourRow(ty, CTileSchema_Tag_Wall, maskBuffer)
+
 		for tx = mapX, mapX + mapWidth - 1 do
-			local tileInfo = CTileMap_getTileInfoAt(tileMap, tx, ty)
+			local tileInfo = CTileSchema_getTypeInfo(rowBuffer[tx - mapX + 1])
 			local drawTile = tileInfo and drawTileFunctions[tileInfo.tag or false]
 
 			if drawTile then
 				--- @cast tileInfo dr2c.TileInfo
-				drawTile(renderer, args, tileMap, tx, ty, tileInfo)
+				drawTile(renderer, tileMap, tx, ty, tileInfo, maskBuffer[tx - mapX + 1])
 			end
 		end
 	end
@@ -308,7 +236,7 @@ end
 --- @param e dr2c.E.CRender
 TE.events:add(N_("CRenderCamera"), function(e)
 	local sceneIndex, sceneName = CRenderFocus.getFocusedScene()
-	local tileMap = CTileMap.getTileMapOnScene(sceneIndex)
+	local tileMap = CTileMap.getNativeTileMapOnScene(sceneIndex)
 
 	if tileMap then
 		drawTileMap(e.renderer, tileMap)
@@ -46,15 +46,16 @@ end
 --- @type table<dr2c.WorldSceneName, dr2c.TileMap>
 local sceneTileMaps = {}
 
+--- Native copies of scene tile maps, renderers and pathfinding read tiles from these without per tile lua calls.
+--- @type table<dr2c.WorldSceneIndex | dr2c.WorldSceneName, TE.TileMap>
+local sceneNativeTileMaps = {}
+
 sceneTileMaps = persist("sceneTileMaps", function()
 	return sceneTileMaps
 end)
-
---- @param tileMap dr2c.TileMap
---- @param sceneID dr2c.WorldSceneName
-function CTileMap.setTileMapOnScene(tileMap, sceneID)
-	sceneTileMaps[sceneID] = tileMap
-end
+sceneNativeTileMaps = persist("sceneNativeTileMaps", function()
+	return sceneNativeTileMaps
+end)
 
 --- @param sceneIndexOrName dr2c.WorldSceneIndex | dr2c.WorldSceneName
 --- @return dr2c.TileMap?
@@ -62,6 +63,62 @@ function CTileMap.getTileMapOnScene(sceneIndexOrName)
 	return sceneTileMaps[sceneIndexOrName]
 end
 
+--- @param sceneIndexOrName dr2c.WorldSceneIndex | dr2c.WorldSceneName
+--- @return TE.TileMap?
+function CTileMap.getNativeTileMapOnScene(sceneIndexOrName)
+	return sceneNativeTileMaps[sceneIndexOrName]
+end
+
+--- @param nativeTileMap TE.TileMap
+--- @param typeID dr2c.TileTypeID
+local function loadNativeTypeInfo(nativeTileMap, typeID)
+	local tileInfo = CTileSchema_getInfo(typeID)
+	if tileInfo then
+		nativeTileMap:setTypeInfo(typeID, tileInfo.tag, tileInfo.collision)
+	end
+end
+
+--- @param tileMap dr2c.TileMap
+--- @return TE.TileMap
+local function newNativeTileMap(tileMap)
+	local nativeTileMap = TileMap(tileMap[fieldX], tileMap[fieldY], tileMap[fieldWidth], tileMap[fieldHeight])
+	local typeIDs = tileMap[fieldTypeIDs]
+	nativeTileMap:loadTypeIDs(typeIDs)
+
+	local loaded = {}
+	for _, typeID in ipairs(typeIDs) do
+		if not loaded[typeID] then
+			loaded[typeID] = true
+			loadNativeTypeInfo(nativeTileMap, typeID)
+		end
+	end
+
+	return nativeTileMap
+end
+
+--- Maps are stored under both scene index and name, so either works for lookups.
+--- @param tileMap dr2c.TileMap?
+--- @param sceneIndexOrName dr2c.WorldSceneIndex | dr2c.WorldSceneName
+local function storeTileMapOnScene(tileMap, sceneIndexOrName)
+	local nativeTileMap = tileMap and newNativeTileMap(tileMap) or nil
+
+	sceneTileMaps[sceneIndexOrName] = tileMap
+	sceneNativeTileMaps[sceneIndexOrName] = nativeTileMap
+
+	local inverted = CWorldScenes.invert(sceneIndexOrName)
+	if inverted ~= nil then
+		sceneTileMaps[inverted] = tileMap
+		sceneNativeTileMaps[inverted] = nativeTileMap
+	end
+end
+
+--- Also rebuilds native tile map of scene, renderers and pathfinding see new map from next read.
+--- @param tileMap dr2c.TileMap?
+--- @param sceneID dr2c.WorldSceneName
+function CTileMap.setTileMapOnScene(tileMap, sceneID)
+	storeTileMapOnScene(tileMap, sceneID)
+end
+
 --- @param width integer
 --- @param height integer
 --- @param types (dr2c.TileType | dr2c.TileTypeID)[]
@@ -159,6 +216,29 @@ function CTileMap.getTileTagAt(tileMap, tx, ty)
 	return tileInfo and tileInfo.tag or nil
 end
 
+local pathGridTagCosts = {
+	[CTileSchema.Tag.Wall] = 0,
+}
+
+--- Native path grid of a tile map, walls are blocked and other tiles cost 1.
+--- Grid does not follow later changes of tile map, call `pathGrid:loadTileMap` again after editing tiles.
+--- @param tileMap dr2c.TileMap | TE.TileMap
+--- @return TE.PathGrid
+--- @nodiscard
+function CTileMap.newPathGrid(tileMap)
+	--- @type TE.TileMap
+	local nativeTileMap
+	if type(tileMap) == "table" then
+		nativeTileMap = newNativeTileMap(tileMap)
+	else
+		nativeTileMap = tileMap
+	end
+
+	local pathGrid = PathGrid(nativeTileMap:getBounds())
+	pathGrid:loadTileMap(nativeTileMap, pathGridTagCosts)
+	return pathGrid
+end
+
 --- @param e dr2c.E.CWorldSessionStart
 TE.events:add(N_("CWorldSessionStart"), function(e)
 	if log.canDebug() then
@@ -173,8 +253,6 @@ TE.events:add(N_("CWorldSessionStart"), function(e)
 	for _, sceneName in ipairs(CWorldScenes.getSceneList()) do
 		local tileMap = tileMaps[sceneName]
 		if tileMap then
-			local sceneIndex = assert(CWorldScenes.invert(sceneName))
-
 			local new = newTileMap(
 				tileMap[fieldX],
 				tileMap[fieldY],
@@ -183,10 +261,28 @@ TE.events:add(N_("CWorldSessionStart"), function(e)
 				tileMap[fieldTypeIDs]
 			)
 
-			sceneTileMaps[sceneIndex] = new
-			sceneTileMaps[sceneName] = new
+			storeTileMapOnScene(new, sceneName)
 		end
 	end
 end, "LoadTileMaps", "Map")
 
+--- @param e dr2c.E.CTileSchemaLoaded
+TE.events:add(N_("CTileSchemaLoaded"), function(e)
+	-- Each native map is stored under both scene index and name, reload it once.
+	local reloaded = {}
+
+	for _, nativeTileMap in pairs(sceneNativeTileMaps) do
+		if not reloaded[nativeTileMap] then
+			reloaded[nativeTileMap] = true
+			nativeTileMap:clearTypeInfos()
+
+			for typeID in pairs(e.tiles) do
+				if type(typeID) == "number" then
+					loadNativeTypeInfo(nativeTileMap, typeID)
+				end
+			end
+		end
+	end
+end, "ReloadNativeTileMaps")
+
 return CTileMap
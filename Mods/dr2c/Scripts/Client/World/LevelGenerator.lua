@@ -9,11 +9,141 @@
 --
 --]]
 
+local Table = require("TE.Table")
+
+local CTileMap = require("dr2c.Client.Tile.Map")
+local CTileSchema = require("dr2c.Client.Tile.Schema")
 local GWorldLevel = require("dr2c.Shared.World.Level")
 
 --- @class dr2c.CWorldLevelGenerator
 local CWorldLevelGenerator = {}
 
+--- @class dr2c.WorldLevelGenerateArgs
+--- @field seed integer
+--- @field x integer? @default 0
+--- @field y integer? @default 0
+--- @field width integer? @default 64
+--- @field height integer? @default 64
+--- @field roomAttempts integer? @default 32
+--- @field roomMinSize integer? @default 4
+--- @field roomMaxSize integer? @default 10
+--- @field noiseScale integer? @default 8
+--- @field noiseThreshold integer? @default 160, [0, 255].
+--- @field empty dr2c.TileType? @default ""
+--- @field floor dr2c.TileType? @default "Floor2"
+--- @field wall dr2c.TileType? @default "Wall2"
+--- @field altFloor dr2c.TileType? Floor type of high noise areas, none by default.
+
+--- Default args of level types, fields not listed here fall back to native defaults.
+--- @type table<dr2c.WorldLevelType, dr2c.WorldLevelGenerateArgs>
+local levelTypeArgs = {
+	[GWorldLevel.Type.Cabin] = {
+		width = 32,
+		height = 32,
+		roomAttempts = 8,
+		roomMaxSize = 8,
+	},
+	[GWorldLevel.Type.City] = {
+		width = 128,
+		height = 128,
+		roomAttempts = 96,
+		roomMinSize = 6,
+		roomMaxSize = 16,
+	},
+}
+
+--- @class dr2c.WorldGeneratedLevel
+--- @field requestID integer
+--- @field tileMap dr2c.TileMap
+--- @field rooms integer[] Flat rects `{ x1, y1, w1, h1, ... }` in tile coordinates.
+
+--- @class dr2c.E.CWorldLevelGenerated
+--- @field level dr2c.WorldGeneratedLevel
+
+CWorldLevelGenerator.eventCWorldLevelGenerated = TE.events:new(N_("CWorldLevelGenerated"), {
+	"TileMap",
+	"",
+})
+
+--- @type TE.LevelGenerator
+local levelGenerator = LevelGenerator()
+
+levelGenerator = persist("levelGenerator", function()
+	return levelGenerator
+end)
+
+--- @param tileType dr2c.TileType?
+--- @param default dr2c.TileType?
+--- @return dr2c.TileTypeID?
+local function toTileTypeID(tileType, default)
+	return CTileSchema.getTileTypeID(tileType or default)
+end
+
+--- @param args dr2c.WorldLevelGenerateArgs
+--- @return table
+local function toNativeParams(args)
+	local params = Table.copy(args)
+	params.emptyType = toTileTypeID(args.empty, "") or 0
+	params.floorType = toTileTypeID(args.floor, "Floor2")
+	params.wallType = toTileTypeID(args.wall, "Wall2")
+	params.altFloorType = args.altFloor and toTileTypeID(args.altFloor) or nil
+	return params
+end
+
+--- @param result table
+--- @return dr2c.WorldGeneratedLevel
+local function fromNativeResult(result)
+	return {
+		requestID = result.requestID,
+		tileMap = CTileMap.newTileMap(result.x, result.y, result.width, result.height, result.typeIDs),
+		rooms = result.rooms,
+	}
+end
+
+--- Default args of a level type merged with `args`.
+--- @param levelType dr2c.WorldLevelType
+--- @param args dr2c.WorldLevelGenerateArgs
+--- @return dr2c.WorldLevelGenerateArgs
+--- @nodiscard
+function CWorldLevelGenerator.getLevelTypeArgs(levelType, args)
+	local result = Table.copy(levelTypeArgs[levelType] or {})
+	for key, value in pairs(args) do
+		result[key] = value
+	end
+	return result
+end
+
+--- Generate on a background thread, `CWorldLevelGenerated` is invoked once the level is ready.
+--- Same args produce same level on every peer.
+--- @param args dr2c.WorldLevelGenerateArgs
+--- @return integer requestID
+function CWorldLevelGenerator.generate(args)
+	return levelGenerator:request(toNativeParams(args))
+end
+
+--- Generate and block until the level is ready.
+--- @param args dr2c.WorldLevelGenerateArgs
+--- @return dr2c.WorldGeneratedLevel
+--- @nodiscard
+function CWorldLevelGenerator.generateImmediately(args)
+	return fromNativeResult(levelGenerator:generate(toNativeParams(args)))
+end
+
+--- @return integer
+--- @nodiscard
+function CWorldLevelGenerator.countPending()
+	return levelGenerator:getPendingCount()
+end
+
+TE.events:add(N_("CUpdate"), function(e)
+	local result = levelGenerator:poll()
+	while result do
+		TE.events:invoke(CWorldLevelGenerator.eventCWorldLevelGenerated, {
+			level = fromNativeResult(result),
+		})
 
+		result = levelGenerator:poll()
+	end
+end, "PollGeneratedLevels", "World")
 
 return CWorldLevelGenerator
@@ -11,9 +11,7 @@
 
 local Enum = require("TE.Enum")
 
-local math_max = math.max
-local math_min = math.min
-local math_sqrt = math.sqrt
+local GWorldTick = require("dr2c.Shared.World.Tick")
 
 --- @class dr2c.CPhysics
 local CPhysics = {}
@@ -26,148 +24,163 @@ CPhysics.Fields = Enum.immutable({
 local FX = CPhysics.Fields.X
 local FY = CPhysics.Fields.Y
 
-local physicalBodyLatest = 0
-local physicalBodies = {}
+--- @class dr2c.PhysicalBodyID : integer
 
-local function vec2(x, y)
-	return { [FX] = x, [FY] = y }
-end
+--- Bodies are simulated natively, broadphase uses a uniform grid so only nearby bodies are tested against each other.
+--- Simulation is fixed point, so all peers produce identical states from identical inputs.
+--- @type TE.PhysicsWorld
+local physicsWorld = PhysicsWorld()
+
+physicsWorld = persist("physicsWorld", function()
+	return physicsWorld
+end)
+
+--- @class dr2c.PhysicalBodyArgs
+--- @field shape { type: "circle" | "rect", r: number?, w: number?, h: number? }
+--- @field mass number? @default 1, 0 for static bodies.
+--- @field pos { [1]: number, [2]: number }?
+--- @field vel { [1]: number, [2]: number }?
+
+--- @param args dr2c.PhysicalBodyArgs
+--- @return dr2c.PhysicalBodyID
+function CPhysics.addBody(args)
+	local shape = args.shape
+	local mass = args.mass or 1
+	local pos = args.pos
+	local x = pos and pos[FX] or 0
+	local y = pos and pos[FY] or 0
+
+	local id
+	if shape.type == "circle" then
+		id = physicsWorld:addCircle(x, y, shape.r, mass)
+	elseif shape.type == "rect" then
+		id = physicsWorld:addRect(x, y, shape.w, shape.h, mass)
+	else
+		error(("Invalid shape type '%s'"):format(shape.type), 2)
+	end
+
+	local vel = args.vel
+	if vel then
+		physicsWorld:setVelocity(id, vel[FX], vel[FY])
+	end
 
-local function dot(a, b)
-	return a[FX] * b[FX] + a[FY] * b[FY]
+	return id
 end
 
-local function length2(v)
-	return v[FX] * v[FX] + v[FY] * v[FY]
+--- @param id dr2c.PhysicalBodyID
+--- @return boolean
+function CPhysics.removeBody(id)
+	return physicsWorld:removeBody(id)
 end
 
-local function sub(a, b)
-	return vec2(a[FX] - b[FX], a[FY] - b[FY])
+--- @param id dr2c.PhysicalBodyID
+--- @return boolean
+--- @nodiscard
+function CPhysics.hasBody(id)
+	return physicsWorld:hasBody(id)
 end
 
-local function add(a, b)
-	return vec2(a[FX] + b[FX], a[FY] + b[FY])
+--- @param id dr2c.PhysicalBodyID
+--- @return number x
+--- @return number y
+--- @nodiscard
+function CPhysics.getPosition(id)
+	return physicsWorld:getPosition(id)
 end
 
-local function mul(v, s)
-	return vec2(v[FX] * s, v[FY] * s)
+--- @param id dr2c.PhysicalBodyID
+--- @param x number
+--- @param y number
+--- @return boolean
+function CPhysics.setPosition(id, x, y)
+	return physicsWorld:setPosition(id, x, y)
 end
 
-function CPhysics.addBody(args)
-	local body = {
-		shape = args.shape,
-		mass = args.mass or 1,
-		invMass = (args.mass == 0) and 0 or (1 / args.mass),
-		pos = args.pos or vec2(0, 0),
-		vel = args.vel or vec2(0, 0),
-	}
-
-	local id = physicalBodyLatest + 1
-	physicalBodyLatest = id
-	physicalBodies[id] = body
+--- @param id dr2c.PhysicalBodyID
+--- @return number x
+--- @return number y
+--- @nodiscard
+function CPhysics.getVelocity(id)
+	return physicsWorld:getVelocity(id)
+end
 
-	return id
+--- @param id dr2c.PhysicalBodyID
+--- @param x number
+--- @param y number
+--- @return boolean
+function CPhysics.setVelocity(id, x, y)
+	return physicsWorld:setVelocity(id, x, y)
 end
 
-local function detectCircleVsCircle(a, b)
-	local delta = sub(b.pos, a.pos)
-	local r = a.shape.r + b.shape.r
-	if length2(delta) <= r * r then
-		return true, delta
-	end
-	return false
+--- Integrate bodies, detect and resolve collisions.
+--- @param deltaTime number
+--- @return integer contactCount
+function CPhysics.update(deltaTime)
+	return physicsWorld:step(deltaTime)
 end
 
-local function detectRectVsRect(a, b)
-	local dx = math.abs(a.pos[FX] - b.pos[FX])
-	local dy = math.abs(a.pos[FY] - b.pos[FY])
-	local hw = (a.shape.w / 2 + b.shape.w / 2)
-	local hh = (a.shape.h / 2 + b.shape.h / 2)
-	if dx <= hw and dy <= hh then
-		return true, vec2(dx - hw, dy - hh)
+--- @param world TE.PhysicsWorld
+--- @param index integer
+--- @return integer? index
+--- @return dr2c.PhysicalBodyID a
+--- @return dr2c.PhysicalBodyID b
+--- @return number normalX
+--- @return number normalY
+--- @return number depth
+local function contactsIterator(world, index)
+	index = index + 1
+	if index <= world:getContactCount() then
+		return index, world:getContact(index)
 	end
-
-	return false
 end
 
-local function detectCircleVsRect(circle, rect)
-	local cx, cy = circle.pos[FX], circle.pos[FY]
-	local rx, ry = rect.pos[FX], rect.pos[FY]
-	local hw, hh = rect.shape.w / 2, rect.shape.h / 2
-
-	local nearestX = math_max(rx - hw, math_min(cx, rx + hw))
-	local nearestY = math_max(ry - hh, math_min(cy, ry + hh))
-
-	local dx, dy = cx - nearestX, cy - nearestY
-	if dx * dx + dy * dy <= circle.shape.r * circle.shape.r then
-		return true, vec2(dx, dy)
-	end
+--- Iterate over contacts found in the latest update, normals point from body `a` to body `b`.
+--- @return fun(world: TE.PhysicsWorld, index: integer): (index: integer, a: dr2c.PhysicalBodyID, b: dr2c.PhysicalBodyID, normalX: number, normalY: number, depth: number)
+--- @return TE.PhysicsWorld
+--- @return integer
+--- @nodiscard
+function CPhysics.iterateContacts()
+	return contactsIterator, physicsWorld, 0
+end
 
-	return false
+--- @return integer
+--- @nodiscard
+function CPhysics.countBodies()
+	return physicsWorld:getBodyCount()
 end
 
-local function checkCollision(a, b)
-	local shapeTypeA = a.shape.type
-	local shapeTypeB = b.shape.type
-
-	if shapeTypeA == "circle" then
-		if shapeTypeB == "circle" then
-			return detectCircleVsCircle(a, b)
-		elseif shapeTypeB == "rect" then
-			return detectCircleVsRect(a, b)
-		end
-	elseif shapeTypeA == "rect" then
-		if shapeTypeB == "circle" then
-			return detectCircleVsRect(b, a)
-		elseif shapeTypeB == "rect" then
-			return detectRectVsRect(a, b)
-		end
-	end
+--- Hash of current simulation state, compare it with peers' to detect desyncs.
+--- @return integer
+--- @nodiscard
+function CPhysics.getStateHash()
+	return physicsWorld:getStateHash()
+end
 
-	return false
+function CPhysics.clear()
+	physicsWorld:clear()
 end
 
-local function resolveCollision(a, b, normal)
-	local relativeVelocity = sub(b.vel, a.vel)
-	local velocityAlongNormal = dot(relativeVelocity, normal)
-	if velocityAlongNormal > 0 then
-		return
-	end
+--#region Events
 
-	local e = 1.0
-	local j = -(1 + e) * velocityAlongNormal
-	j = j / (a.invMass + b.invMass)
+TE.events:add(N_("CConnect"), CPhysics.clear, "ResetPhysics", "Reset")
+TE.events:add(N_("CDisconnect"), CPhysics.clear, "ResetPhysics", "Reset")
+TE.events:add(N_("CWorldSessionStart"), CPhysics.clear, "ResetPhysics", "Reset")
+TE.events:add(N_("CWorldSessionFinish"), CPhysics.clear, "ResetPhysics", "Reset")
 
-	local impulse = mul(normal, j)
-	a.vel = sub(a.vel, mul(impulse, a.invMass))
-	b.vel = add(b.vel, mul(impulse, b.invMass))
-end
+TE.events:add(N_("CWorldTickProcess"), function()
+	CPhysics.update(GWorldTick.getDeltaTime())
+end, "StepPhysics", "EndAccel")
 
-function CPhysics.update(deltaTime)
-	for _, body in ipairs(physicalBodies) do
-		body.pos[FX] = body.pos[FX] + body.vel[FX] * deltaTime
-		body.pos[FY] = body.pos[FY] + body.vel[FY] * deltaTime
-	end
+TE.events:add(N_("CSnapshotCollect"), function(e)
+	e.snapshot.physics = physicsWorld:serialize()
+end, "CollectPhysics", "Physics")
 
-	local len = #physicalBodies
-	for i = 1, len do
-		local a = physicalBodies[i]
-
-		for j = i + 1, len do
-			local b = physicalBodies[j]
-			local hit, normal = checkCollision(a, b)
-
-			if hit then
-				if normal then
-					local l = math_sqrt(normal[FX] * normal[FX] + normal[FY] * normal[FY])
-					if l > 0 then
-						normal = vec2(normal[FX] / l, normal[FY] / l)
-						resolveCollision(a, b, normal)
-					end
-				end
-			end
-		end
+TE.events:add(N_("CSnapshotDispense"), function(e)
+	if e.snapshot.physics and not physicsWorld:deserialize(e.snapshot.physics) and log.canError() then
+		log.error("Failed to deserialize physics state from snapshot")
 	end
-end
+end, "DispensePhysics", "Physics")
+
+--#endregion
 
 return CPhysics
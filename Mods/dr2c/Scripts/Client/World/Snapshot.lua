@@ -185,11 +185,13 @@ end
 
 local eventClientSnapshotCollect = TE.events:new(N_("CSnapshotCollect"), {
 	"ECS",
+	"Physics",
 	"Registry",
 })
 
 local eventClientSnapshotDispense = TE.events:new(N_("CSnapshotDispense"), {
 	"Registry",
+	"Physics",
 	"ECS",
 })
 
@@ -13,7 +13,7 @@
 
 using namespace tudov;
 
-Audio::Audio(std::string_view path, const std::vector<std::byte> &bytes) noexcept
+Audio::Audio(std::string_view path, std::span<const std::byte> bytes) noexcept
 	: _bytes(bytes.begin(), bytes.end())
 {
 }
@@ -17,6 +17,7 @@
 #include "Data/GlobalStorageLocation.hpp"
 #include "Data/GlobalStorageManager.hpp"
 #include "Data/HierarchyIterationResult.hpp"
+#include "Data/MappedFile.hpp"
 #include "Data/PathType.hpp"
 #include "Data/VirtualFileSystem.hpp"
 #include "Data/ZipStorage.hpp"
@@ -29,6 +30,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -64,6 +66,7 @@ DelegateEvent<const std::filesystem::path &, EFileChangeType> &AssetsManager::Ge
 
 void AssetsManager::Initialize() noexcept
 {
+	// A file mounted again replaces the previous one, so developer files override packaged files of the same path.
 	LoadAssetsFromPackageFiles();
 	LoadAssetsFromDeveloperDirectory();
 	LoadAssetsFromExternalDirectories();
@@ -71,40 +74,101 @@ void AssetsManager::Initialize() noexcept
 
 void AssetsManager::LoadAssetsFromPackageFiles() noexcept
 {
-	for (auto &&bytes : CollectPackageFileBytes())
+	for (const std::filesystem::path &packageFile : CollectPackageFiles())
 	{
-		ZipStorage zipStorage{bytes};
+		PackInfo packInfo{
+		    .path = packageFile.generic_string(),
+		    .name = packageFile.stem().generic_string(),
+		    .version = Version(),
+		};
+		_founded.emplace_back(packInfo);
+
+		std::shared_ptr<ZipStorage> package;
+		try
+		{
+			package = OpenPackage(packageFile);
+		}
+		catch (std::exception &e)
+		{
+			Error("Failed to open package \"{}\": {}", packInfo.path, e.what());
+			continue;
+		}
 
-		zipStorage.Foreach("", [this](const std::filesystem::path &filePath, const std::filesystem::path &, void *) -> EHierarchyIterationResult
+		std::vector<std::filesystem::path> files;
+		package->Foreach("", [&files](const std::filesystem::path &filePath, const std::filesystem::path &, void *) -> EHierarchyIterationResult
 		{
-			Info("Loading contents from package: {}", filePath.generic_string());
-			// TODO
+			// Directory entries end with a slash.
+			if (filePath.has_filename())
+			{
+				files.emplace_back(filePath);
+			}
 
 			return EHierarchyIterationResult::Continue;
 		});
+
+		Info("Loading {} files from package \"{}\"", files.size(), packInfo.path);
+
+		for (const std::filesystem::path &file : files)
+		{
+			std::filesystem::path path = std::filesystem::path(Constants::DataVirtualStorageRootApp) / file;
+			try
+			{
+				// Mounted files keep the package and its mapping alive.
+				if (package->IsStored(file))
+				{
+					GetVirtualFileSystem().MountFileView(path, package->ReadFileView(file), package);
+				}
+				else
+				{
+					// Inflated on first use into an evictable blob, not kept by package.
+					auto loader = [package, file]()
+					{
+						return package->ReadFileToBytes(file);
+					};
+					GetVirtualFileSystem().MountFileLazy(path, loader, package->GetPathSize(file));
+				}
+			}
+			catch (std::exception &e)
+			{
+				Error("Failed to load \"{}\" from package \"{}\": {}", file.generic_string(), packInfo.path, e.what());
+			}
+		}
+
+		_loaded.emplace_back(std::move(packInfo));
 	}
 }
 
-std::vector<std::vector<std::byte>> AssetsManager::CollectPackageFileBytes() noexcept
+std::vector<std::filesystem::path> AssetsManager::CollectPackageFiles() noexcept
 {
-	std::vector<std::vector<std::byte>> zipFileBytes;
+	std::vector<std::filesystem::path> packageFiles;
 
 	GlobalStorage &applicationGlobalStorage = GetGlobalStorageManager().GetApplicationStorage();
 
-	applicationGlobalStorage.Foreach("", [this, &applicationGlobalStorage, &zipFileBytes](const std::filesystem::path &filePath, const std::filesystem::path &directoryPath, void *) -> EHierarchyIterationResult
+	applicationGlobalStorage.Foreach("", [&applicationGlobalStorage, &packageFiles](const std::filesystem::path &filePath, const std::filesystem::path &directoryPath, void *) -> EHierarchyIterationResult
 	{
-		if (std::filesystem::is_regular_file(filePath))
+		std::filesystem::path file = directoryPath / filePath;
+		if (file.extension() == ".pck" && applicationGlobalStorage.GetPathType(file) == EPathType::File)
 		{
-			if (std::filesystem::path(filePath).extension() == ".pck")
-			{
-				zipFileBytes.emplace_back(applicationGlobalStorage.ReadFileToBytes(filePath));
-			}
+			packageFiles.emplace_back(std::move(file));
 		}
 
 		return EHierarchyIterationResult::Continue;
 	});
 
-	return zipFileBytes;
+	return packageFiles;
+}
+
+std::shared_ptr<ZipStorage> AssetsManager::OpenPackage(const std::filesystem::path &packageFile)
+{
+	if (GlobalStorageLocation::IsAccessible())
+	{
+		std::filesystem::path absolutePath = GlobalStorageLocation::GetPath(EGlobalStorageLocation::Application) / packageFile;
+		return std::make_shared<ZipStorage>(std::make_shared<const MappedFile>(absolutePath));
+	}
+
+	// Application storage is not on native file system, read the whole package instead.
+	GlobalStorage &applicationGlobalStorage = GetGlobalStorageManager().GetApplicationStorage();
+	return std::make_shared<ZipStorage>(applicationGlobalStorage.ReadFileToBytes(packageFile));
 }
 
 void AssetsManager::LoadAssetsFromDeveloperDirectory() noexcept
@@ -117,7 +181,8 @@ void AssetsManager::LoadAssetsFromDeveloperDirectory() noexcept
 		return;
 	}
 
-	std::vector<std::tuple<std::string, std::vector<std::byte>>> assets{};
+	// Files are read on first use, only paths and sizes are collected here.
+	std::vector<std::tuple<std::string, std::filesystem::path, std::uint64_t>> assets{};
 
 	applicationGlobalStorage.ForeachRecursed(Constants::DataDeveloperAssetsDirectory, [this, &assets, &applicationGlobalStorage](const std::filesystem::path &path, const std::filesystem::path &directory, void *) -> EHierarchyIterationResult
 	{
@@ -125,19 +190,23 @@ void AssetsManager::LoadAssetsFromDeveloperDirectory() noexcept
 		{
 			std::filesystem::path fileFillPath = directory / path;
 			std::filesystem::path resourcePath = Constants::DataVirtualStorageRootApp / std::filesystem::relative(fileFillPath, Constants::DataDeveloperAssetsDirectory);
-			auto &&bytes = applicationGlobalStorage.ReadFileToBytes(fileFillPath);
+			std::uint64_t size = applicationGlobalStorage.GetPathSize(fileFillPath);
 
 			auto path = resourcePath.generic_string();
-			TE_TRACE("\"{}\", {} bytes", path, bytes.size());
-			assets.emplace_back(path, bytes);
+			TE_TRACE("\"{}\", {} bytes", path, size);
+			assets.emplace_back(path, fileFillPath, size);
 		}
 
 		return EHierarchyIterationResult::Continue;
 	});
 
-	for (auto &&[path, bytes] : assets)
+	for (auto &&[path, fileFillPath, size] : assets)
 	{
-		GetVirtualFileSystem().MountFile(path, bytes);
+		auto loader = [&applicationGlobalStorage, fileFillPath]()
+		{
+			return applicationGlobalStorage.ReadFileToBytes(fileFillPath);
+		};
+		GetVirtualFileSystem().MountFileLazy(path, loader, static_cast<std::size_t>(size));
 	}
 
 	if (GlobalStorageLocation::IsAccessible())
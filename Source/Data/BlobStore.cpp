@@ -0,0 +1,143 @@
+/**
+ * @file Data/BlobStore.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Data/BlobStore.hpp"
+
+#include "xxhash.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace tudov;
+
+static constexpr std::size_t minCollectThreshold = 256;
+
+BlobStore::BlobStore() noexcept
+    : _blobs(),
+      _collectThreshold(minCollectThreshold),
+      _sharedBytes(0)
+{
+}
+
+BlobHash BlobStore::Hash(std::span<const std::byte> bytes) noexcept
+{
+	return XXH3_64bits(bytes.data(), bytes.size());
+}
+
+std::shared_ptr<const Blob> BlobStore::Intern(std::vector<std::byte> &&bytes) noexcept
+{
+	BlobHash hash = Hash(bytes);
+
+	std::vector<std::weak_ptr<const Blob>> *chain;
+	if (std::shared_ptr<const Blob> blob = Find(hash, bytes, chain); blob != nullptr)
+	{
+		_sharedBytes += bytes.size();
+		return blob;
+	}
+
+	return Emplace(hash, std::move(bytes), *chain);
+}
+
+std::shared_ptr<const Blob> BlobStore::Intern(std::span<const std::byte> bytes) noexcept
+{
+	BlobHash hash = Hash(bytes);
+
+	std::vector<std::weak_ptr<const Blob>> *chain;
+	if (std::shared_ptr<const Blob> blob = Find(hash, bytes, chain); blob != nullptr)
+	{
+		_sharedBytes += bytes.size();
+		return blob;
+	}
+
+	return Emplace(hash, std::vector<std::byte>(bytes.begin(), bytes.end()), *chain);
+}
+
+std::shared_ptr<const Blob> BlobStore::Find(BlobHash hash, std::span<const std::byte> bytes) noexcept
+{
+	if (!_blobs.contains(hash))
+	{
+		return nullptr;
+	}
+
+	std::vector<std::weak_ptr<const Blob>> *chain;
+	return Find(hash, bytes, chain);
+}
+
+std::shared_ptr<const Blob> BlobStore::Emplace(BlobHash hash, std::vector<std::byte> &&bytes, std::vector<std::weak_ptr<const Blob>> &chain) noexcept
+{
+	auto blob = std::make_shared<const Blob>(Blob{
+	    .hash = hash,
+	    .bytes = std::move(bytes),
+	});
+	chain.emplace_back(blob);
+
+	// Expired references are only dropped on hash hits, sweep the rest once in a while.
+	if (_blobs.size() >= _collectThreshold) [[unlikely]]
+	{
+		Collect();
+		_collectThreshold = std::max(_blobs.size() * 2, minCollectThreshold);
+	}
+
+	return blob;
+}
+
+std::shared_ptr<const Blob> BlobStore::Find(BlobHash hash, std::span<const std::byte> bytes, std::vector<std::weak_ptr<const Blob>> *&chain) noexcept
+{
+	chain = &_blobs[hash];
+
+	std::shared_ptr<const Blob> found = nullptr;
+	std::erase_if(*chain, [&found, bytes](const std::weak_ptr<const Blob> &weak)
+	{
+		std::shared_ptr<const Blob> blob = weak.lock();
+		if (blob == nullptr)
+		{
+			return true;
+		}
+
+		if (found == nullptr && blob->bytes.size() == bytes.size() && std::memcmp(blob->bytes.data(), bytes.data(), bytes.size()) == 0)
+		{
+			found = std::move(blob);
+		}
+		return false;
+	});
+
+	return found;
+}
+
+void BlobStore::Collect() noexcept
+{
+	std::erase_if(_blobs, [](auto &pair)
+	{
+		std::erase_if(pair.second, [](const std::weak_ptr<const Blob> &weak)
+		{
+			return weak.expired();
+		});
+		return pair.second.empty();
+	});
+}
+
+std::size_t BlobStore::GetCount() const noexcept
+{
+	std::size_t count = 0;
+	for (const auto &[_, chain] : _blobs)
+	{
+		for (const std::weak_ptr<const Blob> &weak : chain)
+		{
+			count += weak.expired() ? 0 : 1;
+		}
+	}
+	return count;
+}
+
+std::size_t BlobStore::GetSharedBytes() const noexcept
+{
+	return _sharedBytes;
+}
@@ -158,7 +158,8 @@ std::vector<std::byte> GlobalStorage::ReadFileToBytes(const Path &filePath)
 		throw std::runtime_error("can't read");
 	}
 
-	std::size_t size = GetPathSize(filePath);
+	// Size on storage, derived storages may report contents not written yet.
+	std::size_t size = GlobalStorage::GetPathSize(filePath);
 	if (size == 0) [[unlikely]]
 	{
 		return {};
@@ -179,3 +180,45 @@ std::vector<std::byte> GlobalStorage::ReadFileToBytes(const Path &filePath)
 	SDL_free(dst);
 	return bytes;
 }
+
+bool GlobalStorage::WriteFileFromBytes(const Path &filePath, std::span<const std::byte> bytes) noexcept
+{
+	if (!CanWrite() || !IsReady()) [[unlikely]]
+	{
+		return false;
+	}
+
+	Path directory = filePath.parent_path();
+	if (!directory.empty() && Check(directory) != EHierarchyElement::Directory)
+	{
+		if (!SDL_CreateStorageDirectory(_sdlStorage, directory.generic_string().c_str())) [[unlikely]]
+		{
+			Error("Failed to create directory \"{}\": {}", directory.generic_string(), SDL_GetError());
+			return false;
+		}
+	}
+
+	if (!SDL_WriteStorageFile(_sdlStorage, filePath.generic_string().c_str(), bytes.data(), bytes.size())) [[unlikely]]
+	{
+		Error("Failed to write file \"{}\": {}", filePath.generic_string(), SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
+
+bool GlobalStorage::RemovePath(const Path &path) noexcept
+{
+	if (!CanWrite() || !IsReady()) [[unlikely]]
+	{
+		return false;
+	}
+
+	if (!SDL_RemoveStoragePath(_sdlStorage, path.generic_string().c_str())) [[unlikely]]
+	{
+		Error("Failed to remove \"{}\": {}", path.generic_string(), SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
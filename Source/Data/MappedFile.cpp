@@ -0,0 +1,179 @@
+/**
+ * @file Data/MappedFile.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Data/MappedFile.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#if _WIN32
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using namespace tudov;
+
+#if _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : _data(nullptr),
+      _size(0),
+      _fileHandle(nullptr),
+      _mappingHandle(nullptr)
+{
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error(std::format("Failed to open file \"{}\"", path.generic_string()));
+	}
+	_fileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		Close();
+		throw std::runtime_error(std::format("Failed to get size of file \"{}\"", path.generic_string()));
+	}
+	_size = static_cast<std::size_t>(size.QuadPart);
+
+	// Empty files can not be mapped.
+	if (_size == 0)
+	{
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		Close();
+		throw std::runtime_error(std::format("Failed to create file mapping \"{}\"", path.generic_string()));
+	}
+	_mappingHandle = mapping;
+
+	_data = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr)
+	{
+		Close();
+		throw std::runtime_error(std::format("Failed to map view of file \"{}\"", path.generic_string()));
+	}
+}
+
+void MappedFile::Close() noexcept
+{
+	if (_data != nullptr)
+	{
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr)
+	{
+		CloseHandle(_mappingHandle);
+	}
+	if (_fileHandle != nullptr)
+	{
+		CloseHandle(_fileHandle);
+	}
+
+	_data = nullptr;
+	_size = 0;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : _data(nullptr),
+      _size(0),
+      _fileHandle(nullptr),
+      _mappingHandle(nullptr)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error(std::format("Failed to open file \"{}\"", path.generic_string()));
+	}
+
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		close(fd);
+		throw std::runtime_error(std::format("Failed to get size of file \"{}\"", path.generic_string()));
+	}
+	_size = static_cast<std::size_t>(status.st_size);
+
+	if (_size != 0)
+	{
+		void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			close(fd);
+			throw std::runtime_error(std::format("Failed to map file \"{}\"", path.generic_string()));
+		}
+		_data = static_cast<const std::byte *>(data);
+	}
+
+	// Mapping stays valid after closing descriptor.
+	close(fd);
+}
+
+void MappedFile::Close() noexcept
+{
+	if (_data != nullptr)
+	{
+		munmap(const_cast<std::byte *>(_data), _size);
+	}
+
+	_data = nullptr;
+	_size = 0;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _fileHandle(std::exchange(other._fileHandle, nullptr)),
+      _mappingHandle(std::exchange(other._mappingHandle, nullptr))
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		_data = std::exchange(other._data, nullptr);
+		_size = std::exchange(other._size, 0);
+		_fileHandle = std::exchange(other._fileHandle, nullptr);
+		_mappingHandle = std::exchange(other._mappingHandle, nullptr);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+	Close();
+}
+
+std::span<const std::byte> MappedFile::GetBytes() const noexcept
+{
+	return {_data, _data != nullptr ? _size : 0};
+}
+
+std::size_t MappedFile::GetSize() const noexcept
+{
+	return _size;
+}
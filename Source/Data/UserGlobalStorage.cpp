@@ -12,14 +12,66 @@
 #include "Data/UserGlobalStorage.hpp"
 
 #include "Data/GlobalStorageLocation.hpp"
+#include "Data/Constants.hpp"
 #include "Data/GlobalStorageManager.hpp"
+#include "Data/HierarchyElement.hpp"
+#include "Data/HierarchyIterationResult.hpp"
+#include "Data/PathInfo.hpp"
+#include "Data/PathType.hpp"
+#include "System/LogMicros.hpp"
+
+#include "SDL3/SDL_properties.h"
+#include "SDL3/SDL_storage.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
 
 using namespace tudov;
 
+/**
+ * "a/b" -> "a/b", "a/b/" -> "a/b".
+ */
+static std::filesystem::path ToDirectory(const std::filesystem::path &path) noexcept
+{
+	std::filesystem::path directory = path.lexically_normal();
+	return directory.has_filename() ? directory : directory.parent_path();
+}
+
+/**
+ * Whether `path` is a descendant of `directory`, compared by path parts.
+ */
+static bool IsUnder(const std::filesystem::path &path, const std::filesystem::path &directory) noexcept
+{
+	auto [directoryIt, pathIt] = std::mismatch(directory.begin(), directory.end(), path.begin(), path.end());
+	return directoryIt == directory.end() && pathIt != path.end();
+}
+
 UserGlobalStorage::UserGlobalStorage(GlobalStorageManager &globalStorageManager, std::string_view username) noexcept
     : GlobalStorage(globalStorageManager),
-      _username(username)
+      _username(username),
+      _stopping(false),
+      _queuedWrites(),
+      _writingWrites(),
+      _cache(),
+      _cacheOrder(),
+      _cacheSize(0)
+{
+	GlobalStorage::_sdlStorage = SDL_OpenUserStorage(AppOrganization, AppName, static_cast<SDL_PropertiesID>(0));
+}
+
+UserGlobalStorage::~UserGlobalStorage() noexcept
 {
+	// Queued writes are done before storage is closed.
+	if (_ioThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock{_mutex};
+			_stopping = true;
+		}
+		_writeCV.notify_all();
+		_ioThread.join();
+	}
 }
 
 std::string_view UserGlobalStorage::GetUsername() noexcept
@@ -47,7 +99,364 @@ bool UserGlobalStorage::CanWrite() noexcept
 	return true;
 }
 
+EHierarchyIterationResult UserGlobalStorage::Foreach(const Path &path, const EnumerationCallbackFunction<> &callback, void *callbackArgs) noexcept
+{
+	Path directory = path.lexically_normal();
+
+	// Children of directory that only exist as queued writes, either files or their parent directories.
+	std::set<std::string> queuedChildren;
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		for (const auto *writes : {&_queuedWrites, &_writingWrites})
+		{
+			for (const auto &[filePath, _] : *writes)
+			{
+				Path relative = filePath.lexically_normal().lexically_relative(directory);
+				if (!relative.empty() && *relative.begin() != "." && *relative.begin() != "..")
+				{
+					queuedChildren.emplace(relative.begin()->generic_string());
+				}
+			}
+		}
+	}
+
+	if (queuedChildren.empty()) [[likely]]
+	{
+		return GlobalStorage::Foreach(path, callback, callbackArgs);
+	}
+
+	EHierarchyIterationResult result = GlobalStorage::Foreach(path, [&queuedChildren, &callback](const Path &child, const Path &childDirectory, void *args)
+	{
+		queuedChildren.erase(child.generic_string());
+		return callback(child, childDirectory, args);
+	}, callbackArgs);
+
+	for (const std::string &child : queuedChildren)
+	{
+		if (result != EHierarchyIterationResult::Continue)
+		{
+			break;
+		}
+		result = callback(child, path, callbackArgs);
+	}
+
+	return result;
+}
+
+EHierarchyElement UserGlobalStorage::Check(const Path &path) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		if (FindQueued(path) != nullptr)
+		{
+			return EHierarchyElement::Data;
+		}
+		if (HasQueuedUnder(path))
+		{
+			return EHierarchyElement::Directory;
+		}
+	}
+	return GlobalStorage::Check(path);
+}
+
+PathInfo UserGlobalStorage::GetPathInfo(const Path &path) noexcept
+{
+	Bytes queued;
+	bool queuedUnder;
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		queued = FindQueued(path);
+		queuedUnder = queued == nullptr && HasQueuedUnder(path);
+	}
+
+	PathInfo info = GlobalStorage::GetPathInfo(path);
+	if (queued != nullptr)
+	{
+		// Times are of previous contents if file exists already, 0 otherwise.
+		info.type = EPathType::File;
+		info.size = queued->size();
+	}
+	else if (queuedUnder)
+	{
+		info.type = EPathType::Directory;
+	}
+	return info;
+}
+
+std::uint64_t UserGlobalStorage::GetPathSize(const Path &filePath) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		if (Bytes bytes = FindQueued(filePath); bytes != nullptr)
+		{
+			return bytes->size();
+		}
+	}
+	return GlobalStorage::GetPathSize(filePath);
+}
+
+EPathType UserGlobalStorage::GetPathType(const Path &path) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		if (FindQueued(path) != nullptr)
+		{
+			return EPathType::File;
+		}
+		if (HasQueuedUnder(path))
+		{
+			return EPathType::Directory;
+		}
+	}
+	return GlobalStorage::GetPathType(path);
+}
+
+std::vector<std::byte> UserGlobalStorage::ReadFileToBytes(const Path &filePath)
+{
+	std::string key = filePath.generic_string();
+
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+
+		if (Bytes bytes = FindQueued(filePath); bytes != nullptr)
+		{
+			return *bytes;
+		}
+
+		if (auto it = _cache.find(key); it != _cache.end())
+		{
+			return *it->second;
+		}
+	}
+
+	std::vector<std::byte> bytes = GlobalStorage::ReadFileToBytes(filePath);
+
+	if (bytes.size() <= CachedFileSizeLimit)
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		// A write may have been queued meanwhile, which already cached newer contents.
+		if (FindQueued(filePath) == nullptr)
+		{
+			CacheFile(std::move(key), std::make_shared<const std::vector<std::byte>>(bytes));
+		}
+	}
+
+	return bytes;
+}
+
+bool UserGlobalStorage::WriteFileFromBytes(const Path &filePath, std::span<const std::byte> bytes) noexcept
+{
+	if (!CanWrite()) [[unlikely]]
+	{
+		return false;
+	}
+
+	auto shared = std::make_shared<const std::vector<std::byte>>(bytes.begin(), bytes.end());
+
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+
+		if (!_ioThread.joinable()) [[unlikely]]
+		{
+			_ioThread = std::thread(&UserGlobalStorage::IOThreadMain, this);
+		}
+
+		// Latest contents win, earlier queued write of same file is never done.
+		_queuedWrites.insert_or_assign(filePath, shared);
+
+		std::string key = filePath.generic_string();
+		if (shared->size() <= CachedFileSizeLimit)
+		{
+			CacheFile(std::move(key), shared);
+		}
+		else if (auto it = _cache.find(key); it != _cache.end())
+		{
+			_cacheSize -= it->second->size();
+			_cache.erase(it);
+		}
+	}
+	_writeCV.notify_one();
+
+	return true;
+}
+
+bool UserGlobalStorage::RemovePath(const Path &path) noexcept
+{
+	Path directory = ToDirectory(path);
+	bool dropped;
+	{
+		std::unique_lock<std::mutex> lock{_mutex};
+
+		dropped = _queuedWrites.erase(path) != 0;
+		// Files under a removed directory.
+		for (auto it = _queuedWrites.upper_bound(directory); it != _queuedWrites.end() && IsUnder(it->first, directory);)
+		{
+			it = _queuedWrites.erase(it);
+			dropped = true;
+		}
+
+		// Otherwise batch being written would bring it back after removal.
+		_flushCV.wait(lock, [this, &path, &directory]()
+		{
+			auto it = _writingWrites.upper_bound(directory);
+			return !_writingWrites.contains(path) && (it == _writingWrites.end() || !IsUnder(it->first, directory));
+		});
+
+		std::string key = path.generic_string();
+		std::string prefix = directory.generic_string() + '/';
+		for (auto it = _cache.begin(); it != _cache.end();)
+		{
+			if (it->first == key || it->first.starts_with(prefix))
+			{
+				_cacheSize -= it->second->size();
+				it = _cache.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	// File may exist only as the dropped write.
+	if (dropped && GlobalStorage::Check(path) == EHierarchyElement::None)
+	{
+		return true;
+	}
+	return GlobalStorage::RemovePath(path);
+}
+
+void UserGlobalStorage::Flush() noexcept
+{
+	std::unique_lock<std::mutex> lock{_mutex};
+	if (!_ioThread.joinable())
+	{
+		return;
+	}
+
+	_writeCV.notify_one();
+	_flushCV.wait(lock, [this]()
+	{
+		return _queuedWrites.empty() && _writingWrites.empty();
+	});
+}
+
 constexpr EGlobalStorageLocation UserGlobalStorage::GetLocation() const noexcept
 {
 	return EGlobalStorageLocation::User;
 }
+
+UserGlobalStorage::Bytes UserGlobalStorage::FindQueued(const Path &filePath) const noexcept
+{
+	if (auto it = _queuedWrites.find(filePath); it != _queuedWrites.end())
+	{
+		return it->second;
+	}
+	if (auto it = _writingWrites.find(filePath); it != _writingWrites.end())
+	{
+		return it->second;
+	}
+	return nullptr;
+}
+
+bool UserGlobalStorage::HasQueuedUnder(const Path &directory) const noexcept
+{
+	Path directory_ = ToDirectory(directory);
+	// Paths are ordered part by part, files under a directory come right after it.
+	for (const auto *writes : {&_queuedWrites, &_writingWrites})
+	{
+		if (auto it = writes->upper_bound(directory_); it != writes->end() && IsUnder(it->first, directory_))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UserGlobalStorage::CacheFile(std::string key, Bytes bytes) noexcept
+{
+	auto it = _cache.find(key);
+	if (it != _cache.end())
+	{
+		_cacheSize -= it->second->size();
+		it->second = bytes;
+	}
+	else
+	{
+		_cacheOrder.emplace_back(key);
+		it = _cache.emplace(std::move(key), bytes).first;
+	}
+	_cacheSize += bytes->size();
+
+	// Order may still list files erased on large writes, skip them.
+	while (_cacheSize > CachedTotalSizeLimit && !_cacheOrder.empty())
+	{
+		auto evicted = _cache.find(_cacheOrder.front());
+		if (evicted == it)
+		{
+			_cacheOrder.emplace_back(std::move(_cacheOrder.front()));
+		}
+		else if (evicted != _cache.end())
+		{
+			_cacheSize -= evicted->second->size();
+			_cache.erase(evicted);
+		}
+		_cacheOrder.pop_front();
+	}
+}
+
+void UserGlobalStorage::IOThreadMain() noexcept
+{
+	std::unique_lock<std::mutex> lock{_mutex};
+
+	while (true)
+	{
+		_writeCV.wait(lock, [this]()
+		{
+			return _stopping || !_queuedWrites.empty();
+		});
+
+		if (_queuedWrites.empty())
+		{
+			// Stopping, nothing left to write.
+			return;
+		}
+
+		// Let repeated saves of a burst land in same batch.
+		if (!_stopping)
+		{
+			_writeCV.wait_for(lock, WriteBatchDelay, [this]()
+			{
+				return _stopping;
+			});
+		}
+
+		_writingWrites = std::move(_queuedWrites);
+		_queuedWrites.clear();
+
+		lock.unlock();
+		std::vector<std::string> failedFiles;
+		for (auto &&[filePath, bytes] : _writingWrites)
+		{
+			if (!GlobalStorage::WriteFileFromBytes(filePath, *bytes)) [[unlikely]]
+			{
+				failedFiles.emplace_back(filePath.generic_string());
+			}
+		}
+		TE_TRACE("Wrote {} files, {} failed", _writingWrites.size(), failedFiles.size());
+		lock.lock();
+
+		// Contents never reached storage, later reads should not see them either.
+		for (const std::string &key : failedFiles)
+		{
+			if (auto it = _cache.find(key); it != _cache.end() && !_queuedWrites.contains(Path(key)))
+			{
+				_cacheSize -= it->second->size();
+				_cache.erase(it);
+			}
+		}
+
+		_writingWrites.clear();
+		_flushCV.notify_all();
+	}
+}
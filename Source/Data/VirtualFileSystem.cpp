@@ -21,13 +21,17 @@
 #include "Util/LuaUtils.hpp"
 #include "Util/Utils.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <variant>
 #include <vector>
 #include <winscard.h>
@@ -70,7 +74,7 @@ size_t VirtualFileSystem::DirectoryNode::GetSize() const noexcept
 		{
 			if (std::holds_alternative<FileNode>(childNode))
 			{
-				cachedSize += std::get<FileNode>(childNode).bytes.size();
+				cachedSize += std::get<FileNode>(childNode).GetSize();
 			}
 			else if (std::holds_alternative<DirectoryNode>(childNode))
 			{
@@ -85,18 +89,63 @@ size_t VirtualFileSystem::DirectoryNode::GetSize() const noexcept
 	return cachedSize;
 }
 
-VirtualFileSystem::FileNode::FileNode(const std::vector<std::byte> &bytes, EResourceType resourceType) noexcept
-    : bytes(bytes),
+VirtualFileSystem::FileNode::FileNode(std::span<const std::byte> borrowedBytes, std::shared_ptr<const void> owner, EResourceType resourceType) noexcept
+    : borrowedBytes(borrowedBytes),
+      owner(std::move(owner)),
+      blobHash(),
+      loader(),
+      loaded(true),
+      size(borrowedBytes.size()),
+      lastAccess(0),
       resourceType(resourceType),
       CommonNode()
 {
 }
 
+VirtualFileSystem::FileNode::FileNode(std::shared_ptr<const Blob> blob) noexcept
+    : borrowedBytes(blob->bytes),
+      owner(blob),
+      blobHash(blob->hash),
+      loader(),
+      loaded(true),
+      size(blob->bytes.size()),
+      lastAccess(0),
+      resourceType(EResourceType::Unknown),
+      CommonNode()
+{
+}
+
+VirtualFileSystem::FileNode::FileNode(FileLoader loader, std::size_t size) noexcept
+    : borrowedBytes(),
+      owner(nullptr),
+      blobHash(),
+      loader(std::move(loader)),
+      loaded(false),
+      size(size),
+      lastAccess(0),
+      resourceType(EResourceType::Unknown),
+      CommonNode()
+{
+}
+
+std::span<const std::byte> VirtualFileSystem::FileNode::GetBytes() const noexcept
+{
+	return borrowedBytes;
+}
+
+std::size_t VirtualFileSystem::FileNode::GetSize() const noexcept
+{
+	return loaded ? GetBytes().size() : size;
+}
+
 #pragma region VirtualFileSystem
 
 VirtualFileSystem::VirtualFileSystem(Context &context) noexcept
     : _context(context),
-      _rootNode()
+      _rootNode(),
+      _accessCounter(0),
+      _pathIndex(),
+      _blobStore()
 {
 }
 
@@ -135,23 +184,37 @@ VirtualFileSystem::RemountFileEvent &VirtualFileSystem::GetOnRemountFile() noexc
 	return _onRemountFile;
 }
 
+BlobStore &VirtualFileSystem::GetBlobStore() noexcept
+{
+	return _blobStore;
+}
+
 void VirtualFileSystem::MountDirectory(const std::filesystem::path &path) noexcept
 {
 	TE_DEBUG("Mount directory \"{}\"", path.generic_string());
 
 	DirectoryNode *currentDirectory = &std::get<DirectoryNode>(_rootNode);
+	std::string key;
 
 	for (const auto &part : path)
 	{
 		auto partStr = part.generic_string();
-		auto &children = currentDirectory->children;
+		AppendIndexKey(key, partStr);
 
-		if (children.find(partStr) == children.end())
+		auto &children = currentDirectory->children;
+		auto it = children.find(partStr);
+		if (it == children.end())
 		{
-			children[partStr] = DirectoryNode{};
+			it = children.emplace(partStr, DirectoryNode{}).first;
+			_pathIndex.emplace(key, &it->second);
 		}
 
-		currentDirectory = &std::get<DirectoryNode>(children[partStr]);
+		currentDirectory = std::get_if<DirectoryNode>(&it->second);
+		if (currentDirectory == nullptr) [[unlikely]]
+		{
+			TE_ERROR("Failed to mount directory \"{}\": \"{}\" is a file", path.generic_string(), partStr);
+			return;
+		}
 	}
 }
 
@@ -164,45 +227,110 @@ void VirtualFileSystem::MountFile(const std::filesystem::path &path) noexcept
 	}
 
 	std::vector<std::byte> bytes{std::istreambuf_iterator<std::byte>(stream), std::istreambuf_iterator<std::byte>()};
-	MountFile(path, bytes);
+	TE_DEBUG("Mount file \"{}\"", path.generic_string());
+
+	EmplaceFileNode(path, FileNode(_blobStore.Intern(std::move(bytes))));
 }
 
 void VirtualFileSystem::MountFile(const std::filesystem::path &path, std::span<const std::byte> bytes) noexcept
 {
 	TE_DEBUG("Mount file \"{}\"", path.generic_string());
 
+	EmplaceFileNode(path, FileNode(_blobStore.Intern(bytes)));
+}
+
+void VirtualFileSystem::MountFile(const std::filesystem::path &path, std::vector<std::byte> &&bytes) noexcept
+{
+	TE_DEBUG("Mount file \"{}\"", path.generic_string());
+
+	EmplaceFileNode(path, FileNode(_blobStore.Intern(std::move(bytes))));
+}
+
+void VirtualFileSystem::MountFileView(const std::filesystem::path &path, std::span<const std::byte> bytes, std::shared_ptr<const void> owner) noexcept
+{
+	TE_DEBUG("Mount file view \"{}\"", path.generic_string());
+
+	EmplaceFileNode(path, FileNode(bytes, std::move(owner), EResourceType::Unknown));
+}
+
+void VirtualFileSystem::MountFileLazy(const std::filesystem::path &path, FileLoader loader, std::size_t size) noexcept
+{
+	TE_DEBUG("Mount lazy file \"{}\"", path.generic_string());
+
+	EmplaceFileNode(path, FileNode(std::move(loader), size));
+}
+
+void VirtualFileSystem::EmplaceFileNode(const std::filesystem::path &path, FileNode &&fileNode) noexcept
+{
 	DirectoryNode *currentDirectory = &std::get<DirectoryNode>(_rootNode);
+	std::string key;
 
-	bool mounted = false;
 	for (const auto &part : path)
 	{
 		const std::string &partStr = part.generic_string();
+		AppendIndexKey(key, partStr);
+
+		auto &children = currentDirectory->children;
+		auto it = children.find(partStr);
 
 		if (part.has_extension()) // TODO or this is the last part, then we assume it is a file ... right?
 		{
-			auto result = currentDirectory->children.emplace(
-			    partStr,
-			    FileNode(std::vector<std::byte>(bytes.begin(), bytes.end()), EResourceType::Unknown));
-			if (!result.second) [[unlikely]]
+			if (it == children.end())
 			{
-				TE_FATAL("Failed to add child node \"{}\"", partStr);
+				it = children.emplace(partStr, std::move(fileNode)).first;
+				_pathIndex.emplace(key, &it->second);
+
+				auto &fileNode_ = std::get<FileNode>(it->second);
+				if (fileNode_.loaded)
+				{
+					_onMountFile.Invoke(path, fileNode_.GetBytes(), fileNode_.resourceType);
+				}
+			}
+			else if (auto *existingFileNode = std::get_if<FileNode>(&it->second))
+			{
+				// Later mounts take precedence, e.g. developer files over packaged ones.
+				TE_DEBUG("Replace mounted file \"{}\"", path.generic_string());
+
+				// Keep old contents alive until handlers are done with them.
+				FileNode oldFileNode = std::move(*existingFileNode);
+				*existingFileNode = std::move(fileNode);
+
+				// Unloaded lazy files were never announced, and announce themselves once loaded.
+				if (oldFileNode.loaded && existingFileNode->loaded)
+				{
+					_onRemountFile.Invoke(path, existingFileNode->GetBytes(), oldFileNode.GetBytes(), existingFileNode->resourceType);
+				}
+				else if (oldFileNode.loaded)
+				{
+					_onDismountFile.Invoke(path);
+				}
+				else if (existingFileNode->loaded)
+				{
+					_onMountFile.Invoke(path, existingFileNode->GetBytes(), existingFileNode->resourceType);
+				}
+			}
+			else [[unlikely]]
+			{
+				TE_ERROR("Failed to mount file \"{}\": a directory is mounted at this path", path.generic_string());
+				return;
 			}
 
-			auto &fileNode_ = std::get<FileNode>(result.first->second);
-			_onMountFile.Invoke(path, fileNode_.bytes, fileNode_.resourceType);
 			ClearParentDirectoriesCache(path);
-
 			break;
 		}
 
-		auto &children = currentDirectory->children;
-
-		if (children.find(partStr) == children.end())
+		if (it == children.end())
 		{
-			children.emplace(partStr, DirectoryNode());
+			it = children.emplace(partStr, DirectoryNode()).first;
+			_pathIndex.emplace(key, &it->second);
 		}
 
-		currentDirectory = &std::get<DirectoryNode>(children[partStr]);
+		currentDirectory = std::get_if<DirectoryNode>(&it->second);
+		if (currentDirectory == nullptr) [[unlikely]]
+		{
+			TE_ERROR("Failed to mount file \"{}\": \"{}\" is a file", path.generic_string(), partStr);
+			return;
+		}
 	}
 }
 
@@ -210,70 +338,59 @@ bool VirtualFileSystem::DismountDirectory(const std::filesystem::path &path) noe
 {
 	TE_DEBUG("Dismount directory \"{}\"", path.generic_string());
 
-	DirectoryNode *currentDirectory = &std::get<DirectoryNode>(_rootNode);
-	std::vector<std::string> parts;
-
-	for (const auto &part : path)
+	// Key is used up before any event is invoked, so reusing buffer is safe.
+	thread_local std::string buffer;
+	std::string_view key = ToIndexKey(path, buffer);
+	Node *node = FindKeyedNode(key);
+	if (node == nullptr || node == &_rootNode || !std::holds_alternative<DirectoryNode>(*node))
 	{
-		parts.push_back(part.generic_string());
+		return false;
 	}
 
-	auto &children = currentDirectory->children;
-	for (const auto &part : parts)
+	Node *parentNode = FindNode(path.parent_path());
+	if (parentNode == nullptr || !std::holds_alternative<DirectoryNode>(*parentNode)) [[unlikely]]
 	{
-		if (children.find(part) == children.end())
-		{
-			return false;
-		}
-
-		currentDirectory = &std::get<DirectoryNode>(children[part]);
+		return false;
 	}
 
-	if (children.erase(parts.back()))
-	{
-		_onDismountDirectory.Invoke(path);
+	UnindexNode(key, *node);
+	std::get<DirectoryNode>(*parentNode).children.erase(GetLastPart(path));
+	_onDismountDirectory.Invoke(path);
+	ClearParentDirectoriesCache(path);
 
-		return true;
-	}
-	return false;
+	return true;
 }
 
 bool VirtualFileSystem::DismountFile(const std::filesystem::path &path) noexcept
 {
 	TE_DEBUG("Dismount file \"{}\"", path.generic_string());
 
-	DirectoryNode *currentDirectory = &std::get<DirectoryNode>(_rootNode);
-
-	auto itLast = path.end();
-	--itLast;
-
-	for (auto it = path.begin(); it != path.end(); ++it)
+	thread_local std::string buffer;
+	auto it = _pathIndex.find(ToIndexKey(path, buffer));
+	if (it == _pathIndex.end() || !std::holds_alternative<FileNode>(*it->second))
 	{
-		auto partStr = it->generic_string();
-		auto &children = currentDirectory->children;
-
-		if (children.find(partStr) == children.end())
-		{
-			return false;
-		}
-
-		if (it == itLast)
-		{
-			bool result = currentDirectory->children.erase(partStr);
-			if (result)
-			{
-				_onDismountFile.Invoke(path);
+		return false;
+	}
+	Node *node = it->second;
 
-				return true;
-			}
+	Node *parentNode = FindNode(path.parent_path());
+	if (parentNode == nullptr || !std::holds_alternative<DirectoryNode>(*parentNode)) [[unlikely]]
+	{
+		return false;
+	}
 
-			return result;
-		}
+	// Lazy files not loaded yet were never announced.
+	bool announced = std::get<FileNode>(*node).loaded;
 
-		currentDirectory = &std::get<DirectoryNode>(children.at(partStr));
+	_pathIndex.erase(it);
+	std::get<DirectoryNode>(*parentNode).children.erase(GetLastPart(path));
+	if (announced)
+	{
+		_onDismountFile.Invoke(path);
 	}
+	ClearParentDirectoriesCache(path);
 
-	return false;
+	return true;
 }
 
 bool VirtualFileSystem::RemountFile(const std::filesystem::path &path, const std::vector<std::byte> &bytes) noexcept
@@ -284,11 +401,11 @@ bool VirtualFileSystem::RemountFile(const std::filesystem::path &path, const std
 	if (node != nullptr && std::holds_alternative<FileNode>(*node))
 	{
 		auto &fileNode = std::get<FileNode>(*node);
-		auto &oldBytes = fileNode.bytes;
-		fileNode.bytes = bytes;
-		fileNode.resourceType = EResourceType::Unknown;
+		// Keep old contents alive until handlers are done with them.
+		FileNode oldFileNode = std::move(fileNode);
+		fileNode = FileNode(_blobStore.Intern(std::span<const std::byte>(bytes)));
 
-		_onRemountFile.Invoke(path, fileNode.bytes, oldBytes, fileNode.resourceType);
+		_onRemountFile.Invoke(path, fileNode.GetBytes(), oldFileNode.GetBytes(), fileNode.resourceType);
 		ClearParentDirectoriesCache(path);
 
 		return true;
@@ -346,7 +463,7 @@ std::chrono::time_point<std::chrono::system_clock> VirtualFileSystem::GetPathDat
 	}
 }
 
-std::span<std::byte> VirtualFileSystem::GetFileBytes(const std::filesystem::path &file)
+std::span<const std::byte> VirtualFileSystem::GetFileBytes(const std::filesystem::path &file)
 {
 	Node *node = FindNode(file);
 	if (node == nullptr) [[unlikely]]
@@ -359,7 +476,35 @@ std::span<std::byte> VirtualFileSystem::GetFileBytes(const std::filesystem::path
 		throw std::runtime_error("path is not file");
 	}
 
-	return std::get<FileNode>(*node).bytes;
+	FileNode &fileNode = std::get<FileNode>(*node);
+	if (!LoadFileNode(file, fileNode)) [[unlikely]]
+	{
+		throw std::runtime_error("failed to load file");
+	}
+	return fileNode.GetBytes();
+}
+
+std::span<const std::byte> VirtualFileSystem::GetIndexedFileBytes(std::string_view file)
+{
+	Node *node = FindIndexedNode(file);
+	if (node == nullptr) [[unlikely]]
+	{
+		throw std::runtime_error("file not found");
+	}
+
+	if (!std::holds_alternative<FileNode>(*node)) [[unlikely]]
+	{
+		throw std::runtime_error("path is not file");
+	}
+
+	FileNode &fileNode = std::get<FileNode>(*node);
+	if (!fileNode.loaded && !LoadFileNode(std::filesystem::path(file), fileNode)) [[unlikely]]
+	{
+		throw std::runtime_error("failed to load file");
+	}
+	fileNode.lastAccess = ++_accessCounter;
+
+	return fileNode.GetBytes();
 }
 
 EResourceType VirtualFileSystem::GetFileResourceType(const std::filesystem::path &file)
@@ -378,6 +523,16 @@ EResourceType VirtualFileSystem::GetFileResourceType(const std::filesystem::path
 	return std::get<FileNode>(*node).resourceType;
 }
 
+std::optional<BlobHash> VirtualFileSystem::GetFileBlobHash(const std::filesystem::path &file) noexcept
+{
+	Node *node = FindNode(file);
+	if (node == nullptr || !std::holds_alternative<FileNode>(*node))
+	{
+		return std::nullopt;
+	}
+	return std::get<FileNode>(*node).blobHash;
+}
+
 std::size_t VirtualFileSystem::GetPathSize(const std::filesystem::path &file) const
 {
 	const Node *node = FindNode(file);
@@ -388,7 +543,7 @@ std::size_t VirtualFileSystem::GetPathSize(const std::filesystem::path &file) co
 
 	if (std::holds_alternative<FileNode>(*node))
 	{
-		return std::get<FileNode>(*node).bytes.size();
+		return std::get<FileNode>(*node).GetSize();
 	}
 	else if (std::holds_alternative<DirectoryNode>(*node))
 	{
@@ -400,6 +555,100 @@ std::size_t VirtualFileSystem::GetPathSize(const std::filesystem::path &file) co
 	}
 }
 
+bool VirtualFileSystem::Load(const std::filesystem::path &file) noexcept
+{
+	Node *node = FindNode(file);
+	if (node == nullptr || !std::holds_alternative<FileNode>(*node))
+	{
+		return false;
+	}
+
+	return LoadFileNode(file, std::get<FileNode>(*node));
+}
+
+bool VirtualFileSystem::LoadIndexed(std::string_view file) noexcept
+{
+	Node *node = FindIndexedNode(file);
+	if (node == nullptr || !std::holds_alternative<FileNode>(*node))
+	{
+		return false;
+	}
+
+	FileNode &fileNode = std::get<FileNode>(*node);
+	if (fileNode.loaded) [[likely]]
+	{
+		fileNode.lastAccess = ++_accessCounter;
+		return true;
+	}
+	return LoadFileNode(std::filesystem::path(file), fileNode);
+}
+
+bool VirtualFileSystem::Evict(const std::filesystem::path &file) noexcept
+{
+	Node *node = FindNode(file);
+	if (node == nullptr || !std::holds_alternative<FileNode>(*node))
+	{
+		return false;
+	}
+
+	FileNode &fileNode = std::get<FileNode>(*node);
+	if (!fileNode.loader || !fileNode.loaded)
+	{
+		return false;
+	}
+
+	EvictFileNode(file, fileNode);
+	return true;
+}
+
+std::size_t VirtualFileSystem::EvictCold(std::size_t keepBytes) noexcept
+{
+	std::vector<std::tuple<std::uint64_t, std::filesystem::path, FileNode *>> candidates;
+	std::size_t loadedSize = 0;
+
+	ForeachLoadedLazyFileNode("", std::get<DirectoryNode>(_rootNode), [&](const std::filesystem::path &path, FileNode &fileNode)
+	{
+		candidates.emplace_back(fileNode.lastAccess, path, &fileNode);
+		loadedSize += fileNode.GetSize();
+	});
+
+	std::sort(candidates.begin(), candidates.end(), [](const auto &l, const auto &r)
+	{
+		return std::get<0>(l) < std::get<0>(r);
+	});
+
+	std::size_t evictedSize = 0;
+	for (auto &[_, path, fileNode] : candidates)
+	{
+		if (loadedSize - evictedSize <= keepBytes)
+		{
+			break;
+		}
+
+		evictedSize += fileNode->GetSize();
+		EvictFileNode(path, *fileNode);
+	}
+
+	if (evictedSize != 0)
+	{
+		TE_DEBUG("Evicted {} bytes of lazy files", evictedSize);
+	}
+	return evictedSize;
+}
+
+std::size_t VirtualFileSystem::GetLazyLoadedSize() const noexcept
+{
+	std::size_t loadedSize = 0;
+
+	auto *self = const_cast<VirtualFileSystem *>(this);
+	self->ForeachLoadedLazyFileNode("", std::get<DirectoryNode>(self->_rootNode), [&loadedSize](const std::filesystem::path &, FileNode &fileNode)
+	{
+		loadedSize += fileNode.GetSize();
+	});
+
+	return loadedSize;
+}
+
 std::vector<VirtualFileSystem::ListEntry> VirtualFileSystem::List(const std::filesystem::path &directory, EPathListOption options) const
 {
 	const DirectoryNode *directoryNode;
@@ -467,27 +716,181 @@ void VirtualFileSystem::CollectListEntries(std::vector<ListEntry> &entries, cons
 
 VirtualFileSystem::Node *VirtualFileSystem::FindNode(const std::filesystem::path &path) noexcept
 {
-	Node *currentNode = &_rootNode;
+	// Keeps its capacity, so lookups stop allocating once it fits the longest path.
+	thread_local std::string buffer;
+	return FindKeyedNode(ToIndexKey(path, buffer));
+}
+
+VirtualFileSystem::Node *VirtualFileSystem::FindIndexedNode(std::string_view path) noexcept
+{
+	std::string buffer;
+	return FindKeyedNode(ToIndexKey(path, buffer));
+}
 
+VirtualFileSystem::Node *VirtualFileSystem::FindKeyedNode(std::string_view key) noexcept
+{
+	if (key.empty())
+	{
+		return &_rootNode;
+	}
+
+	auto it = _pathIndex.find(key);
+	return it != _pathIndex.end() ? it->second : nullptr;
+}
+
+void VirtualFileSystem::UnindexNode(std::string_view key, const Node &node) noexcept
+{
+	if (auto it = _pathIndex.find(key); it != _pathIndex.end())
+	{
+		_pathIndex.erase(it);
+	}
+
+	if (std::holds_alternative<DirectoryNode>(node))
+	{
+		for (const auto &[name, child] : std::get<DirectoryNode>(node).children)
+		{
+			std::string childKey{key};
+			AppendIndexKey(childKey, name);
+			UnindexNode(childKey, child);
+		}
+	}
+}
+
+void VirtualFileSystem::AppendIndexKey(std::string &key, std::string_view part) noexcept
+{
+	if (!key.empty())
+	{
+		key.push_back('/');
+	}
+	key.append(part);
+}
+
+std::string VirtualFileSystem::ToIndexKey(const std::filesystem::path &path) noexcept
+{
+	std::string key;
 	for (const auto &part : path)
 	{
-		auto partStr = part.generic_string();
+		std::string partStr = part.generic_string();
+		if (!partStr.empty())
+		{
+			AppendIndexKey(key, partStr);
+		}
+	}
+	return key;
+}
+
+std::string_view VirtualFileSystem::ToIndexKey(const std::filesystem::path &path, std::string &buffer) noexcept
+{
+	using Char = std::filesystem::path::value_type;
 
-		if (!std::holds_alternative<DirectoryNode>(*currentNode))
+	// Narrow native path into buffer directly, only non ASCII paths go through conversion.
+	buffer.clear();
+	for (Char ch : path.native())
+	{
+		if (static_cast<std::make_unsigned_t<Char>>(ch) > 0x7F) [[unlikely]]
 		{
-			return nullptr;
+			buffer = path.generic_string();
+			break;
 		}
+		buffer.push_back(ch == std::filesystem::path::preferred_separator ? '/' : static_cast<char>(ch));
+	}
+
+	return ToIndexKey(std::string_view(buffer), buffer);
+}
 
-		auto &children = std::get<DirectoryNode>(*currentNode).children;
-		if (children.find(partStr) == children.end())
+std::string_view VirtualFileSystem::ToIndexKey(std::string_view path, std::string &buffer) noexcept
+{
+	if (path.empty())
+	{
+		return path;
+	}
+
+	// Plain relative paths are keys already, which covers nearly all lookups.
+	bool plain = path.find_first_of("\\:") == std::string_view::npos && path.find("//") == std::string_view::npos &&
+	             path.front() != '/' && path.back() != '/';
+	if (plain) [[likely]]
+	{
+		return path;
+	}
+
+	buffer = ToIndexKey(std::filesystem::path(path));
+	return buffer;
+}
+
+std::string VirtualFileSystem::GetLastPart(const std::filesystem::path &path) noexcept
+{
+	std::string last;
+	for (const auto &part : path)
+	{
+		std::string partStr = part.generic_string();
+		if (!partStr.empty())
 		{
-			return nullptr;
+			last = std::move(partStr);
 		}
+	}
+	return last;
+}
+
+bool VirtualFileSystem::LoadFileNode(const std::filesystem::path &path, FileNode &fileNode) noexcept
+{
+	fileNode.lastAccess = ++_accessCounter;
+	if (fileNode.loaded) [[likely]]
+	{
+		return true;
+	}
 
-		currentNode = &children.at(partStr);
+	std::shared_ptr<const Blob> blob;
+	try
+	{
+		blob = _blobStore.Intern(fileNode.loader());
 	}
+	catch (const std::exception &e)
+	{
+		TE_ERROR("Failed to load file \"{}\": {}", path.generic_string(), e.what());
+		return false;
+	}
+
+	TE_TRACE("Loaded lazy file \"{}\", {} bytes", path.generic_string(), blob->bytes.size());
 
-	return currentNode;
+	fileNode.borrowedBytes = blob->bytes;
+	fileNode.blobHash = blob->hash;
+	fileNode.owner = std::move(blob);
+	fileNode.loaded = true;
+	fileNode.size = fileNode.borrowedBytes.size();
+	_onMountFile.Invoke(path, fileNode.GetBytes(), fileNode.resourceType);
+	ClearParentDirectoriesCache(path);
+
+	return true;
+}
+
+void VirtualFileSystem::EvictFileNode(const std::filesystem::path &path, FileNode &fileNode) noexcept
+{
+	_onDismountFile.Invoke(path);
+
+	fileNode.borrowedBytes = {};
+	fileNode.owner = nullptr;
+	fileNode.blobHash = std::nullopt;
+	fileNode.loaded = false;
+	fileNode.resourceType = EResourceType::Unknown;
+}
+
+void VirtualFileSystem::ForeachLoadedLazyFileNode(const std::filesystem::path &directory, DirectoryNode &directoryNode, const std::function<void(const std::filesystem::path &, FileNode &)> &func) noexcept
+{
+	for (auto &[name, child] : directoryNode.children)
+	{
+		if (std::holds_alternative<FileNode>(child))
+		{
+			FileNode &fileNode = std::get<FileNode>(child);
+			if (fileNode.loader && fileNode.loaded)
+			{
+				func(directory / name, fileNode);
+			}
+		}
+		else if (std::holds_alternative<DirectoryNode>(child))
+		{
+			ForeachLoadedLazyFileNode(directory / name, std::get<DirectoryNode>(child), func);
+		}
+	}
 }
 
 void VirtualFileSystem::ClearParentDirectoriesCache(const std::filesystem::path &path) const
@@ -499,7 +902,7 @@ void VirtualFileSystem::ClearParentDirectoriesCache(const std::filesystem::path
 		auto *node = FindNode(directory);
 		TE_ASSERT(node != nullptr);
 		TE_ASSERT(std::holds_alternative<DirectoryNode>(*node));
-		auto directoryNode = std::get<DirectoryNode>(*node);
+		auto &directoryNode = std::get<DirectoryNode>(*node);
 		directoryNode.cached = false;
 
 		directory = directory.parent_path();
@@ -508,18 +911,12 @@ void VirtualFileSystem::ClearParentDirectoriesCache(const std::filesystem::path
 
 bool VirtualFileSystem::LuaExists(sol::object path)
 {
-	std::filesystem::path path_;
-	if (path.is<sol::string_view>())
-	{
-		path_ = std::filesystem::path(path.as<sol::string_view>());
-	}
-	else [[unlikely]]
+	if (!path.is<sol::string_view>()) [[unlikely]]
 	{
-		LuaUtils::Deconstruct(path_);
 		throw std::runtime_error(std::format("bad argument #2 to 'path' (string expected, got {})", GetLuaTypeStringView(path.get_type())));
 	}
 
-	return Exists(path_);
+	return FindIndexedNode(path.as<sol::string_view>()) != nullptr;
 }
 
 sol::table VirtualFileSystem::LuaList(sol::object directory, sol::object options)
@@ -592,10 +989,10 @@ std::string VirtualFileSystem::LuaReadFile(sol::object file)
 {
 	try
 	{
-		std::filesystem::path file_;
+		std::string_view file_;
 		if (file.is<sol::string_view>())
 		{
-			file_ = std::filesystem::path(file.as<sol::string_view>());
+			file_ = file.as<sol::string_view>();
 		}
 		else if (file.is<sol::nil_t>())
 		{
@@ -603,11 +1000,10 @@ std::string VirtualFileSystem::LuaReadFile(sol::object file)
 		}
 		else [[unlikely]]
 		{
-			LuaUtils::Deconstruct(file_);
 			GetScriptEngine().ThrowError("bad argument #2 to 'file' (string or nil expected, got {})", GetLuaTypeStringView(file.get_type()));
 		}
 
-		std::span<std::byte> bytes = GetFileBytes(file_);
+		std::span<const std::byte> bytes = GetIndexedFileBytes(file_);
 		return std::string(reinterpret_cast<const char *>(bytes.data()), bytes.size());
 	}
 	catch (const std::exception &e)
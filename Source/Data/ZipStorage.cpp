@@ -1,5 +1,5 @@
 /**
- * @file data/ZipStorage.cpp
+ * @file Data/ZipStorage.cpp
  * @author JagYayu
  * @brief
  * @version 1.0
@@ -12,6 +12,7 @@
 #include "Data/ZipStorage.hpp"
 
 #include "Data/HierarchyIterationResult.hpp"
+#include "Data/MappedFile.hpp"
 #include "Data/PathType.hpp"
 
 #include <filesystem>
@@ -19,13 +20,14 @@
 #include <minizip/ioapi.h>
 #include <minizip/unzip.h>
 
+#include <cstring>
 #include <span>
 #include <stdexcept>
 #include <vector>
 
 using namespace tudov;
 
-struct MemoryBuffer
+struct ZipStorage::MemoryBuffer
 {
 	const char *base;
 	size_t size;
@@ -34,14 +36,14 @@ struct MemoryBuffer
 
 static voidpf MemOpen(voidpf opaque, const char *filename, int mode)
 {
-	auto *mem = static_cast<MemoryBuffer *>(opaque);
+	auto *mem = static_cast<ZipStorage::MemoryBuffer *>(opaque);
 	mem->position = 0;
 	return opaque;
 }
 
 static uLong MemRead(voidpf opaque, voidpf stream, void *buf, uLong size)
 {
-	auto *mem = static_cast<MemoryBuffer *>(opaque);
+	auto *mem = static_cast<ZipStorage::MemoryBuffer *>(opaque);
 	uLong remaining = static_cast<uLong>(mem->size - mem->position);
 	uLong readSize = (size < remaining) ? size : remaining;
 	std::memcpy(buf, mem->base + mem->position, readSize);
@@ -51,13 +53,13 @@ static uLong MemRead(voidpf opaque, voidpf stream, void *buf, uLong size)
 
 static long MemTell(voidpf opaque, voidpf stream)
 {
-	auto *mem = static_cast<MemoryBuffer *>(opaque);
+	auto *mem = static_cast<ZipStorage::MemoryBuffer *>(opaque);
 	return static_cast<long>(mem->position);
 }
 
 static long MemSeek(voidpf opaque, voidpf stream, uLong offset, int origin)
 {
-	auto *mem = static_cast<MemoryBuffer *>(opaque);
+	auto *mem = static_cast<ZipStorage::MemoryBuffer *>(opaque);
 	size_t newpos;
 	switch (origin)
 	{
@@ -91,37 +93,152 @@ static int MemError(voidpf opaque, voidpf stream)
 	return 0;
 }
 
-void FillMemoryFileFunc(std::vector<std::byte> &data, zlib_filefunc_def *filefuncs)
+static void *OpenMemory(ZipStorage::MemoryBuffer &memoryBuffer) noexcept
 {
-	static MemoryBuffer static_buffer;
-	static_buffer.base = reinterpret_cast<char *>(data.data());
-	static_buffer.size = data.size();
-	static_buffer.position = 0;
-
-	filefuncs->zopen_file = MemOpen;
-	filefuncs->zread_file = MemRead;
-	filefuncs->ztell_file = MemTell;
-	filefuncs->zseek_file = MemSeek;
-	filefuncs->zclose_file = MemClose;
-	filefuncs->zerror_file = MemError;
-	filefuncs->opaque = &static_buffer;
+	zlib_filefunc_def filefuncDef{};
+	filefuncDef.zopen_file = MemOpen;
+	filefuncDef.zread_file = MemRead;
+	filefuncDef.ztell_file = MemTell;
+	filefuncDef.zseek_file = MemSeek;
+	filefuncDef.zclose_file = MemClose;
+	filefuncDef.zerror_file = MemError;
+	filefuncDef.opaque = &memoryBuffer;
+
+	return unzOpen2(nullptr, &filefuncDef);
 }
 
-ZipStorage::ZipStorage(std::span<std::byte> data)
-    : _bytes(data.begin(), data.end())
+ZipStorage::ZipStorage(std::span<const std::byte> data)
+    : _mappedFile(nullptr),
+      _ownedBytes(data.begin(), data.end()),
+      _bytes(_ownedBytes),
+      _memoryBuffer(std::make_unique<MemoryBuffer>()),
+      _unzip(nullptr)
 {
-	zlib_filefunc_def filefuncDef{};
-	FillMemoryFileFunc(_bytes, &filefuncDef);
+	Open();
+}
+
+ZipStorage::ZipStorage(std::shared_ptr<const MappedFile> mappedFile)
+    : _mappedFile(std::move(mappedFile)),
+      _ownedBytes(),
+      _bytes(_mappedFile->GetBytes()),
+      _memoryBuffer(std::make_unique<MemoryBuffer>()),
+      _unzip(nullptr)
+{
+	Open();
+}
+
+ZipStorage::~ZipStorage() noexcept
+{
+	if (_unzip != nullptr)
+	{
+		unzClose(_unzip);
+	}
+}
+
+void ZipStorage::Open()
+{
+	*_memoryBuffer = MemoryBuffer{
+	    .base = reinterpret_cast<const char *>(_bytes.data()),
+	    .size = _bytes.size(),
+	    .position = 0,
+	};
 
-	_unzip = unzOpen2(nullptr, &filefuncDef);
+	_unzip = OpenMemory(*_memoryBuffer);
 	if (!_unzip)
 	{
 		throw std::runtime_error("Failed to open ZIP from memory.");
 	}
+
+	BuildIndex();
 }
 
-ZipStorage::~ZipStorage() noexcept
+void ZipStorage::BuildIndex()
 {
+	unz_global_info64 globalInfo;
+	if (unzGetGlobalInfo64(_unzip, &globalInfo) == UNZ_OK)
+	{
+		_entries.reserve(static_cast<std::size_t>(globalInfo.number_entry));
+		_entryIndices.reserve(static_cast<std::size_t>(globalInfo.number_entry));
+	}
+
+	if (unzGoToFirstFile(_unzip) != UNZ_OK)
+	{
+		// Empty archive.
+		return;
+	}
+
+	do
+	{
+		unz_file_info64 info;
+		if (unzGetCurrentFileInfo64(_unzip, &info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK) [[unlikely]]
+		{
+			continue;
+		}
+
+		std::string name(info.size_filename, '\0');
+		unz64_file_pos position;
+		if (unzGetCurrentFileInfo64(_unzip, nullptr, name.data(), static_cast<uLong>(name.size()), nullptr, 0, nullptr, 0) != UNZ_OK ||
+		    unzGetFilePos64(_unzip, &position) != UNZ_OK) [[unlikely]]
+		{
+			continue;
+		}
+
+		// First one wins on duplicated names, same as `unzLocateFile`.
+		if (_entryIndices.contains(name)) [[unlikely]]
+		{
+			continue;
+		}
+
+		_entryIndices.emplace(name, _entries.size());
+		_entries.emplace_back(Entry{
+		    .name = std::move(name),
+		    .directoryPosition = position.pos_in_zip_directory,
+		    .fileNumber = position.num_of_file,
+		    .compressedSize = info.compressed_size,
+		    .uncompressedSize = info.uncompressed_size,
+		    .stored = info.compression_method == 0 && (info.flag & 1) == 0,
+		});
+	} while (unzGoToNextFile(_unzip) == UNZ_OK);
+}
+
+const ZipStorage::Entry *ZipStorage::FindEntry(const std::filesystem::path &filePath) const noexcept
+{
+	auto it = _entryIndices.find(filePath.generic_string());
+	return it != _entryIndices.end() ? &_entries[it->second] : nullptr;
+}
+
+std::vector<std::byte> ZipStorage::ReadEntry(void *unzip, const Entry &entry) const
+{
+	unz64_file_pos position{
+	    .pos_in_zip_directory = entry.directoryPosition,
+	    .num_of_file = entry.fileNumber,
+	};
+	if (unzGoToFilePos64(unzip, &position) != UNZ_OK)
+	{
+		throw std::runtime_error("File not found in zip");
+	}
+
+	if (entry.uncompressedSize == 0)
+	{
+		return {};
+	}
+
+	if (unzOpenCurrentFile(unzip) != UNZ_OK)
+	{
+		throw std::runtime_error("Failed to open file in zip");
+	}
+
+	std::vector<std::byte> result{entry.uncompressedSize};
+
+	auto bytesRead = unzReadCurrentFile(unzip, result.data(), static_cast<unsigned int>(result.size()));
+	unzCloseCurrentFile(unzip);
+
+	if (bytesRead < 0 || static_cast<std::uint64_t>(bytesRead) != entry.uncompressedSize)
+	{
+		throw std::runtime_error("Failed to read complete file content");
+	}
+
+	return result;
 }
 
 bool ZipStorage::CanRead() noexcept
@@ -141,47 +258,26 @@ bool ZipStorage::IsReady() noexcept
 
 EHierarchyIterationResult ZipStorage::Foreach(const std::filesystem::path &directory, const EnumerationCallbackFunction<> &callback, void *callbackArgs) noexcept
 {
-	if (unzGoToFirstFile(_unzip) != UNZ_OK)
-	{
-		return EHierarchyIterationResult::Failure;
-	}
+	std::string prefix = directory.generic_string();
 
-	do
+	for (const Entry &entry : _entries)
 	{
-		char fileInZip[256];
-		unz_file_info64 info;
-		auto result = unzGetCurrentFileInfo64(
-		    _unzip,
-		    &info,
-		    fileInZip,
-		    sizeof(fileInZip),
-		    nullptr,
-		    0,
-		    nullptr,
-		    0);
-
-		if (result != UNZ_OK)
-		{
-			continue;
-		}
-
-		std::string fillPath{fileInZip};
-		if (fillPath.find(directory.generic_string()) == 0)
+		if (entry.name.starts_with(prefix))
 		{
-			EHierarchyIterationResult result = callback(fillPath, directory, callbackArgs);
+			EHierarchyIterationResult result = callback(entry.name, directory, callbackArgs);
 			if (result != EHierarchyIterationResult::Continue)
 			{
 				return result;
 			}
 		}
-	} while (unzGoToNextFile(_unzip) == UNZ_OK);
+	}
 
 	return EHierarchyIterationResult::Continue;
 }
 
 EHierarchyElement ZipStorage::Check(const std::filesystem::path &path) noexcept
 {
-	if (unzLocateFile(_unzip, path.generic_string().c_str(), true) == UNZ_OK)
+	if (FindEntry(path) != nullptr)
 	{
 		return EHierarchyElement::Data;
 	}
@@ -196,23 +292,13 @@ PathInfo ZipStorage::GetPathInfo(const std::filesystem::path &path) noexcept
 
 std::uint64_t ZipStorage::GetPathSize(const std::filesystem::path &filePath) noexcept
 {
-	if (unzLocateFile(_unzip, filePath.generic_string().c_str(), 1) != UNZ_OK)
-	{
-		return 0;
-	}
-
-	unz_file_info64 file_info;
-	if (unzGetCurrentFileInfo64(_unzip, &file_info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
-	{
-		return 0;
-	}
-
-	return file_info.uncompressed_size;
+	const Entry *entry = FindEntry(filePath);
+	return entry != nullptr ? entry->uncompressedSize : 0;
 }
 
 EPathType ZipStorage::GetPathType(const std::filesystem::path &filePath) noexcept
 {
-	if (unzLocateFile(_unzip, filePath.generic_string().c_str(), 1) != UNZ_OK)
+	if (FindEntry(filePath) == nullptr)
 	{
 		return EPathType::None;
 	}
@@ -231,38 +317,55 @@ EPathType ZipStorage::GetPathType(const std::filesystem::path &filePath) noexcep
 
 std::vector<std::byte> ZipStorage::ReadFileToBytes(const std::filesystem::path &filePath)
 {
-	if (unzLocateFile(_unzip, filePath.generic_string().c_str(), true) != UNZ_OK)
+	const Entry *entry = FindEntry(filePath);
+	if (entry == nullptr)
 	{
 		throw std::runtime_error("File not found in zip");
 	}
 
-	if (unzOpenCurrentFile(_unzip) != UNZ_OK)
+	return ReadEntry(_unzip, *entry);
+}
+
+std::span<const std::byte> ZipStorage::ReadFileView(const std::filesystem::path &filePath)
+{
+	const Entry *entry = FindEntry(filePath);
+	if (entry == nullptr)
 	{
-		throw std::runtime_error("Failed to open file in zip");
+		throw std::runtime_error("File not found in zip");
 	}
 
-	unz_file_info64 info;
-	if (unzGetCurrentFileInfo64(_unzip, &info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	if (auto it = _decompressed.find(entry->name); it != _decompressed.end())
 	{
-		unzCloseCurrentFile(_unzip);
-		throw std::runtime_error("Failed to get file info");
+		return it->second;
 	}
 
-	if (info.uncompressed_size == 0)
+	// Contents of stored entries are right after local header.
+	if (entry->stored)
 	{
+		unz64_file_pos position{
+		    .pos_in_zip_directory = entry->directoryPosition,
+		    .num_of_file = entry->fileNumber,
+		};
+		if (unzGoToFilePos64(_unzip, &position) != UNZ_OK || unzOpenCurrentFile(_unzip) != UNZ_OK)
+		{
+			throw std::runtime_error("Failed to open file in zip");
+		}
+		ZPOS64_T offset = unzGetCurrentFileZStreamPos64(_unzip);
 		unzCloseCurrentFile(_unzip);
-		return {};
-	}
-
-	std::vector<std::byte> result{info.uncompressed_size};
 
-	auto bytesRead = unzReadCurrentFile(_unzip, result.data(), static_cast<unsigned int>(result.size()));
-	unzCloseCurrentFile(_unzip);
-
-	if (bytesRead < 0 || static_cast<std::uint64_t>(bytesRead) != info.uncompressed_size)
-	{
-		throw std::runtime_error("Failed to read complete file content");
+		if (offset > _bytes.size() || entry->uncompressedSize > _bytes.size() - offset)
+		{
+			throw std::runtime_error("File content out of zip bounds");
+		}
+		return _bytes.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(entry->uncompressedSize));
 	}
 
-	return result;
+	auto [it, _] = _decompressed.emplace(entry->name, ReadEntry(_unzip, *entry));
+	return it->second;
+}
+
+bool ZipStorage::IsStored(const std::filesystem::path &filePath) noexcept
+{
+	const Entry *entry = FindEntry(filePath);
+	return entry != nullptr && entry->stored;
 }
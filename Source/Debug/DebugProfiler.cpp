@@ -11,6 +11,7 @@
 
 #include "Debug/DebugProfiler.hpp"
 #include "Debug/EventProfiler.hpp"
+#include "Debug/ScriptProfiler.hpp"
 #include "Event/EventManager.hpp"
 #include "Event/RuntimeEvent.hpp"
 #include "Mod/ScriptEngine.hpp"
@@ -23,6 +24,8 @@
 #include <algorithm>
 #include <array>
 #include <cfloat>
+#include <ctime>
+#include <format>
 #include <limits>
 
 using namespace tudov;
@@ -96,6 +99,41 @@ void DebugProfiler::UpdateAndRender(IWindow &window) noexcept
 
 		ImGui::Separator();
 
+		{
+			ScriptProfiler &scriptProfiler = window.GetEventManager().GetScriptProfiler();
+
+			if (scriptProfiler.IsRunning())
+			{
+				if (ImGui::Button("Stop sampling"))
+				{
+					scriptProfiler.Stop();
+				}
+			}
+			else if (ImGui::Button("Start sampling"))
+			{
+				scriptProfiler.Start();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Clear samples"))
+			{
+				scriptProfiler.Clear();
+			}
+			ImGui::SameLine();
+			ImGui::Text("Samples: %llu", static_cast<unsigned long long>(scriptProfiler.GetTotalSamples()));
+
+			if (ImGui::Button("Export collapsed stacks"))
+			{
+				scriptProfiler.Export(std::format("Profiles/{}.folded", std::time(nullptr)), EScriptProfileFormat::Collapsed);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Export chrome trace"))
+			{
+				scriptProfiler.Export(std::format("Profiles/{}.json", std::time(nullptr)), EScriptProfileFormat::ChromeTrace);
+			}
+		}
+
+		ImGui::Separator();
+
 		std::vector<DebugProfilerEntry> entries = CollectDebugProfilerEntries(window);
 
 		if (ImGui::Button("Trace all events"))
@@ -354,9 +354,7 @@ void DebugScripts::UpdateAndRenderProvidedScripts(IWindow &window) noexcept
 
 			if (ImGui::Button(std::format("Reload##{}", scriptID).data()))
 			{
-				std::vector<ScriptID> scriptIDs = scriptLoader.GetScriptDependencies(scriptID);
-				scriptIDs.emplace_back(scriptID);
-				scriptLoader.HotReloadScripts(scriptIDs);
+				scriptLoader.HotReloadScripts({scriptID});
 			}
 
 			ImGui::SameLine();
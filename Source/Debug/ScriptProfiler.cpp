@@ -0,0 +1,356 @@
+/**
+ * @file debug/ScriptProfiler.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Debug/ScriptProfiler.hpp"
+
+#include "Data/GlobalStorage.hpp"
+#include "Data/GlobalStorageManager.hpp"
+#include "Mod/ScriptEngine.hpp"
+#include "System/LogMicros.hpp"
+#include "Util/Utils.hpp"
+
+#include "json.hpp"
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iterator>
+#include <span>
+
+using namespace tudov;
+
+static constexpr std::string_view stackFormat = "FZ;";
+static constexpr std::string_view noEvent = "(no event)";
+static constexpr std::string_view noHandler = "(no handler)";
+
+static std::uint64_t GetProfilerTimeNS() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static sol::object GetJitProfileModule(sol::state_view lua) noexcept
+{
+	sol::table loaded = lua.registry()["_LOADED"];
+	return loaded["jit.profile"];
+}
+
+ScriptProfiler::ScriptProfiler(Context &context) noexcept
+    : _context(context),
+      _log(Log::Get("ScriptProfiler")),
+      _running(false),
+      _intervalMS(DefaultIntervalMS),
+      _stackDepth(DefaultStackDepth),
+      _beginNS(0),
+      _totalSamples(0)
+{
+}
+
+Context &ScriptProfiler::GetContext() noexcept
+{
+	return _context;
+}
+
+Log &ScriptProfiler::GetLog() noexcept
+{
+	return *_log;
+}
+
+bool ScriptProfiler::IsRunning() const noexcept
+{
+	return _running;
+}
+
+std::uint64_t ScriptProfiler::GetTotalSamples() const noexcept
+{
+	return _totalSamples;
+}
+
+bool ScriptProfiler::Start(std::uint32_t intervalMS, std::uint32_t stackDepth) noexcept
+{
+	if (_running)
+	{
+		return true;
+	}
+
+	try
+	{
+		sol::state_view lua = dynamic_cast<ScriptEngine &>(GetScriptEngine()).GetState();
+
+		sol::object profile = GetJitProfileModule(lua);
+		if (!profile.is<sol::table>()) [[unlikely]]
+		{
+			TE_WARN("{}", "Could not start profiler, module \"jit.profile\" is not loaded");
+			return false;
+		}
+
+		_intervalMS = std::max(intervalMS, 1u);
+		_stackDepth = std::max(stackDepth, 1u);
+		_dumpstack = profile.as<sol::table>()["dumpstack"];
+
+		if (_totalSamples == 0)
+		{
+			_beginNS = GetProfilerTimeNS();
+		}
+
+		sol::protected_function start = profile.as<sol::table>()["start"];
+		auto result = start(std::format("i{}", _intervalMS), [this](sol::object thread, std::uint32_t samples, sol::string_view vmstate)
+		{
+			sol::protected_function_result stack = _dumpstack(thread, stackFormat, -static_cast<std::int32_t>(_stackDepth));
+			AddSample(stack.valid() ? stack.get<std::string_view>() : std::string_view(), samples, vmstate.empty() ? 'I' : vmstate[0]);
+		});
+
+		if (!result.valid()) [[unlikely]]
+		{
+			sol::error err = result;
+			TE_ERROR("Failed to start profiler: {}", err.what());
+			_dumpstack = sol::lua_nil;
+			return false;
+		}
+	}
+	catch (std::exception &e)
+	{
+		TE_ERROR("Failed to start profiler: {}", e.what());
+		return false;
+	}
+
+	_running = true;
+	TE_DEBUG("Profiler started, interval {}ms, stack depth {}", _intervalMS, _stackDepth);
+	return true;
+}
+
+void ScriptProfiler::Stop() noexcept
+{
+	if (!_running)
+	{
+		return;
+	}
+	_running = false;
+
+	try
+	{
+		sol::state_view lua = dynamic_cast<ScriptEngine &>(GetScriptEngine()).GetState();
+
+		sol::object profile = GetJitProfileModule(lua);
+		if (profile.is<sol::table>()) [[likely]]
+		{
+			sol::protected_function stop = profile.as<sol::table>()["stop"];
+			stop();
+		}
+	}
+	catch (std::exception &e)
+	{
+		TE_ERROR("Failed to stop profiler: {}", e.what());
+	}
+
+	_dumpstack = sol::lua_nil;
+	_event = {};
+	_handler = {};
+
+	TE_DEBUG("Profiler stopped, {} samples in total", _totalSamples);
+}
+
+void ScriptProfiler::Clear() noexcept
+{
+	_totalSamples = 0;
+	_beginNS = GetProfilerTimeNS();
+	_stackIndices.clear();
+	_stacks.clear();
+	_stackSamples.clear();
+	_timeline.clear();
+}
+
+std::tuple<std::string_view, std::string_view> ScriptProfiler::Attribute(std::string_view event, std::string_view handler) noexcept
+{
+	std::tuple<std::string_view, std::string_view> previous{_event, _handler};
+	_event = event;
+	_handler = handler;
+	return previous;
+}
+
+void ScriptProfiler::AddSample(std::string_view stack, std::uint32_t count, char vmstate) noexcept
+{
+	_key.clear();
+	_key.append(_event.empty() ? noEvent : _event);
+	_key.push_back(';');
+	_key.append(_handler.empty() ? noHandler : _handler);
+	if (!stack.empty())
+	{
+		_key.push_back(';');
+		_key.append(stack);
+	}
+	switch (vmstate)
+	{
+	case 'G':
+		_key.append(";[GC]");
+		break;
+	case 'J':
+		_key.append(";[JIT]");
+		break;
+	default:
+		break;
+	}
+
+	std::uint32_t stackIndex;
+	if (auto it = _stackIndices.find(std::string_view(_key)); it != _stackIndices.end()) [[likely]]
+	{
+		stackIndex = it->second;
+	}
+	else [[unlikely]]
+	{
+		stackIndex = static_cast<std::uint32_t>(_stacks.size());
+		auto &&[inserted, _] = _stackIndices.try_emplace(_key, stackIndex);
+		_stacks.emplace_back(&inserted->first);
+		_stackSamples.emplace_back(0);
+	}
+
+	_stackSamples[stackIndex] += count;
+	_totalSamples += count;
+
+	if (_timeline.size() < TimelineLimit) [[likely]]
+	{
+		_timeline.emplace_back(Sample{
+		    .timeNS = GetProfilerTimeNS() - _beginNS,
+		    .stackIndex = stackIndex,
+		    .count = count,
+		});
+	}
+}
+
+std::string ScriptProfiler::ExportCollapsed() const noexcept
+{
+	std::string content;
+	auto out = std::back_inserter(content);
+
+	for (std::size_t i = 0; i < _stacks.size(); ++i)
+	{
+		std::format_to(out, "{} {}\n", *_stacks[i], _stackSamples[i]);
+	}
+
+	return content;
+}
+
+std::string ScriptProfiler::ExportChromeTrace() const noexcept
+{
+	std::uint64_t intervalNS = _intervalMS * 1'000'000ull;
+
+	nlohmann::json events = nlohmann::json::array();
+	std::vector<std::tuple<std::string_view, std::uint64_t>> openFrames;
+	std::vector<std::string_view> frames;
+
+	auto closeFrames = [&](std::size_t keep, std::uint64_t endNS)
+	{
+		while (openFrames.size() > keep)
+		{
+			auto &&[name, beginNS] = openFrames.back();
+			events.emplace_back(nlohmann::json{
+			    {"name", name},
+			    {"cat", "lua"},
+			    {"ph", "X"},
+			    {"pid", 1},
+			    {"tid", 1},
+			    {"ts", beginNS / 1e3},
+			    {"dur", (endNS - beginNS) / 1e3},
+			});
+			openFrames.pop_back();
+		}
+	};
+
+	std::uint64_t previousNS = 0;
+	for (const Sample &sample : _timeline)
+	{
+		// Nothing was sampled for a while, e.g. no lua code running between frames, do not merge across the gap.
+		if (!openFrames.empty() && sample.timeNS - previousNS > intervalNS * 2)
+		{
+			closeFrames(0, previousNS + intervalNS);
+		}
+
+		frames.clear();
+		std::string_view stack = *_stacks[sample.stackIndex];
+		for (std::size_t begin = 0; begin <= stack.size();)
+		{
+			std::size_t end = stack.find(';', begin);
+			if (end == std::string_view::npos)
+			{
+				end = stack.size();
+			}
+			frames.emplace_back(stack.substr(begin, end - begin));
+			begin = end + 1;
+		}
+
+		std::size_t common = 0;
+		while (common < openFrames.size() && common < frames.size() && std::get<0>(openFrames[common]) == frames[common])
+		{
+			++common;
+		}
+
+		std::uint64_t beginNS = sample.timeNS > intervalNS ? sample.timeNS - intervalNS : 0;
+		closeFrames(common, beginNS);
+		for (std::size_t i = common; i < frames.size(); ++i)
+		{
+			openFrames.emplace_back(frames[i], beginNS);
+		}
+
+		previousNS = sample.timeNS;
+	}
+	closeFrames(0, previousNS);
+
+	nlohmann::json trace{
+	    {"traceEvents", std::move(events)},
+	    {"displayTimeUnit", "ms"},
+	};
+	return trace.dump();
+}
+
+bool ScriptProfiler::Export(const std::filesystem::path &filePath, EScriptProfileFormat format) noexcept
+{
+	std::string content;
+	switch (format)
+	{
+	case EScriptProfileFormat::Collapsed:
+		content = ExportCollapsed();
+		break;
+	case EScriptProfileFormat::ChromeTrace:
+		content = ExportChromeTrace();
+		break;
+	default:
+		TE_ERROR("Invalid profile format: {}", static_cast<std::uint8_t>(format));
+		return false;
+	}
+
+	GlobalStorage &storage = GetGlobalStorageManager().GetUserStorage();
+	auto bytes = std::span<const std::byte>(reinterpret_cast<const std::byte *>(content.data()), content.size());
+	if (!storage.WriteFileFromBytes(filePath, bytes)) [[unlikely]]
+	{
+		TE_ERROR("Failed to export profile to \"{}\"", filePath.generic_string());
+		return false;
+	}
+
+	TE_INFO("Exported profile to \"{}\", {} samples, {} unique stacks", filePath.generic_string(), _totalSamples, _stacks.size());
+	return true;
+}
+
+bool ScriptProfiler::LuaStart(sol::object intervalMS, sol::object stackDepth) noexcept
+{
+	return Start(intervalMS.is<std::double_t>() ? static_cast<std::uint32_t>(intervalMS.as<std::double_t>()) : DefaultIntervalMS,
+	             stackDepth.is<std::double_t>() ? static_cast<std::uint32_t>(stackDepth.as<std::double_t>()) : DefaultStackDepth);
+}
+
+bool ScriptProfiler::LuaExport(sol::object filePath, sol::object format) noexcept
+{
+	if (!filePath.is<sol::string_view>()) [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Bad argument to #1 'filePath': string expected, got {}", GetLuaTypeStringView(filePath.get_type()));
+	}
+
+	auto format_ = format.is<std::double_t>() ? static_cast<EScriptProfileFormat>(format.as<std::double_t>()) : EScriptProfileFormat::Collapsed;
+	return Export(std::filesystem::path(filePath.as<sol::string_view>()), format_);
+}
@@ -12,6 +12,7 @@
 #include "Event/EventManager.hpp"
 
 #include "Data/Constants.hpp"
+#include "Debug/ScriptProfiler.hpp"
 #include "Event/AbstractEvent.hpp"
 #include "Event/CoreEvents.hpp"
 #include "Event/LoadtimeEvent.hpp"
@@ -47,6 +48,7 @@ EventManager::EventManager(Context &context) noexcept
       _invokingEvent(0)
 {
 	_coreEvents = std::make_unique<CoreEvents>(*this);
+	_scriptProfiler = std::make_unique<ScriptProfiler>(context);
 }
 
 EventManager::~EventManager() noexcept
@@ -211,6 +213,11 @@ ICoreEvents &EventManager::GetCoreEvents() noexcept
 	return *_coreEvents;
 }
 
+ScriptProfiler &EventManager::GetScriptProfiler() noexcept
+{
+	return *_scriptProfiler;
+}
+
 void EventManager::PreInitialize() noexcept
 {
 	auto &&scriptLoader = GetScriptLoader();
@@ -297,6 +304,7 @@ void EventManager::Initialize() noexcept
 
 void EventManager::Deinitialize() noexcept
 {
+	_scriptProfiler->Stop();
 }
 
 void EventManager::PostDeinitialize() noexcept
@@ -13,6 +13,7 @@
 
 #include "Data/Constants.hpp"
 #include "Debug/EventProfiler.hpp"
+#include "Debug/ScriptProfiler.hpp"
 #include "Event/AbstractEvent.hpp"
 #include "Event/EventHandler.hpp"
 #include "Event/EventManager.hpp"
@@ -249,6 +250,12 @@ TE_FORCEINLINE void PCallHandler(const impl::PCallHandlerObject &obj, EventHandl
 	ScriptID previousScriptID = obj.invokingScriptID;
 	obj.invokingScriptID = handler.scriptID;
 
+	std::tuple<std::string_view, std::string_view> previousAttribution;
+	if (obj.scriptProfiler != nullptr) [[unlikely]]
+	{
+		previousAttribution = obj.scriptProfiler->Attribute(obj.eventName, handler.name);
+	}
+
 	try
 	{
 		handler.function(std::forward<TArgs>(args)...);
@@ -265,6 +272,11 @@ TE_FORCEINLINE void PCallHandler(const impl::PCallHandlerObject &obj, EventHandl
 		}
 	}
 
+	if (obj.scriptProfiler != nullptr) [[unlikely]]
+	{
+		obj.scriptProfiler->Attribute(std::get<0>(previousAttribution), std::get<1>(previousAttribution));
+	}
+
 	obj.invokingScriptID = previousScriptID;
 }
 
@@ -288,9 +300,13 @@ void RuntimeEvent::Invoke(sol::object e, const EventHandleKey &key, EEventInvoca
 		profile = nullptr;
 	}
 
+	ScriptProfiler &scriptProfiler = eventManager.GetScriptProfiler();
+
 	impl::PCallHandlerObject obj{
 	    this,
 	    _invokingScriptID,
+	    scriptProfiler.IsRunning() ? &scriptProfiler : nullptr,
+	    scriptProfiler.IsRunning() ? eventManager.GetEventNameByID(_eventID).value_or("") : "",
 	};
 
 	bool anyKey = key.IsAny();
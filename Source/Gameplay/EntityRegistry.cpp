@@ -0,0 +1,635 @@
+/**
+ * @file Gameplay/EntityRegistry.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Gameplay/EntityRegistry.hpp"
+
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+using namespace tudov;
+
+EntityRegistry::EntityRegistry() noexcept
+    : _slots(),
+      _freeSlots(),
+      _archetypes(1),
+      _count(0)
+{
+}
+
+void EntityRegistry::RegisterArchetype(EntityTypeID typeID, const std::vector<ComponentTypeID> &componentTypeIDs)
+{
+	if (typeID == 0) [[unlikely]]
+	{
+		throw std::invalid_argument("Entity type id must be positive");
+	}
+
+	if (typeID >= _archetypes.size())
+	{
+		_archetypes.resize(typeID + 1);
+	}
+
+	Archetype &archetype = _archetypes[typeID];
+
+	ComponentTypeID maxComponentTypeID = 0;
+	for (ComponentTypeID componentTypeID : componentTypeIDs)
+	{
+		maxComponentTypeID = std::max(maxComponentTypeID, componentTypeID);
+	}
+
+	std::vector<std::uint32_t> columnIndices(maxComponentTypeID + 1, InvalidColumn);
+	std::vector<std::vector<sol::object>> columns(componentTypeIDs.size());
+
+	for (std::uint32_t column = 0; column < componentTypeIDs.size(); ++column)
+	{
+		ComponentTypeID componentTypeID = componentTypeIDs[column];
+		columnIndices[componentTypeID] = column;
+
+		// Keep values of components that still exist.
+		if (componentTypeID < archetype.columnIndices.size())
+		{
+			if (std::uint32_t previous = archetype.columnIndices[componentTypeID]; previous != InvalidColumn)
+			{
+				columns[column] = std::move(archetype.columns[previous]);
+				continue;
+			}
+		}
+
+		columns[column].resize(archetype.entities.size());
+	}
+
+	archetype.componentTypeIDs = componentTypeIDs;
+	archetype.columnIndices = std::move(columnIndices);
+	archetype.columns = std::move(columns);
+}
+
+bool EntityRegistry::HasArchetype(EntityTypeID typeID) const noexcept
+{
+	return typeID != 0 && typeID < _archetypes.size() && !_archetypes[typeID].columnIndices.empty();
+}
+
+EntityRegistry::EntityID EntityRegistry::Spawn(EntityTypeID typeID)
+{
+	if (!HasArchetype(typeID)) [[unlikely]]
+	{
+		throw std::invalid_argument(std::format("Entity type {} has no registered archetype", typeID));
+	}
+
+	std::uint32_t slotIndex = AllocateSlot();
+	Emplace(slotIndex, typeID);
+	return MakeEntityID(slotIndex, _slots[slotIndex].generation);
+}
+
+EntityRegistry::EntityID EntityRegistry::Reserve() noexcept
+{
+	std::uint32_t slotIndex = AllocateSlot();
+	_slots[slotIndex].reserved = true;
+	return MakeEntityID(slotIndex, _slots[slotIndex].generation);
+}
+
+bool EntityRegistry::Commit(EntityID entityID, EntityTypeID typeID)
+{
+	if (!HasArchetype(typeID)) [[unlikely]]
+	{
+		throw std::invalid_argument(std::format("Entity type {} has no registered archetype", typeID));
+	}
+
+	std::uint32_t slotIndex = GetSlotIndex(entityID);
+	if (slotIndex >= _slots.size()) [[unlikely]]
+	{
+		return false;
+	}
+
+	// Slots on the free list are never reserved, so a stale id from before `Clear` or `LuaDeserialize` cannot take a
+	// slot that `AllocateSlot` would hand out again.
+	const Slot &slot = _slots[slotIndex];
+	if (!slot.reserved || slot.generation != GetGeneration(entityID)) [[unlikely]]
+	{
+		return false;
+	}
+
+	Emplace(slotIndex, typeID);
+	return true;
+}
+
+std::uint32_t EntityRegistry::AllocateSlot() noexcept
+{
+	if (!_freeSlots.empty())
+	{
+		std::uint32_t slotIndex = _freeSlots.back();
+		_freeSlots.pop_back();
+		return slotIndex;
+	}
+
+	_slots.emplace_back(Slot{
+	    .generation = 0,
+	    .typeID = 0,
+	    .row = 0,
+	    .reserved = false,
+	});
+	return static_cast<std::uint32_t>(_slots.size() - 1);
+}
+
+void EntityRegistry::Emplace(std::uint32_t slotIndex, EntityTypeID typeID) noexcept
+{
+	Archetype &archetype = _archetypes[typeID];
+
+	Slot &slot = _slots[slotIndex];
+	slot.typeID = typeID;
+	slot.row = static_cast<std::uint32_t>(archetype.entities.size());
+	slot.reserved = false;
+
+	archetype.entities.emplace_back(MakeEntityID(slotIndex, slot.generation));
+	for (std::vector<sol::object> &column : archetype.columns)
+	{
+		column.emplace_back();
+	}
+
+	++_count;
+}
+
+bool EntityRegistry::Despawn(EntityID entityID) noexcept
+{
+	Slot *slot = FindSlot(entityID);
+	if (slot == nullptr) [[unlikely]]
+	{
+		return false;
+	}
+
+	Archetype &archetype = _archetypes[slot->typeID];
+	std::uint32_t row = slot->row;
+	std::uint32_t lastRow = static_cast<std::uint32_t>(archetype.entities.size() - 1);
+
+	// Swap remove, move the last entity of this archetype into the hole.
+	if (row != lastRow)
+	{
+		EntityID movedEntityID = archetype.entities[lastRow];
+		archetype.entities[row] = movedEntityID;
+		_slots[GetSlotIndex(movedEntityID)].row = row;
+
+		for (std::vector<sol::object> &column : archetype.columns)
+		{
+			column[row] = std::move(column[lastRow]);
+		}
+	}
+
+	archetype.entities.pop_back();
+	for (std::vector<sol::object> &column : archetype.columns)
+	{
+		column.pop_back();
+	}
+
+	slot->generation = (slot->generation + 1) & GenerationMask;
+	slot->typeID = 0;
+	slot->row = 0;
+	_freeSlots.emplace_back(GetSlotIndex(entityID));
+
+	--_count;
+	return true;
+}
+
+bool EntityRegistry::Exists(EntityID entityID) const noexcept
+{
+	return FindSlot(entityID) != nullptr;
+}
+
+std::optional<EntityRegistry::EntityTypeID> EntityRegistry::GetTypeID(EntityID entityID) const noexcept
+{
+	const Slot *slot = FindSlot(entityID);
+	return slot != nullptr ? std::make_optional(slot->typeID) : std::nullopt;
+}
+
+sol::object EntityRegistry::GetComponent(EntityID entityID, ComponentTypeID componentTypeID) const noexcept
+{
+	const sol::object *component = FindComponent(entityID, componentTypeID);
+	return component != nullptr ? *component : sol::lua_nil;
+}
+
+const sol::object *EntityRegistry::FindComponent(EntityID entityID, ComponentTypeID componentTypeID) const noexcept
+{
+	const Slot *slot = FindSlot(entityID);
+	if (slot == nullptr) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	const Archetype &archetype = _archetypes[slot->typeID];
+	if (componentTypeID >= archetype.columnIndices.size()) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	std::uint32_t column = archetype.columnIndices[componentTypeID];
+	return column != InvalidColumn ? &archetype.columns[column][slot->row] : nullptr;
+}
+
+bool EntityRegistry::SetComponent(EntityID entityID, ComponentTypeID componentTypeID, sol::object value) noexcept
+{
+	Slot *slot = FindSlot(entityID);
+	if (slot == nullptr) [[unlikely]]
+	{
+		return false;
+	}
+
+	Archetype &archetype = _archetypes[slot->typeID];
+	if (componentTypeID >= archetype.columnIndices.size()) [[unlikely]]
+	{
+		return false;
+	}
+
+	std::uint32_t column = archetype.columnIndices[componentTypeID];
+	if (column == InvalidColumn) [[unlikely]]
+	{
+		return false;
+	}
+
+	archetype.columns[column][slot->row] = std::move(value);
+	return true;
+}
+
+std::size_t EntityRegistry::Count() const noexcept
+{
+	return _count;
+}
+
+std::size_t EntityRegistry::CountByType(EntityTypeID typeID) const noexcept
+{
+	return typeID < _archetypes.size() ? _archetypes[typeID].entities.size() : 0;
+}
+
+EntityRegistry::EntityTypeID EntityRegistry::GetMaxTypeID() const noexcept
+{
+	return static_cast<EntityTypeID>(_archetypes.size() - 1);
+}
+
+EntityRegistry::EntityID EntityRegistry::GetEntityAt(EntityTypeID typeID, std::size_t index) const noexcept
+{
+	if (typeID >= _archetypes.size()) [[unlikely]]
+	{
+		return 0;
+	}
+
+	const std::vector<EntityID> &entities = _archetypes[typeID].entities;
+	return index < entities.size() ? entities[index] : 0;
+}
+
+void EntityRegistry::Clear() noexcept
+{
+	for (Archetype &archetype : _archetypes)
+	{
+		archetype.entities.clear();
+		for (std::vector<sol::object> &column : archetype.columns)
+		{
+			column.clear();
+		}
+	}
+
+	_slots.clear();
+	_freeSlots.clear();
+	_count = 0;
+}
+
+EntityRegistry::Slot *EntityRegistry::FindSlot(EntityID entityID) noexcept
+{
+	return const_cast<Slot *>(static_cast<const EntityRegistry *>(this)->FindSlot(entityID));
+}
+
+const EntityRegistry::Slot *EntityRegistry::FindSlot(EntityID entityID) const noexcept
+{
+	std::uint32_t slotIndex = GetSlotIndex(entityID);
+	if (slotIndex >= _slots.size()) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	const Slot &slot = _slots[slotIndex];
+	if (slot.typeID == 0 || slot.generation != GetGeneration(entityID)) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	return &slot;
+}
+
+void EntityRegistry::LuaRegisterArchetype(EntityTypeID typeID, sol::table componentTypeIDs)
+{
+	std::vector<ComponentTypeID> componentTypeIDs_;
+	componentTypeIDs_.reserve(componentTypeIDs.size());
+	for (std::size_t i = 1; i <= componentTypeIDs.size(); ++i)
+	{
+		componentTypeIDs_.emplace_back(componentTypeIDs.get<ComponentTypeID>(i));
+	}
+
+	RegisterArchetype(typeID, componentTypeIDs_);
+}
+
+std::optional<EntityRegistry::EntityTypeID> EntityRegistry::LuaGetTypeID(EntityID entityID) const noexcept
+{
+	return GetTypeID(entityID);
+}
+
+std::optional<EntityRegistry::EntityID> EntityRegistry::LuaGetEntityAt(EntityTypeID typeID, std::size_t index) const noexcept
+{
+	EntityID entityID = index != 0 ? GetEntityAt(typeID, index - 1) : 0;
+	return entityID != 0 ? std::make_optional(entityID) : std::nullopt;
+}
+
+EntityRegistry &EntityRegistry::LuaCheckSelf(lua_State *L)
+{
+	if (!sol::stack::check<EntityRegistry>(L, 1, sol::no_panic)) [[unlikely]]
+	{
+		luaL_argerror(L, 1, "EntityRegistry expected");
+	}
+	return sol::stack::get<EntityRegistry &>(L, 1);
+}
+
+int EntityRegistry::LuaGetComponent(lua_State *L)
+{
+	const EntityRegistry &self = LuaCheckSelf(L);
+	auto entityID = static_cast<EntityID>(luaL_checknumber(L, 2));
+	auto componentTypeID = static_cast<ComponentTypeID>(luaL_checkinteger(L, 3));
+
+	const sol::object *component = self.FindComponent(entityID, componentTypeID);
+	if (component != nullptr)
+	{
+		component->push(L);
+	}
+	else
+	{
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
+int EntityRegistry::LuaFillEntities(lua_State *L)
+{
+	const EntityRegistry &self = LuaCheckSelf(L);
+	auto typeID = static_cast<EntityTypeID>(luaL_checkinteger(L, 2));
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	std::size_t count = 0;
+	if (typeID < self._archetypes.size())
+	{
+		const std::vector<EntityID> &entities = self._archetypes[typeID].entities;
+		count = entities.size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			lua_pushnumber(L, static_cast<lua_Number>(entities[i]));
+			lua_rawseti(L, 3, static_cast<int>(i + 1));
+		}
+	}
+
+	// Drop ids left from a previous fill of the same table.
+	for (int i = static_cast<int>(count) + 1;; ++i)
+	{
+		lua_rawgeti(L, 3, i);
+		bool isNil = lua_isnil(L, -1);
+		lua_pop(L, 1);
+		if (isNil)
+		{
+			break;
+		}
+		lua_pushnil(L);
+		lua_rawseti(L, 3, i);
+	}
+
+	lua_pushinteger(L, static_cast<lua_Integer>(count));
+	return 1;
+}
+
+sol::table EntityRegistry::LuaSerialize(sol::table serializableComponents, sol::this_state ts) const
+{
+	sol::state_view lua{ts};
+
+	sol::table generations = lua.create_table(static_cast<int>(_slots.size()), 0);
+	for (std::size_t i = 0; i < _slots.size(); ++i)
+	{
+		generations[i + 1] = _slots[i].generation;
+	}
+
+	sol::table freeSlots = lua.create_table(static_cast<int>(_freeSlots.size()), 0);
+	for (std::size_t i = 0; i < _freeSlots.size(); ++i)
+	{
+		freeSlots[i + 1] = _freeSlots[i];
+	}
+
+	sol::table archetypes = lua.create_table(static_cast<int>(_archetypes.size()), 0);
+	for (EntityTypeID typeID = 1; typeID < _archetypes.size(); ++typeID)
+	{
+		const Archetype &archetype = _archetypes[typeID];
+		if (archetype.entities.empty())
+		{
+			continue;
+		}
+
+		sol::table entities = lua.create_table(static_cast<int>(archetype.entities.size()), 0);
+		for (std::size_t row = 0; row < archetype.entities.size(); ++row)
+		{
+			entities[row + 1] = archetype.entities[row];
+		}
+
+		sol::table archetypeData = lua.create_table(0, static_cast<int>(archetype.columns.size() + 1));
+		archetypeData["entities"] = entities;
+
+		for (std::uint32_t column = 0; column < archetype.columns.size(); ++column)
+		{
+			ComponentTypeID componentTypeID = archetype.componentTypeIDs[column];
+			if (!serializableComponents.get_or(componentTypeID, false))
+			{
+				continue;
+			}
+
+			const std::vector<sol::object> &values = archetype.columns[column];
+			sol::table columnData = lua.create_table(static_cast<int>(values.size()), 0);
+			for (std::size_t row = 0; row < values.size(); ++row)
+			{
+				columnData[row + 1] = values[row];
+			}
+			archetypeData[componentTypeID] = columnData;
+		}
+
+		archetypes[typeID] = archetypeData;
+	}
+
+	sol::table data = lua.create_table(0, 3);
+	data["generations"] = generations;
+	data["freeSlots"] = freeSlots;
+	data["archetypes"] = archetypes;
+	return data;
+}
+
+namespace
+{
+	std::optional<std::uint64_t> ReadInteger(const sol::object &value, std::uint64_t max) noexcept
+	{
+		if (value.get_type() != sol::type::number) [[unlikely]]
+		{
+			return std::nullopt;
+		}
+
+		auto number = value.as<double>();
+		if (!(number >= 0 && number <= static_cast<double>(max)) || number != std::floor(number)) [[unlikely]]
+		{
+			return std::nullopt;
+		}
+
+		return static_cast<std::uint64_t>(number);
+	}
+} // namespace
+
+void EntityRegistry::LuaDeserialize(sol::table data)
+{
+	// The snapshot may come from a peer, validate all of it before touching current state.
+
+	sol::optional<sol::table> generations = data["generations"];
+	sol::optional<sol::table> freeSlots = data["freeSlots"];
+	sol::optional<sol::table> archetypes = data["archetypes"];
+	if (!generations.has_value() || !freeSlots.has_value() || !archetypes.has_value()) [[unlikely]]
+	{
+		throw std::runtime_error("Malformed entity registry data");
+	}
+
+	std::size_t slotCount = generations->size();
+	if (slotCount > std::numeric_limits<std::uint32_t>::max()) [[unlikely]]
+	{
+		throw std::runtime_error("Too many entity slots");
+	}
+
+	std::vector<Slot> slots(slotCount);
+	for (std::size_t i = 0; i < slotCount; ++i)
+	{
+		std::optional<std::uint64_t> generation = ReadInteger(generations->get<sol::object>(i + 1), GenerationMask);
+		if (!generation.has_value()) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Invalid generation of entity slot {}", i));
+		}
+
+		slots[i] = Slot{
+		    .generation = static_cast<std::uint32_t>(*generation),
+		    .typeID = 0,
+		    .row = 0,
+		    .reserved = false,
+		};
+	}
+
+	std::vector<bool> isFree(slotCount, false);
+	std::vector<std::uint32_t> freeSlots_(freeSlots->size());
+	for (std::size_t i = 0; i < freeSlots_.size(); ++i)
+	{
+		std::optional<std::uint64_t> slotIndex = ReadInteger(freeSlots->get<sol::object>(i + 1), UINT32_MAX);
+		if (!slotIndex.has_value() || *slotIndex >= slotCount || isFree[*slotIndex]) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Invalid or duplicated free entity slot at {}", i + 1));
+		}
+
+		isFree[*slotIndex] = true;
+		freeSlots_[i] = static_cast<std::uint32_t>(*slotIndex);
+	}
+
+	struct ArchetypeData
+	{
+		EntityTypeID typeID;
+		sol::table data;
+		std::vector<EntityID> entities;
+	};
+
+	std::vector<ArchetypeData> archetypesData;
+	std::size_t count = 0;
+	for (auto &&[key, value] : *archetypes)
+	{
+		std::optional<std::uint64_t> typeID = ReadInteger(key, UINT32_MAX);
+		if (!typeID.has_value() || !HasArchetype(static_cast<EntityTypeID>(*typeID))) [[unlikely]]
+		{
+			throw std::runtime_error("Entity type in registry data has no registered archetype");
+		}
+
+		if (value.get_type() != sol::type::table) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Malformed data of entity type {}", *typeID));
+		}
+
+		sol::table archetypeData = value.as<sol::table>();
+		sol::optional<sol::table> entities = archetypeData["entities"];
+		if (!entities.has_value()) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Malformed data of entity type {}", *typeID));
+		}
+
+		std::vector<EntityID> entities_(entities->size());
+		for (std::size_t row = 0; row < entities_.size(); ++row)
+		{
+			// Entity ids are stored as lua numbers, they stay exact below 2^53.
+			std::optional<std::uint64_t> entityID = ReadInteger(entities->get<sol::object>(row + 1), (1ull << 53) - 1);
+			std::uint32_t slotIndex = entityID.has_value() ? GetSlotIndex(*entityID) : UINT32_MAX;
+			if (slotIndex >= slotCount || *entityID != MakeEntityID(slotIndex, slots[slotIndex].generation)) [[unlikely]]
+			{
+				throw std::runtime_error(std::format("Invalid entity at row {} of entity type {}", row + 1, *typeID));
+			}
+
+			Slot &slot = slots[slotIndex];
+			if (isFree[slotIndex] || slot.typeID != 0) [[unlikely]]
+			{
+				throw std::runtime_error(std::format("Entity {} is free or listed more than once", *entityID));
+			}
+
+			slot.typeID = static_cast<EntityTypeID>(*typeID);
+			slot.row = static_cast<std::uint32_t>(row);
+			entities_[row] = *entityID;
+		}
+
+		count += entities_.size();
+		archetypesData.emplace_back(ArchetypeData{
+		    .typeID = static_cast<EntityTypeID>(*typeID),
+		    .data = std::move(archetypeData),
+		    .entities = std::move(entities_),
+		});
+	}
+
+	// Every slot must be either occupied or free, otherwise it would never be allocated again.
+	if (count + freeSlots_.size() != slotCount) [[unlikely]]
+	{
+		throw std::runtime_error("Entity slots are neither occupied nor free");
+	}
+
+	Clear();
+
+	_slots = std::move(slots);
+	_freeSlots = std::move(freeSlots_);
+	_count = count;
+
+	for (ArchetypeData &archetypeData : archetypesData)
+	{
+		Archetype &archetype = _archetypes[archetypeData.typeID];
+		std::size_t rows = archetypeData.entities.size();
+		archetype.entities = std::move(archetypeData.entities);
+
+		for (std::uint32_t column = 0; column < archetype.columns.size(); ++column)
+		{
+			std::vector<sol::object> &values = archetype.columns[column];
+			values.resize(rows);
+
+			sol::optional<sol::table> columnData = archetypeData.data[archetype.componentTypeIDs[column]];
+			if (!columnData.has_value())
+			{
+				continue;
+			}
+
+			for (std::size_t row = 0; row < rows; ++row)
+			{
+				values[row] = columnData->get<sol::object>(row + 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,388 @@
+/**
+ * @file Gameplay/LevelGenerator.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Gameplay/LevelGenerator.hpp"
+
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+
+using namespace tudov;
+
+namespace
+{
+	/**
+	 * SplitMix64, standard distributions are implementation defined and would break determinism between peers.
+	 */
+	struct Random
+	{
+		std::uint64_t state;
+
+		std::uint64_t Next() noexcept
+		{
+			std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		/**
+		 * [min, max]
+		 */
+		std::int32_t Range(std::int32_t min, std::int32_t max) noexcept
+		{
+			if (max <= min)
+			{
+				return min;
+			}
+			return min + static_cast<std::int32_t>(Next() % static_cast<std::uint64_t>(max - min + 1));
+		}
+	};
+
+	std::int32_t FloorDiv(std::int32_t value, std::int32_t divisor) noexcept
+	{
+		std::int32_t quotient = value / divisor;
+		return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+	}
+
+	std::uint32_t HashLattice(std::uint64_t seed, std::int32_t x, std::int32_t y) noexcept
+	{
+		std::uint64_t h = seed ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) * 0x9E3779B97F4A7C15ull) ^
+		                  (static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) * 0xC2B2AE3D27D4EB4Full);
+		h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDull;
+		h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ull;
+		return static_cast<std::uint32_t>(h ^ (h >> 33));
+	}
+
+	/**
+	 * Integer value noise with bilinear interpolation, [0, 255].
+	 */
+	std::int32_t ValueNoise(std::uint64_t seed, std::int32_t x, std::int32_t y, std::int32_t scale) noexcept
+	{
+		std::int32_t ix = FloorDiv(x, scale);
+		std::int32_t iy = FloorDiv(y, scale);
+		std::int64_t fx = x - ix * scale;
+		std::int64_t fy = y - iy * scale;
+
+		std::int64_t v00 = HashLattice(seed, ix, iy) & 0xFF;
+		std::int64_t v10 = HashLattice(seed, ix + 1, iy) & 0xFF;
+		std::int64_t v01 = HashLattice(seed, ix, iy + 1) & 0xFF;
+		std::int64_t v11 = HashLattice(seed, ix + 1, iy + 1) & 0xFF;
+
+		std::int64_t top = v00 * (scale - fx) + v10 * fx;
+		std::int64_t bottom = v01 * (scale - fx) + v11 * fx;
+		return static_cast<std::int32_t>((top * (scale - fy) + bottom * fy) / (static_cast<std::int64_t>(scale) * scale));
+	}
+} // namespace
+
+LevelGenerator::LevelGenerator() noexcept
+    : _latestRequestID(0),
+      _stopping(false),
+      _pending(0)
+{
+}
+
+LevelGenerator::~LevelGenerator() noexcept
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock{_mutex};
+			_stopping = true;
+		}
+		_cv.notify_all();
+		_thread.join();
+	}
+}
+
+LevelGenerator::Level LevelGenerator::Generate(const Params &params) noexcept
+{
+	std::int32_t width = params.width;
+	std::int32_t height = params.height;
+
+	Level level{
+	    .requestID = 0,
+	    .params = params,
+	    .types = std::vector<TypeID>(static_cast<std::size_t>(width) * height, params.wallType),
+	    .rooms = {},
+	};
+	std::vector<TypeID> &types = level.types;
+	Random random{.state = params.seed};
+
+	auto carve = [&](std::int32_t x, std::int32_t y)
+	{
+		types[y * width + x] = params.floorType;
+	};
+
+	// Rooms, keep one tile between rooms and map borders.
+	for (std::int32_t attempt = 0; attempt < params.roomAttempts; ++attempt)
+	{
+		std::int32_t roomWidth = random.Range(params.roomMinSize, params.roomMaxSize);
+		std::int32_t roomHeight = random.Range(params.roomMinSize, params.roomMaxSize);
+		if (roomWidth > width - 2 || roomHeight > height - 2)
+		{
+			continue;
+		}
+
+		Room room{
+		    .x = random.Range(1, width - roomWidth - 1),
+		    .y = random.Range(1, height - roomHeight - 1),
+		    .width = roomWidth,
+		    .height = roomHeight,
+		};
+
+		bool overlapped = std::any_of(level.rooms.begin(), level.rooms.end(), [&room](const Room &other)
+		{
+			return room.x - 1 < other.x + other.width && other.x - 1 < room.x + room.width &&
+			       room.y - 1 < other.y + other.height && other.y - 1 < room.y + room.height;
+		});
+		if (overlapped)
+		{
+			continue;
+		}
+
+		for (std::int32_t y = room.y; y < room.y + room.height; ++y)
+		{
+			for (std::int32_t x = room.x; x < room.x + room.width; ++x)
+			{
+				carve(x, y);
+			}
+		}
+		level.rooms.emplace_back(room);
+	}
+
+	// Corridors between rooms in placement order.
+	for (std::size_t i = 1; i < level.rooms.size(); ++i)
+	{
+		const Room &from = level.rooms[i - 1];
+		const Room &to = level.rooms[i];
+		std::int32_t x1 = from.x + from.width / 2;
+		std::int32_t y1 = from.y + from.height / 2;
+		std::int32_t x2 = to.x + to.width / 2;
+		std::int32_t y2 = to.y + to.height / 2;
+
+		// L shaped, turn at (x2, y1) or (x1, y2).
+		std::int32_t cornerX = x2;
+		std::int32_t cornerY = y1;
+		if (random.Next() & 1)
+		{
+			cornerX = x1;
+			cornerY = y2;
+		}
+
+		for (std::int32_t x = std::min(x1, x2); x <= std::max(x1, x2); ++x)
+		{
+			carve(x, cornerY);
+		}
+		for (std::int32_t y = std::min(y1, y2); y <= std::max(y1, y2); ++y)
+		{
+			carve(cornerX, y);
+		}
+	}
+
+	// Floor variation.
+	if (params.altFloorType != params.floorType)
+	{
+		std::uint64_t noiseSeed = random.Next();
+		for (std::int32_t y = 0; y < height; ++y)
+		{
+			for (std::int32_t x = 0; x < width; ++x)
+			{
+				TypeID &type = types[y * width + x];
+				if (type == params.floorType && ValueNoise(noiseSeed, params.x + x, params.y + y, params.noiseScale) > params.noiseThreshold)
+				{
+					type = params.altFloorType;
+				}
+			}
+		}
+	}
+
+	// Walls not touching any floor, including diagonally, are emptied.
+	auto isFloor = [&](std::int32_t x, std::int32_t y)
+	{
+		if (x < 0 || y < 0 || x >= width || y >= height)
+		{
+			return false;
+		}
+		TypeID type = types[y * width + x];
+		return type == params.floorType || type == params.altFloorType;
+	};
+
+	for (std::int32_t y = 0; y < height; ++y)
+	{
+		for (std::int32_t x = 0; x < width; ++x)
+		{
+			TypeID &type = types[y * width + x];
+			if (type != params.wallType)
+			{
+				continue;
+			}
+
+			bool touching = false;
+			for (std::int32_t dy = -1; dy <= 1 && !touching; ++dy)
+			{
+				for (std::int32_t dx = -1; dx <= 1 && !touching; ++dx)
+				{
+					touching = isFloor(x + dx, y + dy);
+				}
+			}
+
+			if (!touching)
+			{
+				type = params.emptyType;
+			}
+		}
+	}
+
+	return level;
+}
+
+std::uint64_t LevelGenerator::Request(const Params &params) noexcept
+{
+	if (!_thread.joinable()) [[unlikely]]
+	{
+		_thread = std::thread(&LevelGenerator::WorkerMain, this);
+	}
+
+	std::uint64_t requestID = ++_latestRequestID;
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		_jobs.emplace_back(Job{
+		    .requestID = requestID,
+		    .params = params,
+		});
+	}
+	_cv.notify_one();
+
+	++_pending;
+	return requestID;
+}
+
+std::optional<LevelGenerator::Level> LevelGenerator::Poll() noexcept
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (_completed.empty())
+	{
+		return std::nullopt;
+	}
+
+	Level level = std::move(_completed.front());
+	_completed.pop_front();
+	--_pending;
+	return level;
+}
+
+std::size_t LevelGenerator::GetPendingCount() noexcept
+{
+	return _pending;
+}
+
+void LevelGenerator::WorkerMain() noexcept
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock{_mutex};
+			_cv.wait(lock, [this]()
+			{
+				return _stopping || !_jobs.empty();
+			});
+
+			if (_stopping)
+			{
+				return;
+			}
+
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+
+		Level level = Generate(job.params);
+		level.requestID = job.requestID;
+
+		std::lock_guard<std::mutex> lock{_mutex};
+		_completed.emplace_back(std::move(level));
+	}
+}
+
+LevelGenerator::Params LevelGenerator::LuaToParams(sol::table params) noexcept
+{
+	Params result{
+	    .seed = static_cast<std::uint64_t>(params.get_or<std::int64_t>("seed", 0)),
+	    .x = params.get_or<std::int32_t>("x", 0),
+	    .y = params.get_or<std::int32_t>("y", 0),
+	    .width = std::max(params.get_or<std::int32_t>("width", 64), 3),
+	    .height = std::max(params.get_or<std::int32_t>("height", 64), 3),
+	    .roomAttempts = std::max(params.get_or<std::int32_t>("roomAttempts", 32), 0),
+	    .roomMinSize = std::max(params.get_or<std::int32_t>("roomMinSize", 4), 1),
+	    .roomMaxSize = params.get_or<std::int32_t>("roomMaxSize", 10),
+	    .noiseScale = std::max(params.get_or<std::int32_t>("noiseScale", 8), 1),
+	    .noiseThreshold = std::clamp(params.get_or<std::int32_t>("noiseThreshold", 160), 0, 255),
+	    .emptyType = params.get_or<TypeID>("emptyType", 0),
+	    .floorType = params.get_or<TypeID>("floorType", 1),
+	    .wallType = params.get_or<TypeID>("wallType", 2),
+	    .altFloorType = 0,
+	};
+	result.roomMaxSize = std::max(result.roomMaxSize, result.roomMinSize);
+	result.altFloorType = params.get_or<TypeID>("altFloorType", result.floorType);
+	return result;
+}
+
+sol::table LevelGenerator::LuaFromLevel(const Level &level, sol::this_state ts) noexcept
+{
+	sol::state_view lua{ts};
+
+	sol::table typeIDs = lua.create_table(static_cast<int>(level.types.size()), 0);
+	for (std::size_t i = 0; i < level.types.size(); ++i)
+	{
+		typeIDs[i + 1] = level.types[i];
+	}
+
+	sol::table rooms = lua.create_table(static_cast<int>(level.rooms.size() * 4), 0);
+	std::size_t index = 1;
+	for (const Room &room : level.rooms)
+	{
+		rooms[index++] = level.params.x + room.x;
+		rooms[index++] = level.params.y + room.y;
+		rooms[index++] = room.width;
+		rooms[index++] = room.height;
+	}
+
+	return lua.create_table_with(
+	    "requestID", level.requestID,
+	    "x", level.params.x,
+	    "y", level.params.y,
+	    "width", level.params.width,
+	    "height", level.params.height,
+	    "typeIDs", typeIDs,
+	    "rooms", rooms);
+}
+
+sol::table LevelGenerator::LuaGenerate(sol::table params, sol::this_state ts) noexcept
+{
+	return LuaFromLevel(Generate(LuaToParams(params)), ts);
+}
+
+std::uint64_t LevelGenerator::LuaRequest(sol::table params) noexcept
+{
+	return Request(LuaToParams(params));
+}
+
+sol::object LevelGenerator::LuaPoll(sol::this_state ts) noexcept
+{
+	std::optional<Level> level = Poll();
+	if (!level.has_value())
+	{
+		return sol::lua_nil;
+	}
+	return LuaFromLevel(*level, ts);
+}
@@ -0,0 +1,577 @@
+/**
+ * @file Gameplay/PathGrid.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Gameplay/PathGrid.hpp"
+
+#include "Gameplay/TileMap.hpp"
+
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace tudov;
+
+// Straight offsets first, then diagonal ones.
+static constexpr std::int32_t offsetsX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static constexpr std::int32_t offsetsY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+static constexpr std::uint8_t opposites[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+static constexpr bool HeapCompare(const auto &l, const auto &r) noexcept
+{
+	return l.priority != r.priority ? l.priority > r.priority : l.index > r.index;
+}
+
+/**
+ * Whether moving from (x, y) along `direction` is allowed, diagonal moves must not cut corners.
+ */
+static bool CanMove(const std::vector<PathGrid::Cost> &costs, std::int32_t width, std::int32_t height, std::int32_t x, std::int32_t y, std::uint8_t direction) noexcept
+{
+	std::int32_t nx = x + offsetsX[direction];
+	std::int32_t ny = y + offsetsY[direction];
+	if (nx < 0 || ny < 0 || nx >= width || ny >= height || costs[ny * width + nx] == 0)
+	{
+		return false;
+	}
+
+	if (direction >= 4)
+	{
+		return costs[y * width + nx] != 0 && costs[ny * width + x] != 0;
+	}
+	return true;
+}
+
+PathGrid::PathGrid(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept
+    : _x(x),
+      _y(y),
+      _width(std::max(width, 1)),
+      _height(std::max(height, 1)),
+      _diagonal(true),
+      _costs(std::make_shared<std::vector<Cost>>(static_cast<std::size_t>(_width) * _height, Cost(1))),
+      _version(0),
+      _searchStamp(0),
+      _stopping(false)
+{
+}
+
+PathGrid::~PathGrid() noexcept
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock{_mutex};
+			_stopping = true;
+		}
+		_cv.notify_all();
+		_thread.join();
+	}
+}
+
+std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t> PathGrid::GetBounds() const noexcept
+{
+	return {_x, _y, _width, _height};
+}
+
+bool PathGrid::IsInBound(std::int32_t x, std::int32_t y) const noexcept
+{
+	return x >= _x && y >= _y && x < _x + _width && y < _y + _height;
+}
+
+PathGrid::Cost PathGrid::GetCost(std::int32_t x, std::int32_t y) const noexcept
+{
+	return IsInBound(x, y) ? (*_costs)[ToIndex(x, y)] : Cost(0);
+}
+
+void PathGrid::SetCost(std::int32_t x, std::int32_t y, Cost cost) noexcept
+{
+	if (!IsInBound(x, y) || (*_costs)[ToIndex(x, y)] == cost)
+	{
+		return;
+	}
+
+	MutableCosts()[ToIndex(x, y)] = cost;
+	InvalidateFlowFields();
+}
+
+void PathGrid::LoadTileMap(const TileMap &tileMap, std::size_t layer, std::span<const Cost> tagCosts) noexcept
+{
+	std::vector<Cost> &costs = MutableCosts();
+
+	for (std::int32_t y = 0; y < _height; ++y)
+	{
+		for (std::int32_t x = 0; x < _width; ++x)
+		{
+			Cost cost = 0;
+			if (tileMap.IsInBound(_x + x, _y + y))
+			{
+				const TileMap::TypeInfo *info = tileMap.GetTileInfo(layer, _x + x, _y + y);
+				cost = info != nullptr && info->tag < tagCosts.size() ? tagCosts[info->tag] : Cost(1);
+			}
+			costs[y * _width + x] = cost;
+		}
+	}
+
+	InvalidateFlowFields();
+}
+
+bool PathGrid::IsDiagonal() const noexcept
+{
+	return _diagonal;
+}
+
+void PathGrid::SetDiagonal(bool diagonal) noexcept
+{
+	if (_diagonal != diagonal)
+	{
+		_diagonal = diagonal;
+		InvalidateFlowFields();
+	}
+}
+
+std::vector<std::tuple<std::int32_t, std::int32_t>> PathGrid::FindPath(std::int32_t startX, std::int32_t startY, std::int32_t targetX, std::int32_t targetY, std::size_t maxVisits) noexcept
+{
+	std::vector<std::tuple<std::int32_t, std::int32_t>> path;
+	if (!IsInBound(startX, startY) || !IsInBound(targetX, targetY)) [[unlikely]]
+	{
+		return path;
+	}
+
+	const std::vector<Cost> &costs = *_costs;
+	std::size_t size = costs.size();
+	if (_searchStamps.size() != size)
+	{
+		_searchStamps.assign(size, 0);
+		_searchDistances.resize(size);
+		_searchParents.resize(size);
+		_searchStamp = 0;
+	}
+	if (++_searchStamp == 0) [[unlikely]]
+	{
+		std::fill(_searchStamps.begin(), _searchStamps.end(), 0);
+		_searchStamp = 1;
+	}
+
+	std::int32_t localTargetX = targetX - _x;
+	std::int32_t localTargetY = targetY - _y;
+	std::int32_t start = ToIndex(startX, startY);
+	std::int32_t target = ToIndex(targetX, targetY);
+	std::uint8_t directions = _diagonal ? 8 : 4;
+
+	auto heuristic = [&](std::int32_t index) -> Distance
+	{
+		auto dx = static_cast<Distance>(std::abs(index % _width - localTargetX));
+		auto dy = static_cast<Distance>(std::abs(index / _width - localTargetY));
+		if (_diagonal)
+		{
+			return StraightStep * (dx + dy) + (DiagonalStep - 2 * StraightStep) * std::min(dx, dy);
+		}
+		return StraightStep * (dx + dy);
+	};
+
+	_searchHeap.clear();
+	_searchStamps[start] = _searchStamp;
+	_searchDistances[start] = 0;
+	_searchParents[start] = -1;
+	_searchHeap.emplace_back(HeapNode{heuristic(start), start});
+
+	std::size_t visits = 0;
+	bool found = false;
+	while (!_searchHeap.empty())
+	{
+		std::pop_heap(_searchHeap.begin(), _searchHeap.end(), HeapCompare);
+		HeapNode node = _searchHeap.back();
+		_searchHeap.pop_back();
+
+		std::int32_t index = node.index;
+		Distance distance = _searchDistances[index];
+		// Stale heap entry, a shorter distance was found after it was pushed.
+		if (node.priority > distance + heuristic(index))
+		{
+			continue;
+		}
+
+		if (index == target)
+		{
+			found = true;
+			break;
+		}
+
+		if (++visits > maxVisits) [[unlikely]]
+		{
+			break;
+		}
+
+		std::int32_t x = index % _width;
+		std::int32_t y = index / _width;
+		for (std::uint8_t direction = 0; direction < directions; ++direction)
+		{
+			if (!CanMove(costs, _width, _height, x, y, direction))
+			{
+				continue;
+			}
+
+			std::int32_t neighbour = (y + offsetsY[direction]) * _width + x + offsetsX[direction];
+			Distance step = (direction < 4 ? StraightStep : DiagonalStep) * costs[neighbour];
+			Distance newDistance = distance + step;
+
+			if (_searchStamps[neighbour] != _searchStamp || newDistance < _searchDistances[neighbour])
+			{
+				_searchStamps[neighbour] = _searchStamp;
+				_searchDistances[neighbour] = newDistance;
+				_searchParents[neighbour] = index;
+
+				_searchHeap.emplace_back(HeapNode{newDistance + heuristic(neighbour), neighbour});
+				std::push_heap(_searchHeap.begin(), _searchHeap.end(), HeapCompare);
+			}
+		}
+	}
+
+	if (!found)
+	{
+		return path;
+	}
+
+	for (std::int32_t index = target; index != -1; index = _searchParents[index])
+	{
+		path.emplace_back(_x + index % _width, _y + index / _width);
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+const PathGrid::FlowField *PathGrid::ComputeFlowField(std::int32_t targetX, std::int32_t targetY) noexcept
+{
+	if (!IsInBound(targetX, targetY)) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	if (const FlowField *flowField = GetFlowField(targetX, targetY); flowField != nullptr)
+	{
+		return flowField;
+	}
+
+	std::int32_t targetIndex = ToIndex(targetX, targetY);
+	std::shared_ptr<FlowField> flowField = BuildFlowField(FlowFieldJob{
+	    .version = _version,
+	    .targetIndex = targetIndex,
+	    .costs = _costs,
+	    .width = _width,
+	    .height = _height,
+	    .diagonal = _diagonal,
+	});
+	StoreFlowField(flowField);
+	return flowField.get();
+}
+
+bool PathGrid::RequestFlowField(std::int32_t targetX, std::int32_t targetY) noexcept
+{
+	if (!IsInBound(targetX, targetY) || GetFlowField(targetX, targetY) != nullptr) [[unlikely]]
+	{
+		return false;
+	}
+
+	std::int32_t targetIndex = ToIndex(targetX, targetY);
+	if (auto it = _requestedFlowFields.find(targetIndex); it != _requestedFlowFields.end() && it->second == _version)
+	{
+		return false;
+	}
+	_requestedFlowFields[targetIndex] = _version;
+
+	if (!_thread.joinable()) [[unlikely]]
+	{
+		_thread = std::thread(&PathGrid::WorkerMain, this);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		_jobs.emplace_back(FlowFieldJob{
+		    .version = _version,
+		    .targetIndex = targetIndex,
+		    .costs = _costs,
+		    .width = _width,
+		    .height = _height,
+		    .diagonal = _diagonal,
+		});
+	}
+	_cv.notify_one();
+
+	return true;
+}
+
+const PathGrid::FlowField *PathGrid::GetFlowField(std::int32_t targetX, std::int32_t targetY) noexcept
+{
+	CollectFlowFields();
+
+	if (!IsInBound(targetX, targetY)) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	auto it = _flowFields.find(ToIndex(targetX, targetY));
+	return it != _flowFields.end() ? it->second.get() : nullptr;
+}
+
+void PathGrid::ClearFlowFields() noexcept
+{
+	InvalidateFlowFields();
+}
+
+std::int32_t PathGrid::ToIndex(std::int32_t x, std::int32_t y) const noexcept
+{
+	return (y - _y) * _width + (x - _x);
+}
+
+std::vector<PathGrid::Cost> &PathGrid::MutableCosts() noexcept
+{
+	// A background job still reads current costs, leave it alone.
+	if (_costs.use_count() > 1)
+	{
+		_costs = std::make_shared<std::vector<Cost>>(*_costs);
+	}
+	return *_costs;
+}
+
+void PathGrid::InvalidateFlowFields() noexcept
+{
+	++_version;
+	_flowFields.clear();
+	_flowFieldOrder.clear();
+	_requestedFlowFields.clear();
+
+	std::lock_guard<std::mutex> lock{_mutex};
+	_jobs.clear();
+}
+
+void PathGrid::StoreFlowField(std::shared_ptr<FlowField> flowField) noexcept
+{
+	if (flowField->version != _version)
+	{
+		return;
+	}
+
+	std::int32_t targetIndex = flowField->targetIndex;
+	_requestedFlowFields.erase(targetIndex);
+
+	auto [it, inserted] = _flowFields.try_emplace(targetIndex, flowField);
+	if (!inserted)
+	{
+		it->second = std::move(flowField);
+		return;
+	}
+
+	_flowFieldOrder.emplace_back(targetIndex);
+	if (_flowFieldOrder.size() > MaxFlowFields)
+	{
+		_flowFields.erase(_flowFieldOrder.front());
+		_flowFieldOrder.pop_front();
+	}
+}
+
+void PathGrid::CollectFlowFields() noexcept
+{
+	std::vector<std::shared_ptr<FlowField>> completed;
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		if (_completed.empty()) [[likely]]
+		{
+			return;
+		}
+		completed.swap(_completed);
+	}
+
+	for (std::shared_ptr<FlowField> &flowField : completed)
+	{
+		StoreFlowField(std::move(flowField));
+	}
+}
+
+void PathGrid::WorkerMain() noexcept
+{
+	while (true)
+	{
+		FlowFieldJob job;
+		{
+			std::unique_lock<std::mutex> lock{_mutex};
+			_cv.wait(lock, [this]()
+			{
+				return _stopping || !_jobs.empty();
+			});
+
+			if (_stopping)
+			{
+				return;
+			}
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		std::shared_ptr<FlowField> flowField = BuildFlowField(job);
+
+		std::lock_guard<std::mutex> lock{_mutex};
+		_completed.emplace_back(std::move(flowField));
+	}
+}
+
+std::shared_ptr<PathGrid::FlowField> PathGrid::BuildFlowField(const FlowFieldJob &job) noexcept
+{
+	const std::vector<Cost> &costs = *job.costs;
+	std::int32_t width = job.width;
+	std::int32_t height = job.height;
+	std::uint8_t directions = job.diagonal ? 8 : 4;
+
+	auto flowField = std::make_shared<FlowField>();
+	flowField->version = job.version;
+	flowField->targetIndex = job.targetIndex;
+	flowField->distances.assign(costs.size(), Unreachable);
+	flowField->directions.assign(costs.size(), NoDirection);
+
+	std::vector<Distance> &distances = flowField->distances;
+	std::vector<HeapNode> heap;
+	heap.reserve(costs.size() / 4);
+
+	// Dijkstra from target, moving from a tile into `index` costs the cost of `index`.
+	distances[job.targetIndex] = 0;
+	heap.emplace_back(HeapNode{0, job.targetIndex});
+
+	while (!heap.empty())
+	{
+		std::pop_heap(heap.begin(), heap.end(), HeapCompare);
+		HeapNode node = heap.back();
+		heap.pop_back();
+
+		std::int32_t index = node.index;
+		if (node.priority > distances[index])
+		{
+			continue;
+		}
+
+		std::int32_t x = index % width;
+		std::int32_t y = index / width;
+		Distance cost = std::max<Distance>(costs[index], 1);
+
+		for (std::uint8_t direction = 0; direction < directions; ++direction)
+		{
+			// Moves are symmetric, so moving from neighbour back to this tile is allowed as well.
+			if (!CanMove(costs, width, height, x, y, direction))
+			{
+				continue;
+			}
+
+			std::int32_t neighbour = (y + offsetsY[direction]) * width + x + offsetsX[direction];
+			Distance newDistance = node.priority + (direction < 4 ? StraightStep : DiagonalStep) * cost;
+			if (newDistance < distances[neighbour])
+			{
+				distances[neighbour] = newDistance;
+				flowField->directions[neighbour] = opposites[direction];
+
+				heap.emplace_back(HeapNode{newDistance, neighbour});
+				std::push_heap(heap.begin(), heap.end(), HeapCompare);
+			}
+		}
+	}
+
+	return flowField;
+}
+
+void PathGrid::LuaLoadTypeIDs(sol::table typeIDs, sol::table costs)
+{
+	std::vector<Cost> &costs_ = MutableCosts();
+	std::unordered_map<std::uint32_t, Cost> costCache;
+
+	for (std::size_t i = 0; i < costs_.size(); ++i)
+	{
+		auto typeID = typeIDs.get_or<std::uint32_t>(i + 1, 0);
+
+		auto it = costCache.find(typeID);
+		if (it == costCache.end()) [[unlikely]]
+		{
+			auto cost = costs.get_or<std::double_t>(typeID, 1.0);
+			it = costCache.try_emplace(typeID, static_cast<Cost>(std::clamp(cost, 0.0, 255.0))).first;
+		}
+
+		costs_[i] = it->second;
+	}
+
+	InvalidateFlowFields();
+}
+
+void PathGrid::LuaLoadTileMap(const TileMap &tileMap, sol::table tagCosts, sol::object layer)
+{
+	std::vector<Cost> tagCosts_(std::numeric_limits<TileMap::Tag>::max() + 1, Cost(1));
+	for (auto &&[key, value] : tagCosts)
+	{
+		if (key.is<std::double_t>() && value.is<std::double_t>())
+		{
+			auto tag = key.as<std::double_t>();
+			if (tag >= 0 && tag < tagCosts_.size())
+			{
+				tagCosts_[static_cast<std::size_t>(tag)] = static_cast<Cost>(std::clamp(value.as<std::double_t>(), 0.0, 255.0));
+			}
+		}
+	}
+
+	std::size_t layer_ = layer.is<std::double_t>() ? static_cast<std::size_t>(std::max(layer.as<std::double_t>(), 1.0)) - 1 : 0;
+	LoadTileMap(tileMap, layer_, tagCosts_);
+}
+
+sol::object PathGrid::LuaFindPath(std::int32_t startX, std::int32_t startY, std::int32_t targetX, std::int32_t targetY, sol::object maxVisits, sol::this_state ts) noexcept
+{
+	std::size_t maxVisits_ = maxVisits.is<std::double_t>() ? static_cast<std::size_t>(maxVisits.as<std::double_t>()) : SIZE_MAX;
+	std::vector<std::tuple<std::int32_t, std::int32_t>> path = FindPath(startX, startY, targetX, targetY, maxVisits_);
+	if (path.empty())
+	{
+		return sol::lua_nil;
+	}
+
+	sol::state_view lua{ts};
+	sol::table result = lua.create_table(static_cast<int>(path.size() * 2), 0);
+	for (std::size_t i = 0; i < path.size(); ++i)
+	{
+		auto &&[x, y] = path[i];
+		result[i * 2 + 1] = x;
+		result[i * 2 + 2] = y;
+	}
+	return result;
+}
+
+bool PathGrid::LuaComputeFlowField(std::int32_t targetX, std::int32_t targetY) noexcept
+{
+	return ComputeFlowField(targetX, targetY) != nullptr;
+}
+
+bool PathGrid::LuaHasFlowField(std::int32_t targetX, std::int32_t targetY) noexcept
+{
+	return GetFlowField(targetX, targetY) != nullptr;
+}
+
+std::tuple<sol::object, sol::object, sol::object> PathGrid::LuaGetFlowDirection(std::int32_t targetX, std::int32_t targetY, std::int32_t x, std::int32_t y, sol::this_state ts) noexcept
+{
+	const FlowField *flowField = GetFlowField(targetX, targetY);
+	if (flowField == nullptr || !IsInBound(x, y))
+	{
+		return {sol::lua_nil, sol::lua_nil, sol::lua_nil};
+	}
+
+	std::int32_t index = ToIndex(x, y);
+	Distance distance = flowField->distances[index];
+	if (distance == Unreachable)
+	{
+		return {sol::lua_nil, sol::lua_nil, sol::lua_nil};
+	}
+
+	std::uint8_t direction = flowField->directions[index];
+	std::int32_t dx = direction != NoDirection ? offsetsX[direction] : 0;
+	std::int32_t dy = direction != NoDirection ? offsetsY[direction] : 0;
+	return {sol::make_object(ts, dx), sol::make_object(ts, dy), sol::make_object(ts, distance)};
+}
@@ -0,0 +1,807 @@
+/**
+ * @file Gameplay/PhysicsWorld.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Gameplay/PhysicsWorld.hpp"
+
+#include <algorithm>
+
+using namespace tudov;
+
+using Fixed = PhysicsWorld::Fixed;
+
+static constexpr Fixed restitution = PhysicsWorld::FixedOne;
+static constexpr std::uint32_t serialVersion = 1;
+static constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+static constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+static constexpr std::uint32_t GetSlotIndex(PhysicsWorld::BodyID bodyID) noexcept
+{
+	return static_cast<std::uint32_t>(bodyID & 0xFFFFFFFFull) - 1;
+}
+
+static constexpr std::uint32_t GetGeneration(PhysicsWorld::BodyID bodyID) noexcept
+{
+	return static_cast<std::uint32_t>(bodyID >> 32) & PhysicsWorld::GenerationMask;
+}
+
+static constexpr PhysicsWorld::BodyID MakeBodyID(std::uint32_t slotIndex, std::uint32_t generation) noexcept
+{
+	return (static_cast<PhysicsWorld::BodyID>(generation & PhysicsWorld::GenerationMask) << 32) | (static_cast<PhysicsWorld::BodyID>(slotIndex) + 1);
+}
+
+static constexpr std::uint64_t MakeCellKey(std::int32_t x, std::int32_t y) noexcept
+{
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+static constexpr Fixed Mul(Fixed l, Fixed r) noexcept
+{
+	return (l * r) >> PhysicsWorld::FractionBits;
+}
+
+static constexpr Fixed Div(Fixed l, Fixed r) noexcept
+{
+	return (l * PhysicsWorld::FixedOne) / r;
+}
+
+static constexpr std::int32_t FloorDiv(Fixed l, Fixed r) noexcept
+{
+	Fixed quotient = l / r;
+	if (l % r != 0 && (l < 0) != (r < 0))
+	{
+		--quotient;
+	}
+	return static_cast<std::int32_t>(quotient);
+}
+
+static constexpr Fixed Abs(Fixed value) noexcept
+{
+	return value < 0 ? -value : value;
+}
+
+static constexpr Fixed Sign(Fixed value) noexcept
+{
+	return value < 0 ? -PhysicsWorld::FixedOne : PhysicsWorld::FixedOne;
+}
+
+/**
+ * Integer square root, rounded down. Square root of a value with 32 fractional bits has 16 fractional bits.
+ */
+static constexpr Fixed Sqrt(Fixed value) noexcept
+{
+	if (value <= 0)
+	{
+		return 0;
+	}
+
+	auto remainder = static_cast<std::uint64_t>(value);
+	std::uint64_t result = 0;
+	std::uint64_t bit = 1ull << 62;
+	while (bit > remainder)
+	{
+		bit >>= 2;
+	}
+	while (bit != 0)
+	{
+		if (remainder >= result + bit)
+		{
+			remainder -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return static_cast<Fixed>(result);
+}
+
+static void HashValue(std::uint64_t &hash, std::uint64_t value) noexcept
+{
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= fnvPrime;
+	}
+}
+
+template <typename T>
+static void HashValues(std::uint64_t &hash, const std::vector<T> &values) noexcept
+{
+	HashValue(hash, values.size());
+	for (const T &value : values)
+	{
+		HashValue(hash, static_cast<std::uint64_t>(value));
+	}
+}
+
+static void WriteValue(std::string &data, std::uint64_t value) noexcept
+{
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		data.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+template <typename T>
+static void WriteValues(std::string &data, const std::vector<T> &values) noexcept
+{
+	for (const T &value : values)
+	{
+		WriteValue(data, static_cast<std::uint64_t>(value));
+	}
+}
+
+static bool ReadValue(std::string_view &data, std::uint64_t &value) noexcept
+{
+	if (data.size() < 8) [[unlikely]]
+	{
+		return false;
+	}
+
+	value = 0;
+	for (std::uint32_t i = 0; i < 8; ++i)
+	{
+		value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(data[i])) << (i * 8);
+	}
+	data.remove_prefix(8);
+	return true;
+}
+
+template <typename T>
+static bool ReadValues(std::string_view &data, std::vector<T> &values, std::uint64_t count) noexcept
+{
+	// Bound the count by remaining bytes before allocating, it comes from untrusted data.
+	if (count > data.size() / 8) [[unlikely]]
+	{
+		return false;
+	}
+
+	values.resize(count);
+	for (T &value : values)
+	{
+		std::uint64_t value_;
+		if (!ReadValue(data, value_)) [[unlikely]]
+		{
+			return false;
+		}
+		value = static_cast<T>(value_);
+		// Reject values not fitting in `T` instead of truncating them.
+		if (static_cast<std::uint64_t>(value) != value_) [[unlikely]]
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+PhysicsWorld::PhysicsWorld(std::double_t cellSize) noexcept
+    : _cellSize(ToFixed(cellSize > 0.0 ? cellSize : DefaultCellSize))
+{
+}
+
+PhysicsWorld::Fixed PhysicsWorld::ToFixed(std::double_t value) noexcept
+{
+	return static_cast<Fixed>(std::llround(value * static_cast<std::double_t>(FixedOne)));
+}
+
+std::double_t PhysicsWorld::FromFixed(Fixed value) noexcept
+{
+	return static_cast<std::double_t>(value) / static_cast<std::double_t>(FixedOne);
+}
+
+PhysicsWorld::BodyID PhysicsWorld::AddCircle(std::double_t x, std::double_t y, std::double_t radius, std::double_t mass) noexcept
+{
+	Fixed radius_ = ToFixed(radius);
+	return AddBody(EPhysicsShape::Circle, ToFixed(x), ToFixed(y), radius_, radius_, ToFixed(mass));
+}
+
+PhysicsWorld::BodyID PhysicsWorld::AddRect(std::double_t x, std::double_t y, std::double_t width, std::double_t height, std::double_t mass) noexcept
+{
+	return AddBody(EPhysicsShape::Rect, ToFixed(x), ToFixed(y), ToFixed(width) / 2, ToFixed(height) / 2, ToFixed(mass));
+}
+
+PhysicsWorld::BodyID PhysicsWorld::AddBody(EPhysicsShape shape, Fixed x, Fixed y, Fixed extentX, Fixed extentY, Fixed mass) noexcept
+{
+	std::uint32_t slotIndex;
+	if (!_freeSlots.empty())
+	{
+		slotIndex = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = static_cast<std::uint32_t>(_slots.size());
+		_slots.emplace_back(Slot{
+		    .generation = 0,
+		    .index = InvalidIndex,
+		});
+	}
+
+	Slot &slot = _slots[slotIndex];
+	slot.index = static_cast<std::uint32_t>(_ids.size());
+
+	BodyID bodyID = MakeBodyID(slotIndex, slot.generation);
+	_ids.emplace_back(bodyID);
+	_shapes.emplace_back(shape);
+	_positionsX.emplace_back(x);
+	_positionsY.emplace_back(y);
+	_velocitiesX.emplace_back(0);
+	_velocitiesY.emplace_back(0);
+	_extentsX.emplace_back(Abs(extentX));
+	_extentsY.emplace_back(Abs(extentY));
+	_inverseMasses.emplace_back(mass > 0 ? Div(FixedOne, mass) : 0);
+
+	return bodyID;
+}
+
+bool PhysicsWorld::RemoveBody(BodyID bodyID) noexcept
+{
+	std::uint32_t index = FindIndex(bodyID);
+	if (index == InvalidIndex) [[unlikely]]
+	{
+		return false;
+	}
+
+	auto last = static_cast<std::uint32_t>(_ids.size() - 1);
+	if (index != last)
+	{
+		_ids[index] = _ids[last];
+		_shapes[index] = _shapes[last];
+		_positionsX[index] = _positionsX[last];
+		_positionsY[index] = _positionsY[last];
+		_velocitiesX[index] = _velocitiesX[last];
+		_velocitiesY[index] = _velocitiesY[last];
+		_extentsX[index] = _extentsX[last];
+		_extentsY[index] = _extentsY[last];
+		_inverseMasses[index] = _inverseMasses[last];
+		_slots[GetSlotIndex(_ids[index])].index = index;
+	}
+
+	_ids.pop_back();
+	_shapes.pop_back();
+	_positionsX.pop_back();
+	_positionsY.pop_back();
+	_velocitiesX.pop_back();
+	_velocitiesY.pop_back();
+	_extentsX.pop_back();
+	_extentsY.pop_back();
+	_inverseMasses.pop_back();
+
+	std::uint32_t slotIndex = GetSlotIndex(bodyID);
+	Slot &slot = _slots[slotIndex];
+	slot.generation = (slot.generation + 1) & GenerationMask;
+	slot.index = InvalidIndex;
+	_freeSlots.emplace_back(slotIndex);
+
+	return true;
+}
+
+bool PhysicsWorld::HasBody(BodyID bodyID) const noexcept
+{
+	return FindIndex(bodyID) != InvalidIndex;
+}
+
+std::size_t PhysicsWorld::GetBodyCount() const noexcept
+{
+	return _ids.size();
+}
+
+std::tuple<std::double_t, std::double_t> PhysicsWorld::GetPosition(BodyID bodyID) const noexcept
+{
+	std::uint32_t index = FindIndex(bodyID);
+	if (index == InvalidIndex) [[unlikely]]
+	{
+		return {0.0, 0.0};
+	}
+	return {FromFixed(_positionsX[index]), FromFixed(_positionsY[index])};
+}
+
+bool PhysicsWorld::SetPosition(BodyID bodyID, std::double_t x, std::double_t y) noexcept
+{
+	std::uint32_t index = FindIndex(bodyID);
+	if (index == InvalidIndex) [[unlikely]]
+	{
+		return false;
+	}
+	_positionsX[index] = ToFixed(x);
+	_positionsY[index] = ToFixed(y);
+	return true;
+}
+
+std::tuple<std::double_t, std::double_t> PhysicsWorld::GetVelocity(BodyID bodyID) const noexcept
+{
+	std::uint32_t index = FindIndex(bodyID);
+	if (index == InvalidIndex) [[unlikely]]
+	{
+		return {0.0, 0.0};
+	}
+	return {FromFixed(_velocitiesX[index]), FromFixed(_velocitiesY[index])};
+}
+
+bool PhysicsWorld::SetVelocity(BodyID bodyID, std::double_t x, std::double_t y) noexcept
+{
+	std::uint32_t index = FindIndex(bodyID);
+	if (index == InvalidIndex) [[unlikely]]
+	{
+		return false;
+	}
+	_velocitiesX[index] = ToFixed(x);
+	_velocitiesY[index] = ToFixed(y);
+	return true;
+}
+
+std::double_t PhysicsWorld::GetCellSize() const noexcept
+{
+	return FromFixed(_cellSize);
+}
+
+void PhysicsWorld::SetCellSize(std::double_t cellSize) noexcept
+{
+	Fixed cellSize_ = ToFixed(cellSize);
+	if (cellSize_ > 0) [[likely]]
+	{
+		_cellSize = cellSize_;
+	}
+}
+
+std::size_t PhysicsWorld::Step(std::double_t deltaTime) noexcept
+{
+	_contacts.clear();
+
+	Integrate(ToFixed(deltaTime));
+	Broadphase();
+
+	return _contacts.size();
+}
+
+const std::vector<PhysicsWorld::Contact> &PhysicsWorld::GetContacts() const noexcept
+{
+	return _contacts;
+}
+
+std::uint64_t PhysicsWorld::GetStateHash() const noexcept
+{
+	std::uint64_t hash = fnvOffsetBasis;
+
+	HashValue(hash, _cellSize);
+	HashValue(hash, _slots.size());
+	for (const Slot &slot : _slots)
+	{
+		HashValue(hash, (static_cast<std::uint64_t>(slot.generation) << 32) | slot.index);
+	}
+	HashValues(hash, _freeSlots);
+	HashValues(hash, _ids);
+	HashValues(hash, _shapes);
+	HashValues(hash, _positionsX);
+	HashValues(hash, _positionsY);
+	HashValues(hash, _velocitiesX);
+	HashValues(hash, _velocitiesY);
+	HashValues(hash, _extentsX);
+	HashValues(hash, _extentsY);
+	HashValues(hash, _inverseMasses);
+
+	return hash;
+}
+
+std::string PhysicsWorld::Serialize() const noexcept
+{
+	std::string data;
+	data.reserve((4 + _slots.size() + _freeSlots.size() + _ids.size() * 9) * 8);
+
+	WriteValue(data, serialVersion);
+	WriteValue(data, _cellSize);
+
+	WriteValue(data, _slots.size());
+	for (const Slot &slot : _slots)
+	{
+		WriteValue(data, (static_cast<std::uint64_t>(slot.generation) << 32) | slot.index);
+	}
+
+	WriteValue(data, _freeSlots.size());
+	WriteValues(data, _freeSlots);
+
+	WriteValue(data, _ids.size());
+	WriteValues(data, _ids);
+	WriteValues(data, _shapes);
+	WriteValues(data, _positionsX);
+	WriteValues(data, _positionsY);
+	WriteValues(data, _velocitiesX);
+	WriteValues(data, _velocitiesY);
+	WriteValues(data, _extentsX);
+	WriteValues(data, _extentsY);
+	WriteValues(data, _inverseMasses);
+
+	return data;
+}
+
+bool PhysicsWorld::Deserialize(std::string_view data) noexcept
+{
+	Clear();
+
+	std::uint64_t version, cellSize, slotCount;
+	if (!ReadValue(data, version) || version != serialVersion || !ReadValue(data, cellSize) || !ReadValue(data, slotCount) ||
+	    slotCount > data.size() / 8 || slotCount >= InvalidIndex) [[unlikely]]
+	{
+		return false;
+	}
+
+	_cellSize = static_cast<Fixed>(cellSize);
+	_slots.resize(slotCount);
+	for (Slot &slot : _slots)
+	{
+		std::uint64_t value;
+		if (!ReadValue(data, value)) [[unlikely]]
+		{
+			Clear();
+			return false;
+		}
+		slot.generation = static_cast<std::uint32_t>(value >> 32);
+		slot.index = static_cast<std::uint32_t>(value);
+	}
+
+	std::uint64_t freeCount, bodyCount;
+	bool success = ReadValue(data, freeCount) && ReadValues(data, _freeSlots, freeCount) && ReadValue(data, bodyCount) &&
+	               ReadValues(data, _ids, bodyCount) && ReadValues(data, _shapes, bodyCount) &&
+	               ReadValues(data, _positionsX, bodyCount) && ReadValues(data, _positionsY, bodyCount) &&
+	               ReadValues(data, _velocitiesX, bodyCount) && ReadValues(data, _velocitiesY, bodyCount) &&
+	               ReadValues(data, _extentsX, bodyCount) && ReadValues(data, _extentsY, bodyCount) &&
+	               ReadValues(data, _inverseMasses, bodyCount);
+	if (!success || !IsConsistent()) [[unlikely]]
+	{
+		Clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool PhysicsWorld::IsConsistent() const noexcept
+{
+	if (_cellSize <= 0 || _freeSlots.size() + _ids.size() != _slots.size()) [[unlikely]]
+	{
+		return false;
+	}
+
+	std::size_t occupiedCount = 0;
+	for (const Slot &slot : _slots)
+	{
+		if (slot.generation > GenerationMask) [[unlikely]]
+		{
+			return false;
+		}
+		if (slot.index != InvalidIndex)
+		{
+			++occupiedCount;
+		}
+	}
+
+	// Each body points to an occupied slot pointing back to it, so with equal counts bodies and occupied slots are one
+	// to one.
+	if (occupiedCount != _ids.size()) [[unlikely]]
+	{
+		return false;
+	}
+
+	for (std::uint32_t index = 0; index < _ids.size(); ++index)
+	{
+		std::uint32_t slotIndex = GetSlotIndex(_ids[index]);
+		if (slotIndex >= _slots.size() || _ids[index] != MakeBodyID(slotIndex, _slots[slotIndex].generation) ||
+		    _slots[slotIndex].index != index) [[unlikely]]
+		{
+			return false;
+		}
+
+		if ((_shapes[index] != EPhysicsShape::Circle && _shapes[index] != EPhysicsShape::Rect) || _extentsX[index] < 0 ||
+		    _extentsY[index] < 0 || _inverseMasses[index] < 0) [[unlikely]]
+		{
+			return false;
+		}
+	}
+
+	std::vector<bool> isFree(_slots.size(), false);
+	for (std::uint32_t slotIndex : _freeSlots)
+	{
+		if (slotIndex >= _slots.size() || isFree[slotIndex] || _slots[slotIndex].index != InvalidIndex) [[unlikely]]
+		{
+			return false;
+		}
+		isFree[slotIndex] = true;
+	}
+
+	return true;
+}
+
+void PhysicsWorld::Clear() noexcept
+{
+	_slots.clear();
+	_freeSlots.clear();
+	_ids.clear();
+	_shapes.clear();
+	_positionsX.clear();
+	_positionsY.clear();
+	_velocitiesX.clear();
+	_velocitiesY.clear();
+	_extentsX.clear();
+	_extentsY.clear();
+	_inverseMasses.clear();
+	_cellEntries.clear();
+	_contacts.clear();
+}
+
+std::uint32_t PhysicsWorld::FindIndex(BodyID bodyID) const noexcept
+{
+	std::uint32_t slotIndex = GetSlotIndex(bodyID);
+	if (slotIndex >= _slots.size()) [[unlikely]]
+	{
+		return InvalidIndex;
+	}
+
+	const Slot &slot = _slots[slotIndex];
+	return slot.generation == GetGeneration(bodyID) ? slot.index : InvalidIndex;
+}
+
+void PhysicsWorld::Integrate(Fixed deltaTime) noexcept
+{
+	std::size_t count = _ids.size();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		_positionsX[i] += Mul(_velocitiesX[i], deltaTime);
+		_positionsY[i] += Mul(_velocitiesY[i], deltaTime);
+	}
+}
+
+void PhysicsWorld::Broadphase() noexcept
+{
+	_cellEntries.clear();
+	for (std::uint32_t i = 0; i < _ids.size(); ++i)
+	{
+		std::int32_t minX = FloorDiv(_positionsX[i] - _extentsX[i], _cellSize);
+		std::int32_t minY = FloorDiv(_positionsY[i] - _extentsY[i], _cellSize);
+		std::int32_t maxX = FloorDiv(_positionsX[i] + _extentsX[i], _cellSize);
+		std::int32_t maxY = FloorDiv(_positionsY[i] + _extentsY[i], _cellSize);
+
+		for (std::int32_t y = minY; y <= maxY; ++y)
+		{
+			for (std::int32_t x = minX; x <= maxX; ++x)
+			{
+				_cellEntries.emplace_back(CellEntry{
+				    .cell = MakeCellKey(x, y),
+				    .index = i,
+				});
+			}
+		}
+	}
+
+	std::sort(_cellEntries.begin(), _cellEntries.end(), [](const CellEntry &l, const CellEntry &r)
+	{
+		return l.cell != r.cell ? l.cell < r.cell : l.index < r.index;
+	});
+
+	for (std::size_t begin = 0; begin < _cellEntries.size();)
+	{
+		std::uint64_t cell = _cellEntries[begin].cell;
+		std::size_t end = begin + 1;
+		while (end < _cellEntries.size() && _cellEntries[end].cell == cell)
+		{
+			++end;
+		}
+
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			std::uint32_t a = _cellEntries[i].index;
+			Fixed minAX = _positionsX[a] - _extentsX[a];
+			Fixed minAY = _positionsY[a] - _extentsY[a];
+			Fixed maxAX = _positionsX[a] + _extentsX[a];
+			Fixed maxAY = _positionsY[a] + _extentsY[a];
+
+			for (std::size_t j = i + 1; j < end; ++j)
+			{
+				std::uint32_t b = _cellEntries[j].index;
+				Fixed minBX = _positionsX[b] - _extentsX[b];
+				Fixed minBY = _positionsY[b] - _extentsY[b];
+
+				if (minBX > maxAX || minBY > maxAY || _positionsX[b] + _extentsX[b] < minAX || _positionsY[b] + _extentsY[b] < minAY)
+				{
+					continue;
+				}
+
+				// Pairs sharing multiple cells are only tested in the cell containing the min corner of their overlap.
+				std::int32_t overlapX = FloorDiv(std::max(minAX, minBX), _cellSize);
+				std::int32_t overlapY = FloorDiv(std::max(minAY, minBY), _cellSize);
+				if (MakeCellKey(overlapX, overlapY) != cell)
+				{
+					continue;
+				}
+
+				Narrowphase(a, b);
+			}
+		}
+
+		begin = end;
+	}
+}
+
+void PhysicsWorld::Narrowphase(std::uint32_t a, std::uint32_t b) noexcept
+{
+	if (_inverseMasses[a] == 0 && _inverseMasses[b] == 0)
+	{
+		return;
+	}
+
+	Fixed normalX, normalY, depth;
+	if (!Collide(a, b, normalX, normalY, depth))
+	{
+		return;
+	}
+
+	_contacts.emplace_back(Contact{
+	    .a = _ids[a],
+	    .b = _ids[b],
+	    .normalX = normalX,
+	    .normalY = normalY,
+	    .depth = depth,
+	});
+
+	Resolve(a, b, normalX, normalY);
+}
+
+bool PhysicsWorld::Collide(std::uint32_t a, std::uint32_t b, Fixed &normalX, Fixed &normalY, Fixed &depth) const noexcept
+{
+	Fixed dx = _positionsX[b] - _positionsX[a];
+	Fixed dy = _positionsY[b] - _positionsY[a];
+
+	EPhysicsShape shapeA = _shapes[a];
+	EPhysicsShape shapeB = _shapes[b];
+
+	if (shapeA == EPhysicsShape::Circle && shapeB == EPhysicsShape::Circle)
+	{
+		Fixed radius = _extentsX[a] + _extentsX[b];
+		// Squared values keep 32 fractional bits, no precision is lost before square root.
+		Fixed distance2 = dx * dx + dy * dy;
+		if (distance2 > radius * radius)
+		{
+			return false;
+		}
+
+		Fixed distance = Sqrt(distance2);
+		if (distance > 0) [[likely]]
+		{
+			normalX = Div(dx, distance);
+			normalY = Div(dy, distance);
+		}
+		else
+		{
+			normalX = FixedOne;
+			normalY = 0;
+		}
+		depth = radius - distance;
+		return true;
+	}
+
+	if (shapeA == EPhysicsShape::Rect && shapeB == EPhysicsShape::Rect)
+	{
+		Fixed overlapX = _extentsX[a] + _extentsX[b] - Abs(dx);
+		Fixed overlapY = _extentsY[a] + _extentsY[b] - Abs(dy);
+		if (overlapX < 0 || overlapY < 0)
+		{
+			return false;
+		}
+
+		if (overlapX < overlapY)
+		{
+			normalX = Sign(dx);
+			normalY = 0;
+			depth = overlapX;
+		}
+		else
+		{
+			normalX = 0;
+			normalY = Sign(dy);
+			depth = overlapY;
+		}
+		return true;
+	}
+
+	// Circle vs rect, compute normal from rect to circle first.
+	bool circleFirst = shapeA == EPhysicsShape::Circle;
+	std::uint32_t circle = circleFirst ? a : b;
+	std::uint32_t rect = circleFirst ? b : a;
+
+	Fixed radius = _extentsX[circle];
+	Fixed offsetX = _positionsX[circle] - _positionsX[rect];
+	Fixed offsetY = _positionsY[circle] - _positionsY[rect];
+	Fixed halfW = _extentsX[rect];
+	Fixed halfH = _extentsY[rect];
+
+	Fixed deltaX = offsetX - std::clamp(offsetX, -halfW, halfW);
+	Fixed deltaY = offsetY - std::clamp(offsetY, -halfH, halfH);
+	Fixed distance2 = deltaX * deltaX + deltaY * deltaY;
+	if (distance2 > radius * radius)
+	{
+		return false;
+	}
+
+	if (distance2 > 0) [[likely]]
+	{
+		Fixed distance = Sqrt(distance2);
+		normalX = Div(deltaX, distance);
+		normalY = Div(deltaY, distance);
+		depth = radius - distance;
+	}
+	else
+	{
+		// Circle center is inside the rect, push out along the axis of least penetration.
+		Fixed penetrationX = halfW - Abs(offsetX);
+		Fixed penetrationY = halfH - Abs(offsetY);
+		if (penetrationX < penetrationY)
+		{
+			normalX = Sign(offsetX);
+			normalY = 0;
+			depth = penetrationX + radius;
+		}
+		else
+		{
+			normalX = 0;
+			normalY = Sign(offsetY);
+			depth = penetrationY + radius;
+		}
+	}
+
+	if (circleFirst)
+	{
+		normalX = -normalX;
+		normalY = -normalY;
+	}
+	return true;
+}
+
+void PhysicsWorld::Resolve(std::uint32_t a, std::uint32_t b, Fixed normalX, Fixed normalY) noexcept
+{
+	Fixed relativeX = _velocitiesX[b] - _velocitiesX[a];
+	Fixed relativeY = _velocitiesY[b] - _velocitiesY[a];
+	Fixed velocityAlongNormal = Mul(relativeX, normalX) + Mul(relativeY, normalY);
+	if (velocityAlongNormal > 0)
+	{
+		return;
+	}
+
+	Fixed inverseMassA = _inverseMasses[a];
+	Fixed inverseMassB = _inverseMasses[b];
+	Fixed impulse = Div(-Mul(FixedOne + restitution, velocityAlongNormal), inverseMassA + inverseMassB);
+
+	_velocitiesX[a] -= Mul(Mul(normalX, impulse), inverseMassA);
+	_velocitiesY[a] -= Mul(Mul(normalY, impulse), inverseMassA);
+	_velocitiesX[b] += Mul(Mul(normalX, impulse), inverseMassB);
+	_velocitiesY[b] += Mul(Mul(normalY, impulse), inverseMassB);
+}
+
+std::size_t PhysicsWorld::LuaGetContactCount() const noexcept
+{
+	return _contacts.size();
+}
+
+std::tuple<PhysicsWorld::BodyID, PhysicsWorld::BodyID, std::double_t, std::double_t, std::double_t> PhysicsWorld::LuaGetContact(std::size_t index) const noexcept
+{
+	if (index == 0 || index > _contacts.size()) [[unlikely]]
+	{
+		return {0, 0, 0.0, 0.0, 0.0};
+	}
+
+	const Contact &contact = _contacts[index - 1];
+	return {contact.a, contact.b, FromFixed(contact.normalX), FromFixed(contact.normalY), FromFixed(contact.depth)};
+}
+
+std::uint64_t PhysicsWorld::LuaGetStateHash() const noexcept
+{
+	return GetStateHash() & ((1ull << 53) - 1);
+}
@@ -0,0 +1,420 @@
+/**
+ * @file Gameplay/TileMap.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Gameplay/TileMap.hpp"
+
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace tudov;
+
+/**
+ * Drop values left from a previous fill of a reused buffer, starting at lua index `from`.
+ */
+static void ClearTail(sol::table &buffer, std::size_t from) noexcept
+{
+	for (std::size_t i = from; buffer.raw_get<sol::object>(i).get_type() != sol::type::lua_nil; ++i)
+	{
+		buffer.raw_set(i, sol::lua_nil);
+	}
+}
+
+TileMap::TileMap(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::size_t layers) noexcept
+    : _x(x),
+      _y(y),
+      _width(std::max(width, 1)),
+      _height(std::max(height, 1)),
+      _layers(std::max<std::size_t>(layers, 1), std::vector<TypeID>(static_cast<std::size_t>(_width) * _height, TypeID(0))),
+      _typeInfos(),
+      _chunksX((_width + ChunkSize - 1) / ChunkSize),
+      _chunksY((_height + ChunkSize - 1) / ChunkSize),
+      _dirtyChunks(static_cast<std::size_t>(_chunksX) * _chunksY, 1),
+      _dirtyChunkCount(_dirtyChunks.size())
+{
+}
+
+std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t> TileMap::GetBounds() const noexcept
+{
+	return {_x, _y, _width, _height};
+}
+
+bool TileMap::IsInBound(std::int32_t x, std::int32_t y) const noexcept
+{
+	return x >= _x && y >= _y && x < _x + _width && y < _y + _height;
+}
+
+std::size_t TileMap::GetLayerCount() const noexcept
+{
+	return _layers.size();
+}
+
+TileMap::TypeID TileMap::GetType(std::size_t layer, std::int32_t x, std::int32_t y) const noexcept
+{
+	if (layer >= _layers.size() || !IsInBound(x, y)) [[unlikely]]
+	{
+		return 0;
+	}
+	return _layers[layer][ToIndex(x, y)];
+}
+
+bool TileMap::SetType(std::size_t layer, std::int32_t x, std::int32_t y, TypeID type) noexcept
+{
+	if (layer >= _layers.size() || !IsInBound(x, y)) [[unlikely]]
+	{
+		return false;
+	}
+
+	TypeID &tile = _layers[layer][ToIndex(x, y)];
+	if (tile != type)
+	{
+		tile = type;
+		MarkDirty(x, y, 1, 1);
+	}
+	return true;
+}
+
+void TileMap::Fill(std::size_t layer, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TypeID type) noexcept
+{
+	if (layer >= _layers.size()) [[unlikely]]
+	{
+		return;
+	}
+
+	std::int32_t left = std::max(x, _x);
+	std::int32_t top = std::max(y, _y);
+	auto right = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(x) + width, _x + _width));
+	auto bottom = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(y) + height, _y + _height));
+	if (left >= right || top >= bottom)
+	{
+		return;
+	}
+
+	std::vector<TypeID> &types = _layers[layer];
+	for (std::int32_t ty = top; ty < bottom; ++ty)
+	{
+		auto begin = types.begin() + ToIndex(left, ty);
+		std::fill(begin, begin + (right - left), type);
+	}
+
+	MarkDirty(left, top, right - left, bottom - top);
+}
+
+std::span<const TileMap::TypeID> TileMap::GetLayer(std::size_t layer) const noexcept
+{
+	if (layer >= _layers.size()) [[unlikely]]
+	{
+		return {};
+	}
+	return _layers[layer];
+}
+
+std::span<const TileMap::TypeID> TileMap::GetRow(std::size_t layer, std::int32_t y) const noexcept
+{
+	if (layer >= _layers.size() || y < _y || y >= _y + _height) [[unlikely]]
+	{
+		return {};
+	}
+	return std::span<const TypeID>(_layers[layer]).subspan(ToIndex(_x, y), _width);
+}
+
+const TileMap::TypeInfo *TileMap::GetTypeInfo(TypeID type) const noexcept
+{
+	if (type >= _typeInfos.size() || !_typeInfos[type].valid)
+	{
+		return nullptr;
+	}
+	return &_typeInfos[type];
+}
+
+void TileMap::SetTypeInfo(TypeID type, Tag tag, Flags flags) noexcept
+{
+	if (type >= _typeInfos.size())
+	{
+		_typeInfos.resize(static_cast<std::size_t>(type) + 1, TypeInfo{.tag = 0, .flags = 0, .valid = false});
+	}
+
+	TypeInfo &info = _typeInfos[type];
+	if (!info.valid || info.tag != tag || info.flags != flags)
+	{
+		info = TypeInfo{.tag = tag, .flags = flags, .valid = true};
+		MarkAllDirty();
+	}
+}
+
+void TileMap::ClearTypeInfos() noexcept
+{
+	_typeInfos.clear();
+	MarkAllDirty();
+}
+
+const TileMap::TypeInfo *TileMap::GetTileInfo(std::size_t layer, std::int32_t x, std::int32_t y) const noexcept
+{
+	if (layer >= _layers.size() || !IsInBound(x, y)) [[unlikely]]
+	{
+		return nullptr;
+	}
+	return GetTypeInfo(_layers[layer][ToIndex(x, y)]);
+}
+
+std::uint8_t TileMap::GetNeighbourMask(std::size_t layer, std::int32_t x, std::int32_t y, Tag tag) const noexcept
+{
+	const TypeInfo *up = GetTileInfo(layer, x, y - 1);
+	const TypeInfo *right = GetTileInfo(layer, x + 1, y);
+	const TypeInfo *down = GetTileInfo(layer, x, y + 1);
+	const TypeInfo *left = GetTileInfo(layer, x - 1, y);
+
+	std::uint8_t mask = 0;
+	if (up != nullptr && up->tag == tag)
+	{
+		mask |= NeighbourUp;
+	}
+	if (right != nullptr)
+	{
+		mask |= right->tag == tag ? NeighbourRight | NeighbourRightHasInfo : NeighbourRightHasInfo;
+	}
+	if (down != nullptr && down->tag == tag)
+	{
+		mask |= NeighbourDown;
+	}
+	if (left != nullptr)
+	{
+		mask |= left->tag == tag ? NeighbourLeft | NeighbourLeftHasInfo : NeighbourLeftHasInfo;
+	}
+	return mask;
+}
+
+bool TileMap::IsDirty() const noexcept
+{
+	return _dirtyChunkCount != 0;
+}
+
+void TileMap::MarkDirty(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept
+{
+	std::int32_t left = std::max(x, _x) - _x;
+	std::int32_t top = std::max(y, _y) - _y;
+	auto right = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(x) + width, _x + _width) - _x);
+	auto bottom = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(y) + height, _y + _height) - _y);
+	if (left >= right || top >= bottom)
+	{
+		return;
+	}
+
+	for (std::int32_t cy = top / ChunkSize; cy <= (bottom - 1) / ChunkSize; ++cy)
+	{
+		for (std::int32_t cx = left / ChunkSize; cx <= (right - 1) / ChunkSize; ++cx)
+		{
+			std::uint8_t &dirty = _dirtyChunks[cy * _chunksX + cx];
+			if (!dirty)
+			{
+				dirty = 1;
+				++_dirtyChunkCount;
+			}
+		}
+	}
+}
+
+void TileMap::MarkAllDirty() noexcept
+{
+	std::fill(_dirtyChunks.begin(), _dirtyChunks.end(), 1);
+	_dirtyChunkCount = _dirtyChunks.size();
+}
+
+std::vector<std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t>> TileMap::GetDirtyRegions() const noexcept
+{
+	std::vector<std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t>> regions;
+	regions.reserve(_dirtyChunkCount);
+
+	for (std::int32_t cy = 0; cy < _chunksY; ++cy)
+	{
+		for (std::int32_t cx = 0; cx < _chunksX; ++cx)
+		{
+			if (_dirtyChunks[cy * _chunksX + cx])
+			{
+				std::int32_t left = cx * ChunkSize;
+				std::int32_t top = cy * ChunkSize;
+				regions.emplace_back(_x + left, _y + top, std::min(ChunkSize, _width - left), std::min(ChunkSize, _height - top));
+			}
+		}
+	}
+
+	return regions;
+}
+
+void TileMap::ClearDirty() noexcept
+{
+	if (_dirtyChunkCount != 0)
+	{
+		std::fill(_dirtyChunks.begin(), _dirtyChunks.end(), 0);
+		_dirtyChunkCount = 0;
+	}
+}
+
+std::size_t TileMap::ToIndex(std::int32_t x, std::int32_t y) const noexcept
+{
+	return static_cast<std::size_t>(y - _y) * _width + (x - _x);
+}
+
+std::size_t TileMap::ToLayer(sol::object layer) noexcept
+{
+	// Layers are 1-based in lua, default to the first one.
+	if (layer.is<std::double_t>())
+	{
+		auto index = layer.as<std::double_t>();
+		return index >= 1 ? static_cast<std::size_t>(index) - 1 : SIZE_MAX;
+	}
+	return 0;
+}
+
+void TileMap::LuaLoadTypeIDs(sol::table typeIDs, sol::object layer) noexcept
+{
+	std::size_t layer_ = ToLayer(layer);
+	if (layer_ >= _layers.size()) [[unlikely]]
+	{
+		return;
+	}
+
+	std::vector<TypeID> &types = _layers[layer_];
+	for (std::size_t i = 0; i < types.size(); ++i)
+	{
+		types[i] = typeIDs.get_or<TypeID>(i + 1, 0);
+	}
+
+	MarkAllDirty();
+}
+
+std::uint32_t TileMap::LuaGetType(std::int32_t x, std::int32_t y, sol::object layer) const noexcept
+{
+	return GetType(ToLayer(layer), x, y);
+}
+
+bool TileMap::LuaSetType(std::int32_t x, std::int32_t y, TypeID type, sol::object layer) noexcept
+{
+	return SetType(ToLayer(layer), x, y, type);
+}
+
+void TileMap::LuaFill(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TypeID type, sol::object layer) noexcept
+{
+	Fill(ToLayer(layer), x, y, width, height, type);
+}
+
+sol::object TileMap::LuaGetTag(std::int32_t x, std::int32_t y, sol::object layer, sol::this_state ts) const noexcept
+{
+	const TypeInfo *info = GetTileInfo(ToLayer(layer), x, y);
+	return info != nullptr ? sol::make_object(ts, info->tag) : sol::lua_nil;
+}
+
+sol::object TileMap::LuaGetFlags(std::int32_t x, std::int32_t y, sol::object layer, sol::this_state ts) const noexcept
+{
+	const TypeInfo *info = GetTileInfo(ToLayer(layer), x, y);
+	return info != nullptr ? sol::make_object(ts, info->flags) : sol::lua_nil;
+}
+
+bool TileMap::LuaHasFlags(std::int32_t x, std::int32_t y, Flags flags, sol::object layer) const noexcept
+{
+	const TypeInfo *info = GetTileInfo(ToLayer(layer), x, y);
+	return info != nullptr && (info->flags & flags) == flags;
+}
+
+sol::table TileMap::LuaGetRow(std::int32_t y, sol::object buffer, sol::object layer, sol::this_state ts) const noexcept
+{
+	std::span<const TypeID> row = GetRow(ToLayer(layer), y);
+
+	sol::table result = buffer.is<sol::table>() ? buffer.as<sol::table>() : sol::state_view(ts).create_table(static_cast<int>(row.size()), 0);
+	for (std::size_t i = 0; i < row.size(); ++i)
+	{
+		result[i + 1] = row[i];
+	}
+	ClearTail(result, row.size() + 1);
+	return result;
+}
+
+sol::table TileMap::LuaGetNeighbourRow(std::int32_t y, Tag tag, sol::object buffer, sol::object layer, sol::this_state ts) const noexcept
+{
+	std::size_t layer_ = ToLayer(layer);
+	std::span<const TypeID> row = GetRow(layer_, y);
+
+	sol::table result = buffer.is<sol::table>() ? buffer.as<sol::table>() : sol::state_view(ts).create_table(static_cast<int>(row.size()), 0);
+	for (std::size_t i = 0; i < row.size(); ++i)
+	{
+		result[i + 1] = GetNeighbourMask(layer_, _x + static_cast<std::int32_t>(i), y, tag);
+	}
+	ClearTail(result, row.size() + 1);
+	return result;
+}
+
+sol::table TileMap::LuaGetRect(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, sol::object layer, sol::this_state ts) const noexcept
+{
+	std::size_t layer_ = ToLayer(layer);
+	// Compute in 64 bits and stop at the last representable coordinate, `x + width` may overflow otherwise.
+	std::int64_t right = std::int64_t(x) + std::clamp<std::int64_t>(width, 0, std::int64_t(INT32_MAX) - x + 1);
+	std::int64_t bottom = std::int64_t(y) + std::clamp<std::int64_t>(height, 0, std::int64_t(INT32_MAX) - y + 1);
+	std::int64_t count = (right - x) * (bottom - y);
+
+	sol::table result = sol::state_view(ts).create_table(static_cast<int>(std::min<std::int64_t>(count, INT_MAX)), 0);
+	std::size_t index = 1;
+	for (std::int64_t ty = y; ty < bottom; ++ty)
+	{
+		for (std::int64_t tx = x; tx < right; ++tx)
+		{
+			result[index++] = GetType(layer_, static_cast<std::int32_t>(tx), static_cast<std::int32_t>(ty));
+		}
+	}
+	return result;
+}
+
+sol::table TileMap::LuaQueryTag(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, Tag tag, sol::object layer, sol::this_state ts) const noexcept
+{
+	std::size_t layer_ = ToLayer(layer);
+	std::int32_t left = std::max(x, _x);
+	std::int32_t top = std::max(y, _y);
+	auto right = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(x) + width, _x + _width));
+	auto bottom = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t(y) + height, _y + _height));
+
+	sol::table result = sol::state_view(ts).create_table();
+	if (layer_ >= _layers.size()) [[unlikely]]
+	{
+		return result;
+	}
+
+	const std::vector<TypeID> &types = _layers[layer_];
+	std::size_t index = 1;
+	for (std::int32_t ty = top; ty < bottom; ++ty)
+	{
+		for (std::int32_t tx = left; tx < right; ++tx)
+		{
+			const TypeInfo *info = GetTypeInfo(types[ToIndex(tx, ty)]);
+			if (info != nullptr && info->tag == tag)
+			{
+				result[index++] = tx;
+				result[index++] = ty;
+			}
+		}
+	}
+	return result;
+}
+
+sol::table TileMap::LuaGetDirtyRegions(sol::this_state ts) const noexcept
+{
+	sol::table result = sol::state_view(ts).create_table(static_cast<int>(_dirtyChunkCount * 4), 0);
+
+	std::size_t index = 1;
+	for (auto &&[x, y, width, height] : GetDirtyRegions())
+	{
+		result[index++] = x;
+		result[index++] = y;
+		result[index++] = width;
+		result[index++] = height;
+	}
+	return result;
+}
@@ -22,7 +22,7 @@
 
 using namespace tudov;
 
-Font::Font(std::string_view path, const std::vector<std::byte> &bytes) noexcept
+Font::Font(std::string_view path, std::span<const std::byte> bytes) noexcept
     : _bytes(bytes.begin(), bytes.end())
 {
 }
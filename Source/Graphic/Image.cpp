@@ -11,6 +11,8 @@
 
 #include "Graphic/Image.hpp"
 
+#include "Resource/DecodedImageCache.hpp"
+
 #include "SDL3/SDL_Surface.h"
 #include "SDL3/SDL_error.h"
 #include "SDL3/SDL_log.h"
@@ -21,28 +23,31 @@
 
 using namespace tudov;
 
-Image::Image(std::string_view path, const std::vector<std::byte> &bytes)
-    : _path(path)
+Image::Image(std::string_view path, std::span<const std::byte> bytes, DecodedImageCache *cache, std::optional<BlobHash> hash)
+    : _path(path),
+      _sdlSurface(nullptr)
 {
+	if (cache != nullptr)
+	{
+		_sdlSurface = cache->Decode(bytes, hash);
+		return;
+	}
+
 	SDL_IOStream *io = SDL_IOFromConstMem(bytes.data(), bytes.size());
 	if (!io) [[unlikely]]
 	{
 		throw std::runtime_error(std::format("SDL_IOFromConstMem failed: {}", SDL_GetError()));
 	}
 
-	_sdlSurface = IMG_Load_IO(io, true);
-	if (!_sdlSurface) [[unlikely]]
+	SDL_Surface *sdlSurface = IMG_Load_IO(io, true);
+	if (!sdlSurface) [[unlikely]]
 	{
 		throw std::runtime_error(std::format("IMG_Load_IO failed: {}", SDL_GetError()));
 	}
-}
-
-Image::~Image() noexcept
-{
-	if (_sdlSurface)
+	_sdlSurface = std::shared_ptr<impl::SDL_Surface>(sdlSurface, [](impl::SDL_Surface *sdlSurface)
 	{
-		SDL_DestroySurface(static_cast<SDL_Surface *>(_sdlSurface));
-	}
+		SDL_DestroySurface(static_cast<SDL_Surface *>(sdlSurface));
+	});
 }
 
 std::string_view Image::GetFilePath() const noexcept
@@ -69,20 +74,24 @@ void Image::Initialize(std::string_view memory) noexcept
 		return;
 	}
 
-	_sdlSurface = IMG_Load_IO(rw, 1);
-	if (!_sdlSurface)
+	SDL_Surface *sdlSurface = IMG_Load_IO(rw, 1);
+	if (!sdlSurface)
 	{
 		SDL_Log("IMG_Load_IO failed: %s", SDL_GetError());
 		return;
 	}
+	_sdlSurface = std::shared_ptr<impl::SDL_Surface>(sdlSurface, [](impl::SDL_Surface *sdlSurface)
+	{
+		SDL_DestroySurface(static_cast<SDL_Surface *>(sdlSurface));
+	});
 }
 
 impl::SDL_Surface *Image::GetSDLSurfaceHandle() noexcept
 {
-	return static_cast<SDL_Surface *>(_sdlSurface);
+	return _sdlSurface.get();
 }
 
 const impl::SDL_Surface *Image::GetSDLSurfaceHandle() const noexcept
 {
-	return static_cast<SDL_Surface *>(_sdlSurface);
+	return _sdlSurface.get();
 }
@@ -13,7 +13,7 @@
 
 using namespace tudov;
 
-Binaries::Binaries(std::string_view path, const std::vector<std::byte> &bytes) noexcept
+Binaries::Binaries(std::string_view path, std::span<const std::byte> bytes) noexcept
     : _path(path),
       _bytes(bytes.begin(), bytes.end())
 {
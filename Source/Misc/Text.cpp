@@ -15,7 +15,7 @@
 
 using namespace tudov;
 
-Text::Text(std::string_view path, const std::vector<std::byte> &bytes) noexcept
+Text::Text(std::string_view path, std::span<const std::byte> bytes) noexcept
     : _path(path)
 {
 	std::string_view view{reinterpret_cast<const char *>(bytes.data()), bytes.size()};
@@ -253,6 +253,8 @@ void LuaBindings::ProvideLuaBindings(sol::state &lua, Context &context)
 	    "vfs", &dynamic_cast<VirtualFileSystem &>(context.GetVirtualFileSystem()));
 
 	InstallEvent(lua, context);
+	InstallFFI(lua, context);
+	InstallGameplay(lua, context);
 	InstallKeyModifier(lua, context);
 	InstallMod(lua, context);
 	InstallNetwork(lua, context);
@@ -306,14 +308,22 @@ const std::vector<std::string_view> &LuaBindings::GetModGlobalsMigration() const
 		    TE_NAMEOF(EPathListOption),
 		    TE_NAMEOF(EServerSessionState),
 		    TE_NAMEOF(EScanCode),
+		    TE_NAMEOF(EScriptProfileFormat),
 		    TE_NAMEOF(ESocketType),
 		    // C++ userdata classes
 		    TE_NAMEOF(DrawRectArgs),
 		    TE_NAMEOF(DrawTextArgs),
+		    TE_NAMEOF(EntityRegistry),
+		    TE_NAMEOF(LevelGenerator),
+		    TE_NAMEOF(PathGrid),
 		    TE_NAMEOF(PerlinNoiseRandom),
+		    TE_NAMEOF(PhysicsWorld),
 		    TE_NAMEOF(RectangleF),
+		    TE_NAMEOF(SchemaCodec),
+		    TE_NAMEOF(TileMap),
 		    TE_NAMEOF(Timer),
 		    TE_NAMEOF(Version),
+		    TE_NAMEOF(ZombieManager),
 		    // C++ static classes
 		    TE_NAMEOF(OperatingSystem),
 		    TE_NAMEOF(RandomDevice),
@@ -332,7 +342,9 @@ const std::vector<std::string_view> &LuaBindings::GetModGlobalsMigration() const
 		    "scriptEngine",
 		    "scriptErrors",
 		    "scriptLoader",
+		    "scriptProfiler",
 		    "scriptProvider",
+		    "scriptWorkers",
 		    "vfs",
 		};
 	}
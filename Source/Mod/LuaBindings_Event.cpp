@@ -11,6 +11,7 @@
 
 #include "Mod/LuaBindings.hpp"
 
+#include "Debug/ScriptProfiler.hpp"
 #include "Event/CoreEventsData.hpp"
 #include "Event/EventInvocation.hpp"
 #include "Event/EventManager.hpp"
@@ -37,6 +38,13 @@ void LuaBindings::InstallEvent(sol::state &lua, Context &context) noexcept
 	        {"Default", EEventInvocation::Default},
 	    });
 
+	TE_LB_ENUM(
+	    EScriptProfileFormat,
+	    {
+	        {"Collapsed", EScriptProfileFormat::Collapsed},
+	        {"ChromeTrace", EScriptProfileFormat::ChromeTrace},
+	    });
+
 	TE_LB_USERTYPE(
 	    RuntimeEvent,
 	    "getInvokingScriptID", &RuntimeEvent::GetInvokingScriptID,
@@ -91,6 +99,15 @@ void LuaBindings::InstallEvent(sol::state &lua, Context &context) noexcept
 	    "scriptID", &EventScriptUnloadData::scriptID,
 	    "scriptName", &EventScriptUnloadData::scriptName);
 
+	TE_LB_USERTYPE(
+	    ScriptProfiler,
+	    "clear", &ScriptProfiler::Clear,
+	    "export", &ScriptProfiler::LuaExport,
+	    "getTotalSamples", &ScriptProfiler::GetTotalSamples,
+	    "isRunning", &ScriptProfiler::IsRunning,
+	    "start", &ScriptProfiler::LuaStart,
+	    "stop", &ScriptProfiler::Stop);
+
 	TE_LB_USERTYPE(
 	    EventWindowResizeData,
 	    "height", &EventWindowResizeData::height,
@@ -99,4 +116,5 @@ void LuaBindings::InstallEvent(sol::state &lua, Context &context) noexcept
 	    "windowID", &EventWindowResizeData::windowID);
 
 	lua["TE"]["events"] = &dynamic_cast<EventManager &>(context.GetEventManager());
+	lua["TE"]["scriptProfiler"] = &context.GetEventManager().GetScriptProfiler();
 }
@@ -0,0 +1,56 @@
+/**
+ * @file Mod/LuaBindings_FFI.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Mod/LuaBindings.hpp"
+
+#include "Graphic/RenderBuffer.hpp"
+#include "Graphic/Renderer.hpp"
+#include "Mod/LuaFFI.hpp"
+#include "Util/MicrosImpl.hpp"
+#include "Util/NoiseRandoms.hpp"
+
+#include <format>
+
+using namespace tudov;
+
+#define TE_FFI_FUNCTION_POINTER(Function) reinterpret_cast<void *>(&Function)
+
+/**
+ * Raw pointer of a genuine `T` userdata, checked against its usertype metatable. Lua values that merely look like one,
+ * e.g. tables with same methods, raise an error instead of becoming a pointer.
+ */
+template <typename T>
+static void *GetFFIHandle(sol::stack_object object, std::string_view typeName)
+{
+	if (!object.is<T>()) [[unlikely]]
+	{
+		throw sol::error(std::format("Expected {}, got {}", typeName, sol::type_name(object.lua_state(), object.get_type())));
+	}
+	return &object.as<T &>();
+}
+
+void LuaBindings::InstallFFI(sol::state &lua, Context &context) noexcept
+{
+	// Not listed in mod globals migration, only static scripts (e.g. `#TE.FFI`) are able to cast these pointers.
+	TE_LB_CLASS(
+	    FFIExports,
+	    "perlinNoiseRandomFloat2", TE_FFI_FUNCTION_POINTER(TE_FFI_PerlinNoiseRandom_Float2),
+	    "perlinNoiseRandomHandle", [](sol::stack_object object) { return GetFFIHandle<PerlinNoiseRandom>(object, "PerlinNoiseRandom"); },
+	    "perlinNoiseRandomInt2", TE_FFI_FUNCTION_POINTER(TE_FFI_PerlinNoiseRandom_Int2),
+	    "perlinNoiseRandomInt3", TE_FFI_FUNCTION_POINTER(TE_FFI_PerlinNoiseRandom_Int3),
+	    "perlinNoiseRandomNoise2", TE_FFI_FUNCTION_POINTER(TE_FFI_PerlinNoiseRandom_Noise2),
+	    "perlinNoiseRandomNoise3", TE_FFI_FUNCTION_POINTER(TE_FFI_PerlinNoiseRandom_Noise3),
+	    "renderBufferAddRectangle", TE_FFI_FUNCTION_POINTER(TE_FFI_RenderBuffer_AddRectangle),
+	    "renderBufferHandle", [](sol::stack_object object) { return GetFFIHandle<RenderBuffer>(object, "RenderBuffer"); },
+	    "rendererDrawRect", TE_FFI_FUNCTION_POINTER(TE_FFI_Renderer_DrawRect),
+	    "rendererDrawRectNoSource", TE_FFI_FUNCTION_POINTER(TE_FFI_Renderer_DrawRectNoSource),
+	    "rendererHandle", [](sol::stack_object object) { return GetFFIHandle<Renderer>(object, "Renderer"); });
+}
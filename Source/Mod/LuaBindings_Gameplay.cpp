@@ -0,0 +1,142 @@
+/**
+ * @file Mod/LuaBindings_Gameplay.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Mod/LuaBindings.hpp"
+
+#include "Gameplay/EntityRegistry.hpp"
+#include "Gameplay/LevelGenerator.hpp"
+#include "Gameplay/PathGrid.hpp"
+#include "Gameplay/PhysicsWorld.hpp"
+#include "Gameplay/TileMap.hpp"
+#include "Scripts/Client/ZombieManager.hpp"
+#include "Util/MicrosImpl.hpp"
+
+using namespace tudov;
+
+void LuaBindings::InstallGameplay(sol::state &lua, Context &context) noexcept
+{
+	TE_LB_USERTYPE(
+	    EntityRegistry,
+	    sol::call_constructor, sol::constructors<EntityRegistry()>(),
+	    "clear", &EntityRegistry::Clear,
+	    "commit", &EntityRegistry::Commit,
+	    "count", &EntityRegistry::Count,
+	    "countByType", &EntityRegistry::CountByType,
+	    "despawn", &EntityRegistry::Despawn,
+	    "deserialize", &EntityRegistry::LuaDeserialize,
+	    "entityAt", &EntityRegistry::LuaGetEntityAt,
+	    "exists", &EntityRegistry::Exists,
+	    "fillEntities", &EntityRegistry::LuaFillEntities,
+	    "getComponent", &EntityRegistry::LuaGetComponent,
+	    "getMaxTypeID", &EntityRegistry::GetMaxTypeID,
+	    "getTypeID", &EntityRegistry::LuaGetTypeID,
+	    "hasArchetype", &EntityRegistry::HasArchetype,
+	    "registerArchetype", &EntityRegistry::LuaRegisterArchetype,
+	    "reserve", &EntityRegistry::Reserve,
+	    "serialize", &EntityRegistry::LuaSerialize,
+	    "setComponent", &EntityRegistry::SetComponent,
+	    "spawn", &EntityRegistry::Spawn);
+
+	TE_LB_USERTYPE(
+	    LevelGenerator,
+	    sol::call_constructor, sol::constructors<LevelGenerator()>(),
+	    "generate", &LevelGenerator::LuaGenerate,
+	    "getPendingCount", &LevelGenerator::GetPendingCount,
+	    "poll", &LevelGenerator::LuaPoll,
+	    "request", &LevelGenerator::LuaRequest);
+
+	TE_LB_USERTYPE(
+	    PhysicsWorld,
+	    sol::call_constructor, sol::constructors<PhysicsWorld(), PhysicsWorld(std::double_t cellSize)>(),
+	    "addCircle", &PhysicsWorld::AddCircle,
+	    "addRect", &PhysicsWorld::AddRect,
+	    "clear", &PhysicsWorld::Clear,
+	    "deserialize", &PhysicsWorld::Deserialize,
+	    "getBodyCount", &PhysicsWorld::GetBodyCount,
+	    "getCellSize", &PhysicsWorld::GetCellSize,
+	    "getContact", &PhysicsWorld::LuaGetContact,
+	    "getContactCount", &PhysicsWorld::LuaGetContactCount,
+	    "getPosition", &PhysicsWorld::GetPosition,
+	    "getStateHash", &PhysicsWorld::LuaGetStateHash,
+	    "getVelocity", &PhysicsWorld::GetVelocity,
+	    "hasBody", &PhysicsWorld::HasBody,
+	    "removeBody", &PhysicsWorld::RemoveBody,
+	    "serialize", &PhysicsWorld::Serialize,
+	    "setCellSize", &PhysicsWorld::SetCellSize,
+	    "setPosition", &PhysicsWorld::SetPosition,
+	    "setVelocity", &PhysicsWorld::SetVelocity,
+	    "step", &PhysicsWorld::Step);
+
+	TE_LB_USERTYPE(
+	    PathGrid,
+	    sol::call_constructor, sol::constructors<PathGrid(std::int32_t, std::int32_t, std::int32_t, std::int32_t)>(),
+	    "clearFlowFields", &PathGrid::ClearFlowFields,
+	    "computeFlowField", &PathGrid::LuaComputeFlowField,
+	    "findPath", &PathGrid::LuaFindPath,
+	    "getBounds", &PathGrid::GetBounds,
+	    "getCost", &PathGrid::GetCost,
+	    "getFlowDirection", &PathGrid::LuaGetFlowDirection,
+	    "hasFlowField", &PathGrid::LuaHasFlowField,
+	    "isDiagonal", &PathGrid::IsDiagonal,
+	    "isInBound", &PathGrid::IsInBound,
+	    "loadTileMap", &PathGrid::LuaLoadTileMap,
+	    "loadTypeIDs", &PathGrid::LuaLoadTypeIDs,
+	    "requestFlowField", &PathGrid::RequestFlowField,
+	    "setCost", &PathGrid::SetCost,
+	    "setDiagonal", &PathGrid::SetDiagonal);
+
+	TE_LB_USERTYPE(
+	    TileMap,
+	    sol::call_constructor, sol::constructors<TileMap(std::int32_t, std::int32_t, std::int32_t, std::int32_t), TileMap(std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::size_t)>(),
+	    "clearDirty", &TileMap::ClearDirty,
+	    "clearTypeInfos", &TileMap::ClearTypeInfos,
+	    "fill", &TileMap::LuaFill,
+	    "getBounds", &TileMap::GetBounds,
+	    "getDirtyRegions", &TileMap::LuaGetDirtyRegions,
+	    "getFlags", &TileMap::LuaGetFlags,
+	    "getLayerCount", &TileMap::GetLayerCount,
+	    "getNeighbourRow", &TileMap::LuaGetNeighbourRow,
+	    "getRect", &TileMap::LuaGetRect,
+	    "getRow", &TileMap::LuaGetRow,
+	    "getTag", &TileMap::LuaGetTag,
+	    "getType", &TileMap::LuaGetType,
+	    "hasFlags", &TileMap::LuaHasFlags,
+	    "isDirty", &TileMap::IsDirty,
+	    "isInBound", &TileMap::IsInBound,
+	    "loadTypeIDs", &TileMap::LuaLoadTypeIDs,
+	    "markDirty", &TileMap::MarkDirty,
+	    "queryTag", &TileMap::LuaQueryTag,
+	    "setType", &TileMap::LuaSetType,
+	    "setTypeInfo", &TileMap::SetTypeInfo);
+
+	TE_LB_USERTYPE(
+	    ZombieManager,
+	    sol::call_constructor, sol::constructors<ZombieManager()>(),
+	    "clear", &ZombieManager::Clear,
+	    "count", &ZombieManager::Count,
+	    "deserialize", &ZombieManager::LuaDeserialize,
+	    "despawn", &ZombieManager::Despawn,
+	    "exists", &ZombieManager::Exists,
+	    "getFlags", &ZombieManager::LuaGetFlags,
+	    "getHealth", &ZombieManager::LuaGetHealth,
+	    "getObjectIDs", &ZombieManager::LuaGetObjectIDs,
+	    "getPosition", &ZombieManager::LuaGetPosition,
+	    "getVelocity", &ZombieManager::LuaGetVelocity,
+	    "objectAt", &ZombieManager::LuaGetObjectAt,
+	    "reserve", &ZombieManager::Reserve,
+	    "serialize", &ZombieManager::LuaSerialize,
+	    "setFlags", &ZombieManager::LuaSetFlags,
+	    "setHealth", &ZombieManager::LuaSetHealth,
+	    "setPosition", &ZombieManager::LuaSetPosition,
+	    "setVelocity", &ZombieManager::LuaSetVelocity,
+	    "spawn", &ZombieManager::LuaSpawn,
+	    "update", &ZombieManager::Update);
+}
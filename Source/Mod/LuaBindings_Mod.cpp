@@ -16,6 +16,7 @@
 #include "Mod/ModManager.hpp"
 #include "Mod/ScriptErrors.hpp"
 #include "Mod/ScriptLoader.hpp"
+#include "Mod/ScriptWorkers.hpp"
 #include "sol/property.hpp"
 
 using namespace tudov;
@@ -74,12 +75,20 @@ void LuaBindings::InstallMod(sol::state &lua, Context &context) noexcept
 	    "getScriptIDByName", &ScriptProvider::GetScriptIDByName,
 	    "getScriptNameByID", &ScriptProvider::GetScriptNameByID);
 
+	TE_LB_USERTYPE(
+	    ScriptWorkers,
+	    "cancel", &ScriptWorkers::LuaCancel,
+	    "getPendingJobs", &ScriptWorkers::GetPendingJobs,
+	    "getWorkerCount", &ScriptWorkers::GetWorkerCount,
+	    "submit", &ScriptWorkers::LuaSubmit);
+
 	auto TE = lua["TE"];
 	TE["mods"] = &dynamic_cast<ModManager &>(context.GetModManager());
 	TE["scriptEngine"] = &dynamic_cast<ScriptEngine &>(context.GetScriptEngine());
 	TE["scriptErrors"] = &dynamic_cast<ScriptErrors &>(context.GetScriptErrors());
 	TE["scriptLoader"] = &dynamic_cast<ScriptLoader &>(context.GetScriptLoader());
 	TE["scriptProvider"] = &dynamic_cast<ScriptProvider &>(context.GetScriptProvider());
+	TE["scriptWorkers"] = &dynamic_cast<ScriptWorkers &>(context.GetScriptWorkers());
 
 	lua.set_function("getModConfig", [this, &context](sol::string_view modUID) -> ModConfig *
 	{
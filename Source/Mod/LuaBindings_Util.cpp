@@ -14,6 +14,7 @@
 #include "Event/CoreEventsData.hpp"
 #include "Util/MicrosImpl.hpp"
 #include "Util/NoiseRandoms.hpp"
+#include "Util/SchemaCodec.hpp"
 #include "Util/Version.hpp"
 
 #include "sol/property.hpp"
@@ -33,6 +34,8 @@ void LuaBindings::InstallUtil(sol::state &lua, Context &context) noexcept
 	TE_LB_USERTYPE(
 	    PerlinNoiseRandom,
 	    sol::call_constructor, sol::constructors<PerlinNoiseRandom(), PerlinNoiseRandom(std::int32_t seed), PerlinNoiseRandom(std::int32_t seed, std::float_t _frequency)>(),
+	    "fillInt2", &PerlinNoiseRandom::LuaFillInt2,
+	    "fillNoise2", &PerlinNoiseRandom::LuaFillNoise2,
 	    "float1", &PerlinNoiseRandom::Float1,
 	    "float2", &PerlinNoiseRandom::Float2,
 	    "float3", &PerlinNoiseRandom::Float3,
@@ -44,6 +47,19 @@ void LuaBindings::InstallUtil(sol::state &lua, Context &context) noexcept
 	    "noise1", &PerlinNoiseRandom::Noise1,
 	    "noise2", &PerlinNoiseRandom::Noise2,
 	    "noise3", &PerlinNoiseRandom::Noise3,
+	    "sampleInt2", &PerlinNoiseRandom::LuaSampleInt2,
+	    "sampleNoise2", &PerlinNoiseRandom::LuaSampleNoise2,
 	    "setFrequency", &PerlinNoiseRandom::SetFrequency,
 	    "setSeed", &PerlinNoiseRandom::SetSeed);
+
+	TE_LB_USERTYPE(
+	    SchemaCodec,
+	    sol::call_constructor, sol::constructors<SchemaCodec()>(),
+	    "clear", &SchemaCodec::Clear,
+	    "compile", &SchemaCodec::Compile,
+	    "decode", &SchemaCodec::Decode,
+	    "decodeList", &SchemaCodec::DecodeList,
+	    "encode", &SchemaCodec::Encode,
+	    "encodeList", &SchemaCodec::EncodeList,
+	    "hasSchema", &SchemaCodec::HasSchema);
 }
@@ -0,0 +1,105 @@
+/**
+ * @file Mod/LuaFFI.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Mod/LuaFFI.hpp"
+
+#include "Graphic/RenderBuffer.hpp"
+#include "Graphic/Renderer.hpp"
+#include "System/LogMicros.hpp"
+#include "Util/Color.hpp"
+#include "Util/NoiseRandoms.hpp"
+
+#include <exception>
+#include <memory>
+
+using namespace tudov;
+
+static constexpr const char *logName = "LuaFFI";
+
+TE_FFI_EXPORT void TE_FFI_Renderer_DrawRect(void *renderer, std::uint64_t imageID, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, std::uint32_t color) noexcept
+{
+	try
+	{
+		auto &renderer_ = *static_cast<Renderer *>(renderer);
+		std::shared_ptr<Texture> texture = imageID != 0 ? renderer_.GetOrCreateImageTexture(imageID) : nullptr;
+		SDL_FRect rectDst{dx, dy, dw, dh};
+		SDL_FRect rectSrc{sx, sy, sw, sh};
+
+		renderer_.DrawRect(texture.get(), rectDst, &rectSrc, Color(color));
+	}
+	catch (std::exception &e)
+	{
+		TE_G_ERROR(logName, "C++ exception in `{}`: {}", __func__, e.what());
+	}
+}
+
+TE_FFI_EXPORT void TE_FFI_Renderer_DrawRectNoSource(void *renderer, std::uint64_t imageID, float dx, float dy, float dw, float dh, std::uint32_t color) noexcept
+{
+	try
+	{
+		auto &renderer_ = *static_cast<Renderer *>(renderer);
+		std::shared_ptr<Texture> texture = imageID != 0 ? renderer_.GetOrCreateImageTexture(imageID) : nullptr;
+		SDL_FRect rectDst{dx, dy, dw, dh};
+
+		renderer_.DrawRect(texture.get(), rectDst, nullptr, Color(color));
+	}
+	catch (std::exception &e)
+	{
+		TE_G_ERROR(logName, "C++ exception in `{}`: {}", __func__, e.what());
+	}
+}
+
+TE_FFI_EXPORT void TE_FFI_RenderBuffer_AddRectangle(void *renderBuffer, std::uint64_t imageID, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, std::uint32_t color) noexcept
+{
+	try
+	{
+		auto &renderBuffer_ = *static_cast<RenderBuffer *>(renderBuffer);
+
+		if (imageID != 0) [[likely]]
+		{
+			std::shared_ptr<Texture> texture = renderBuffer_.renderer.GetOrCreateImageTexture(imageID);
+			renderBuffer_.AddRectangle(texture, RectangleF{dx, dy, dw, dh}, RectangleF{sx, sy, sw, sh}, Color(color));
+		}
+		else
+		{
+			renderBuffer_.AddRectangle(RectangleF{dx, dy, dw, dh}, Color(color));
+		}
+	}
+	catch (std::exception &e)
+	{
+		TE_G_ERROR(logName, "C++ exception in `{}`: {}", __func__, e.what());
+	}
+}
+
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Noise2(void *noiseRandom, float x, float y) noexcept
+{
+	return static_cast<PerlinNoiseRandom *>(noiseRandom)->Noise2(x, y);
+}
+
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Noise3(void *noiseRandom, float x, float y, float z) noexcept
+{
+	return static_cast<PerlinNoiseRandom *>(noiseRandom)->Noise3(x, y, z);
+}
+
+TE_FFI_EXPORT float TE_FFI_PerlinNoiseRandom_Float2(void *noiseRandom, float x, float y, float min, float max) noexcept
+{
+	return static_cast<PerlinNoiseRandom *>(noiseRandom)->Float2(x, y, min, max);
+}
+
+TE_FFI_EXPORT std::int32_t TE_FFI_PerlinNoiseRandom_Int2(void *noiseRandom, float x, float y, std::int32_t min, std::int32_t max) noexcept
+{
+	return static_cast<PerlinNoiseRandom *>(noiseRandom)->Int2(x, y, min, max);
+}
+
+TE_FFI_EXPORT std::int32_t TE_FFI_PerlinNoiseRandom_Int3(void *noiseRandom, float x, float y, float z, std::int32_t min, std::int32_t max) noexcept
+{
+	return static_cast<PerlinNoiseRandom *>(noiseRandom)->Int3(x, y, z, min, max);
+}
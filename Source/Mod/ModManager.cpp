@@ -27,10 +27,18 @@
 #include "Mod/ScriptProvider.hpp"
 #include "Mod/UnpackagedMod.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <format>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -160,11 +168,41 @@ void ModManager::LoadMods()
 		return lc.uid < rc.uid;
 	});
 
-	for (const std::shared_ptr<Mod> &mod : _loadedMods)
+	// Discover and read files of all mods on worker threads, nothing there touches engine state.
+	std::vector<std::vector<std::function<void()>>> modJobs(_loadedMods.size());
+	RunParallel("Discovering mod files", 0.0f, 0.1f, _loadedMods.size(), [this, &modJobs](std::size_t index)
+	{
+		modJobs[index] = _loadedMods[index]->Prepare();
+	});
+
+	std::vector<std::function<void()>> jobs;
+	for (std::vector<std::function<void()>> &prepareJobs : modJobs)
+	{
+		std::move(prepareJobs.begin(), prepareJobs.end(), std::back_inserter(jobs));
+	}
+	RunParallel("Reading mod files", 0.1f, 0.5f, jobs.size(), [&jobs](std::size_t index)
 	{
+		jobs[index]();
+	});
+
+	// Mount files and register resources, in mod order.
+	for (std::size_t index = 0; index < _loadedMods.size(); ++index)
+	{
+		const std::shared_ptr<Mod> &mod = _loadedMods[index];
+		GetEngine().SetLoadingInfo(Engine::LoadingInfoArgs{
+		    .title = "Loading mods",
+		    .description = mod->GetConfig().name,
+		    .progressValue = 0.5f + 0.25f * static_cast<std::float_t>(index) / static_cast<std::float_t>(_loadedMods.size()),
+		});
+
 		mod->Load();
 	}
 
+	GetEngine().SetLoadingInfo(Engine::LoadingInfoArgs{
+	    .title = "Loading scripts",
+	    .description = "",
+	    .progressValue = 0.75f,
+	});
 	GetScriptLoader().LoadAllScripts();
 
 	TE_DEBUG("{}", "Loaded all required mods");
@@ -211,6 +249,83 @@ void ModManager::UnloadModsDeferred() noexcept
 	GetEngine().TriggerLoadPending();
 }
 
+void ModManager::RunParallel(std::string_view stage, std::float_t progressBegin, std::float_t progressEnd, std::size_t count, const std::function<void(std::size_t)> &job) noexcept
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	std::atomic<std::size_t> next = 0;
+	std::atomic<std::size_t> done = 0;
+	std::mutex mutex;
+	std::condition_variable cv;
+
+	auto work = [this, count, &job, &next, &done, &mutex, &cv]()
+	{
+		for (std::size_t index = next++; index < count; index = next++)
+		{
+			try
+			{
+				job(index);
+			}
+			catch (const std::exception &e)
+			{
+				TE_ERROR("Exception occurred while loading mods: {}", e.what());
+			}
+
+			if (++done == count)
+			{
+				std::lock_guard<std::mutex> lock{mutex};
+				cv.notify_all();
+			}
+		}
+	};
+
+	std::uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::size_t threadCount = std::min<std::size_t>(hardwareThreads, count);
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back(work);
+	}
+
+	// This thread only reports progress, so the loading screen keeps moving.
+	Engine &engine = GetEngine();
+	std::string description = std::format("0 / {}", count);
+	engine.SetLoadingInfo(Engine::LoadingInfoArgs{
+	    .title = std::string(stage),
+	    .description = description,
+	    .progressValue = progressBegin,
+	});
+
+	std::unique_lock<std::mutex> lock{mutex};
+	while (!cv.wait_for(lock, std::chrono::milliseconds(16), [&done, count]()
+	{
+		return done == count;
+	}))
+	{
+		std::size_t doneCount = done;
+		engine.SetLoadingInfo(Engine::LoadingInfoArgs{
+		    .description = std::format("{} / {}", doneCount, count),
+		    .progressValue = progressBegin + (progressEnd - progressBegin) * static_cast<std::float_t>(doneCount) / static_cast<std::float_t>(count),
+		});
+	}
+	lock.unlock();
+
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	engine.SetLoadingInfo(Engine::LoadingInfoArgs{
+	    .description = std::format("{} / {}", count, count),
+	    .progressValue = progressEnd,
+	});
+}
+
 bool ModManager::IsModAvailable(std::string_view modUID) const noexcept
 {
 	return IsModAvailableImpl(modUID, nullptr);
@@ -370,20 +485,16 @@ void ModManager::UpdateScripts() noexcept
 	}
 
 	// When reloading updated scripts, we should also collect all scripts with errors, they might be fixed after this time.
+	// Scripts depend on them are collected by script loader.
 	for (ScriptID scriptID : GetScriptLoader().CollectErrorScripts())
 	{
 		scriptIDs.emplace_back(scriptID);
-
-		for (ScriptID dependencyScriptID : scriptLoader.GetScriptDependencies(scriptID))
-		{
-			scriptIDs.emplace_back(dependencyScriptID);
-		};
 	}
 
-	scriptIDs.erase(std::unique(scriptIDs.begin(), scriptIDs.end()), scriptIDs.end());
 	if (!scriptIDs.empty())
 	{
 		std::sort(scriptIDs.begin(), scriptIDs.end());
+		scriptIDs.erase(std::unique(scriptIDs.begin(), scriptIDs.end()), scriptIDs.end());
 
 		scriptLoader.HotReloadScripts(scriptIDs);
 	}
@@ -98,14 +98,27 @@ void ScriptEngine::PreInitialize() noexcept
 {
 	IScriptLoader &scriptLoader = GetScriptLoader();
 
-	scriptLoader.GetOnUnloadScript() += [this](ScriptID scriptID, std::string_view scriptName) -> void
+	_handlerIDUnloadScript = scriptLoader.GetOnUnloadScript() += [this](ScriptID scriptID, std::string_view scriptName) -> void
 	{
 		DeinitializeScript(scriptID, scriptName);
 	};
+
+	// Save all variables before any script gets unloaded, so that getters still observe consistent states.
+	_handlerIDPreHotReloadScripts = scriptLoader.GetOnPreHotReloadScripts() += [this](const std::vector<ScriptID> &scriptIDs) -> void
+	{
+		SavePersistVariables(scriptIDs);
+	};
 }
 
 void ScriptEngine::PostDeinitialize() noexcept
 {
+	IScriptLoader &scriptLoader = GetScriptLoader();
+
+	scriptLoader.GetOnUnloadScript() -= _handlerIDUnloadScript;
+	scriptLoader.GetOnPreHotReloadScripts() -= _handlerIDPreHotReloadScripts;
+
+	_handlerIDUnloadScript = 0;
+	_handlerIDPreHotReloadScripts = 0;
 }
 
 void ScriptEngine::Initialize() noexcept
@@ -227,7 +240,7 @@ void ScriptEngine::AssertLuaValue(sol::object value, std::string_view name) noex
 
 void ScriptEngine::Deinitialize() noexcept
 {
-	_persistVariables.clear();
+	ClearPersistVariables();
 	CollectGarbage();
 }
 
@@ -537,7 +550,8 @@ void ScriptEngine::InitializeScript(ScriptID scriptID, std::string_view scriptNa
 		return Log::Get(scriptName);
 	});
 
-	scriptGlobals.set_function("persist", [this, scriptName](sol::string_view key, sol::object defaultValue, sol::object getter)
+	PersistNameID scriptNameID = InternPersistName(scriptName);
+	scriptGlobals.set_function("persist", [this, scriptNameID](sol::string_view key, sol::object defaultValue, sol::object getter)
 	{
 		if (getter.is<sol::protected_function>())
 		{
@@ -546,14 +560,18 @@ void ScriptEngine::InitializeScript(ScriptID scriptID, std::string_view scriptNa
 				GetScriptEngine().ThrowError("Default value could not be nil");
 			}
 
-			return RegisterPersistVariable(scriptName, key, defaultValue, getter.as<sol::protected_function>());
+			return RegisterPersistVariable(scriptNameID, key, defaultValue, getter.as<sol::protected_function>());
 		}
 		else if (defaultValue.is<sol::protected_function>())
 		{
 			sol::protected_function getter_ = defaultValue.as<sol::protected_function>();
 			defaultValue = getter_();
 
-			return RegisterPersistVariable(scriptName, key, defaultValue, getter_);
+			return RegisterPersistVariable(scriptNameID, key, defaultValue, getter_);
+		}
+		else if (defaultValue.is<sol::table>())
+		{
+			return RegisterPersistVariable(scriptNameID, key, defaultValue, sol::protected_function());
 		}
 		else [[unlikely]]
 		{
@@ -609,44 +627,81 @@ void ScriptEngine::DeinitializeScript(ScriptID scriptID, std::string_view script
 	SaveScriptPersistVariables(scriptName);
 }
 
-void ScriptEngine::SaveScriptPersistVariables(std::string_view scriptName) noexcept
+ScriptEngine::PersistNameID ScriptEngine::InternPersistName(std::string_view name) noexcept
 {
-	auto it = _persistVariables.find(scriptName.data());
-	if (it == _persistVariables.end())
+	if (auto it = _persistNameIDs.find(name); it != _persistNameIDs.end()) [[likely]]
+	{
+		return it->second;
+	}
+
+	auto id = static_cast<PersistNameID>(_persistNames.size());
+	auto [it, _] = _persistNameIDs.emplace(std::string(name), id);
+	// Keys of node based map are stable.
+	_persistNames.emplace_back(it->first);
+	return id;
+}
+
+void ScriptEngine::SaveScriptPersistVariables(PersistNameID scriptNameID) noexcept
+{
+	auto it = _scriptPersistKeys.find(scriptNameID);
+	if (it == _scriptPersistKeys.end())
 	{
 		return;
 	}
 
-	for (auto &&[_, variable] : it->second)
+	PersistVariableKey high = PersistVariableKey(scriptNameID) << 32;
+	for (PersistNameID keyID : it->second)
 	{
-		variable.Save();
+		if (auto it1 = _persistVariables.find(high | keyID); it1 != _persistVariables.end()) [[likely]]
+		{
+			it1->second.Save();
+		}
+	}
+}
+
+void ScriptEngine::SaveScriptPersistVariables(std::string_view scriptName) noexcept
+{
+	if (auto it = _persistNameIDs.find(scriptName); it != _persistNameIDs.end())
+	{
+		SaveScriptPersistVariables(it->second);
 	}
 }
 
 void ScriptEngine::SavePersistVariables() noexcept
 {
-	for (auto &&[scriptName, variables] : _persistVariables)
+	for (auto &&[_, variable] : _persistVariables)
+	{
+		variable.Save();
+	}
+}
+
+void ScriptEngine::SavePersistVariables(const std::vector<ScriptID> &scriptIDs) noexcept
+{
+	IScriptProvider &scriptProvider = GetScriptProvider();
+	for (ScriptID scriptID : scriptIDs)
 	{
-		for (auto &&[key, variable] : variables)
+		if (auto scriptName = scriptProvider.GetScriptNameByID(scriptID); scriptName.has_value())
 		{
-			variable.Save();
+			SaveScriptPersistVariables(scriptName.value());
 		}
 	}
 }
 
 sol::object ScriptEngine::RegisterPersistVariable(std::string_view scriptName, std::string_view key, sol::object defaultValue, const sol::protected_function &getter)
 {
-	// if (defaultValue == sol::nil) [[unlikely]]
-	// {
-	// 	Warn("\"{}\" attempt to provide nil value to default persist variable '{}'", scriptName, key);
-	// }
+	return RegisterPersistVariable(InternPersistName(scriptName), key, defaultValue, getter);
+}
+
+sol::object ScriptEngine::RegisterPersistVariable(PersistNameID scriptNameID, std::string_view key, sol::object defaultValue, const sol::protected_function &getter)
+{
+	PersistNameID keyID = InternPersistName(key);
+	auto [it, inserted] = _persistVariables.try_emplace((PersistVariableKey(scriptNameID) << 32) | keyID);
+	PersistVariable &variable = it->second;
 
-	if (!_persistVariables.contains(scriptName.data()))
+	if (inserted)
 	{
-		_persistVariables[scriptName.data()] = {};
+		_scriptPersistKeys[scriptNameID].emplace_back(keyID);
 	}
-
-	PersistVariable &variable = _persistVariables[scriptName.data()][key.data()];
 	if (!variable.value.valid())
 	{
 		variable.value = defaultValue;
@@ -658,17 +713,27 @@ sol::object ScriptEngine::RegisterPersistVariable(std::string_view scriptName, s
 
 std::unordered_map<std::string_view, sol::object> ScriptEngine::GetScriptPersistVariables(std::string_view scriptName) noexcept
 {
-	auto it = _persistVariables.find(scriptName.data());
-	if (it == _persistVariables.end())
+	auto it = _persistNameIDs.find(scriptName);
+	if (it == _persistNameIDs.end())
+	{
+		return {};
+	}
+
+	auto it1 = _scriptPersistKeys.find(it->second);
+	if (it1 == _scriptPersistKeys.end())
 	{
 		return {};
 	}
 
 	std::unordered_map<std::string_view, sol::object> variables{};
 
-	for (const auto &[key, variable] : it->second)
+	PersistVariableKey high = PersistVariableKey(it->second) << 32;
+	for (PersistNameID keyID : it1->second)
 	{
-		variables.emplace(key, variable.value);
+		if (auto it2 = _persistVariables.find(high | keyID); it2 != _persistVariables.end())
+		{
+			variables.emplace(_persistNames[keyID], it2->second.value);
+		}
 	}
 
 	return variables;
@@ -676,10 +741,30 @@ std::unordered_map<std::string_view, sol::object> ScriptEngine::GetScriptPersist
 
 bool ScriptEngine::ClearScriptPersistVariables(std::string_view scriptName) noexcept
 {
-	return _persistVariables.erase(scriptName.data());
+	auto it = _persistNameIDs.find(scriptName);
+	if (it == _persistNameIDs.end())
+	{
+		return false;
+	}
+
+	auto it1 = _scriptPersistKeys.find(it->second);
+	if (it1 == _scriptPersistKeys.end())
+	{
+		return false;
+	}
+
+	PersistVariableKey high = PersistVariableKey(it->second) << 32;
+	for (PersistNameID keyID : it1->second)
+	{
+		_persistVariables.erase(high | keyID);
+	}
+	_scriptPersistKeys.erase(it1);
+
+	return true;
 }
 
 void ScriptEngine::ClearPersistVariables() noexcept
 {
 	_persistVariables.clear();
+	_scriptPersistKeys.clear();
 }
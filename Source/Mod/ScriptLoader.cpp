@@ -34,6 +34,7 @@
 #include <sol/forward.hpp>
 #include <sol/types.hpp>
 
+#include <algorithm>
 #include <corecrt_terminate.h>
 #include <format>
 #include <memory>
@@ -57,9 +58,12 @@ ScriptLoader::ScriptLoader(Context &context) noexcept
       _onUnloadScript(),
       _onFailedLoadScript(),
       _scriptReversedDependencies(),
+      _scriptDependencies(),
       _flags(),
       _parseErrorScripts(),
-      _scriptProviderVersion()
+      _scriptProviderVersion(),
+      _dirtyVisited(),
+      _dirtyStack()
 {
 }
 
@@ -206,31 +210,59 @@ std::optional<std::string_view> ScriptLoader::GetLoadingScriptName() const noexc
 	return GetScriptProvider().GetScriptNameByID(_loadingScript);
 }
 
-void GetScriptDependenciesImpl(const std::unordered_map<ScriptID, std::set<ScriptID>> &scriptDependencies, ScriptID scriptID, std::vector<ScriptID> &sources, std::unordered_set<ScriptID> &visited)
+std::vector<ScriptID> ScriptLoader::GetScriptDependencies(ScriptID scriptID) const
 {
-	if (visited.contains(scriptID))
-	{
-		return;
-	}
-	visited.emplace(scriptID);
+	std::vector<ScriptID> sources = CollectDirtyScripts({scriptID});
+	// The root script always comes first in a topological order.
+	sources.erase(sources.begin());
+	return sources;
+}
+
+std::vector<ScriptID> ScriptLoader::CollectDirtyScripts(const std::vector<ScriptID> &scriptIDs) const
+{
+	std::vector<ScriptID> dirtyScripts{};
 
-	auto it = scriptDependencies.find(scriptID);
-	if (it != scriptDependencies.end())
+	_dirtyVisited.clear();
+	_dirtyStack.clear();
+
+	// Iterative post-order DFS along target -> sources edges, reversed afterwards.
+	for (ScriptID root : scriptIDs)
 	{
-		for (auto &&source : it->second)
+		if (!_dirtyVisited.emplace(root).second)
+		{
+			continue;
+		}
+
+		_dirtyStack.emplace_back(root, false);
+		while (!_dirtyStack.empty())
 		{
-			sources.emplace_back(source);
-			GetScriptDependenciesImpl(scriptDependencies, source, sources, visited);
+			auto [scriptID, expanded] = _dirtyStack.back();
+			if (expanded)
+			{
+				dirtyScripts.emplace_back(scriptID);
+				_dirtyStack.pop_back();
+				continue;
+			}
+
+			std::get<1>(_dirtyStack.back()) = true;
+
+			auto it = _scriptReversedDependencies.find(scriptID);
+			if (it != _scriptReversedDependencies.end())
+			{
+				for (ScriptID source : it->second)
+				{
+					if (_dirtyVisited.emplace(source).second)
+					{
+						_dirtyStack.emplace_back(source, false);
+					}
+				}
+			}
 		}
 	}
-}
 
-std::vector<ScriptID> ScriptLoader::GetScriptDependencies(ScriptID scriptID) const
-{
-	std::vector<ScriptID> sources{};
-	std::unordered_set<ScriptID> visited{};
-	GetScriptDependenciesImpl(_scriptReversedDependencies, scriptID, sources, visited);
-	return sources;
+	std::reverse(dirtyScripts.begin(), dirtyScripts.end());
+
+	return dirtyScripts;
 }
 
 void ScriptLoader::AddReverseDependency(ScriptID source, ScriptID target)
@@ -260,8 +292,8 @@ void ScriptLoader::AddReverseDependency(ScriptID source, ScriptID target)
 		    target, targetName.has_value() ? targetName->data() : "#INVALID#"));
 	}
 
-	auto &&dependencies = _scriptReversedDependencies[target];
-	dependencies.insert(source);
+	_scriptReversedDependencies[target].insert(source);
+	_scriptDependencies[source].insert(target);
 
 	TE_TRACE("Link scripts to reverse dependency map: <{}>{} <- <{}>{}",
 	         source, scriptProvider.GetScriptNameByID(source)->data(),
@@ -439,7 +471,17 @@ void ScriptLoader::UnloadAllScripts()
 std::vector<ScriptID> ScriptLoader::UnloadScript(ScriptID scriptID)
 {
 	std::vector<ScriptID> unloadedScripts{};
-	UnloadImpl(scriptID, &unloadedScripts);
+
+	if (!_scriptModules.contains(scriptID))
+	{
+		TE_TRACE("Script <{}> has already unloaded", scriptID);
+
+		return unloadedScripts;
+	}
+
+	UnloadDirtyScripts(CollectDirtyScripts({scriptID}), &unloadedScripts);
+	std::erase(unloadedScripts, scriptID);
+
 	return unloadedScripts;
 }
 
@@ -456,10 +498,8 @@ std::vector<ScriptID> ScriptLoader::UnloadScriptsBy(std::string_view modUID)
 			unloadingScripts.emplace_back(scriptID);
 		}
 	}
-	for (auto scriptID : unloadingScripts)
-	{
-		UnloadImpl(scriptID, &unloadedScripts);
-	}
+
+	UnloadDirtyScripts(CollectDirtyScripts(unloadingScripts), &unloadedScripts);
 
 	return std::move(unloadedScripts);
 }
@@ -472,13 +512,25 @@ std::vector<ScriptID> ScriptLoader::UnloadInvalidScripts()
 	// return std::move(unloadedScripts);
 }
 
-void ScriptLoader::UnloadImpl(ScriptID scriptID, std::vector<ScriptID> *unloadedScripts)
+void ScriptLoader::UnloadDirtyScripts(const std::vector<ScriptID> &dirtyScripts, std::vector<ScriptID> *unloadedScripts)
+{
+	// Unload dependents before the scripts they depend on.
+	for (auto it = dirtyScripts.rbegin(); it != dirtyScripts.rend(); ++it)
+	{
+		if (UnloadImpl(*it) && unloadedScripts != nullptr)
+		{
+			unloadedScripts->emplace_back(*it);
+		}
+	}
+}
+
+bool ScriptLoader::UnloadImpl(ScriptID scriptID)
 {
 	if (!_scriptModules.contains(scriptID))
 	{
 		TE_TRACE("Script <{}> has already unloaded", scriptID);
 
-		return;
+		return false;
 	}
 
 	auto optScriptName = GetScriptProvider().GetScriptNameByID(scriptID);
@@ -486,7 +538,7 @@ void ScriptLoader::UnloadImpl(ScriptID scriptID, std::vector<ScriptID> *unloaded
 	{
 		TE_WARN("Attempt to unload invalid script <{}> ...", scriptID);
 
-		return;
+		return false;
 	}
 	std::string_view scriptName = optScriptName.value();
 
@@ -505,58 +557,73 @@ void ScriptLoader::UnloadImpl(ScriptID scriptID, std::vector<ScriptID> *unloaded
 
 	TE_ASSERT(_scriptModules.erase(scriptID));
 
-	if (unloadedScripts != nullptr)
+	// Script will link its dependencies again by `require` after reloaded.
+	if (auto it = _scriptDependencies.find(scriptID); it != _scriptDependencies.end())
 	{
-		for (ScriptID dependency : GetScriptDependencies(scriptID))
+		for (ScriptID target : it->second)
 		{
-			UnloadScript(dependency);
-			unloadedScripts->emplace_back(dependency);
+			if (auto it1 = _scriptReversedDependencies.find(target); it1 != _scriptReversedDependencies.end())
+			{
+				it1->second.erase(scriptID);
+				if (it1->second.empty())
+				{
+					_scriptReversedDependencies.erase(it1);
+				}
+			}
 		}
+		_scriptDependencies.erase(it);
 	}
-
-	_scriptReversedDependencies.erase(scriptID);
-	for (auto &&[_, dependencies] : _scriptReversedDependencies)
+	if (auto it = _scriptReversedDependencies.find(scriptID); it != _scriptReversedDependencies.end())
 	{
-		dependencies.erase(scriptID);
+		for (ScriptID source : it->second)
+		{
+			if (auto it1 = _scriptDependencies.find(source); it1 != _scriptDependencies.end())
+			{
+				it1->second.erase(scriptID);
+			}
+		}
+		_scriptReversedDependencies.erase(it);
 	}
 
 	TE_TRACE("{}", "Unloaded");
+
+	return true;
 }
 
 void ScriptLoader::HotReloadScripts(const std::vector<ScriptID> &scriptIDs)
 {
 	TE_DEBUG("{}", "Hot reloading scripts ...");
 
+	std::vector<ScriptID> dirtyScripts = CollectDirtyScripts(scriptIDs);
+
 	GetEngine().SetLoadingInfo(Engine::LoadingInfoArgs{
 	    .title = "Loading scripts",
 	    .description = "",
 	    .progressValue = 0.0f,
-	    .progressTotal = std::float_t(scriptIDs.size()),
+	    .progressTotal = std::float_t(dirtyScripts.size()),
 	});
 
 	if (_log->CanTrace())
 	{
 		IScriptProvider &scriptProvider = GetScriptProvider();
-		for (auto scriptID : scriptIDs)
+		for (auto scriptID : dirtyScripts)
 		{
 			auto optScriptName = scriptProvider.GetScriptNameByID(scriptID);
 			_log->Trace("<{}>{}", scriptID, optScriptName.has_value() ? optScriptName->data() : "#INVALID#");
 		}
 	}
 
-	_onPreHotReloadScripts(scriptIDs);
+	_onPreHotReloadScripts(dirtyScripts);
 
-	for (auto scriptID : scriptIDs)
+	UnloadDirtyScripts(dirtyScripts, nullptr);
+
+	for (auto scriptID : dirtyScripts)
 	{
-		if (IsScriptFullyLoaded(scriptID))
-		{
-			UnloadScript(scriptID);
-		}
 		Load(scriptID);
 	}
 	ProcessFullLoads();
 
-	_onPostHotReloadScripts(scriptIDs);
+	_onPostHotReloadScripts(dirtyScripts);
 
 	PostLoadScripts();
 
@@ -0,0 +1,508 @@
+/**
+ * @file Mod/ScriptWorkers.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Mod/ScriptWorkers.hpp"
+#include "Mod/LuaBindings.hpp"
+
+#include "Mod/ScriptEngine.hpp"
+#include "Mod/ScriptProvider.hpp"
+#include "Misc/Text.hpp"
+#include "System/LogMicros.hpp"
+#include "Util/Utils.hpp"
+#include "sol/state.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <format>
+#include <system_error>
+
+using namespace tudov;
+
+/**
+ * Static modules that do not touch engine objects nor `ScriptEngine`, thus can be required inside of worker states.
+ */
+static constexpr std::array<std::string_view, 11> workerModules = {
+    "TE.AStarSearch",
+    "TE.Color",
+    "TE.EnumFlag",
+    "TE.FMath",
+    "TE.Format",
+    "TE.Function",
+    "TE.Geometry",
+    "TE.LRUCache",
+    "TE.Math",
+    "TE.Matrix3x3",
+    "TE.String",
+};
+
+static constexpr std::uint32_t maxWorkers = 4;
+
+static int DumpWriter(lua_State *, const void *data, std::size_t size, void *userdata) noexcept
+{
+	static_cast<std::string *>(userdata)->append(static_cast<const char *>(data), size);
+	return 0;
+}
+
+ScriptWorkers::ScriptWorkers(Context &context) noexcept
+    : _context(context),
+      _log(Log::Get("ScriptWorkers")),
+      _latestJobID(0),
+      _pendingJobs(0),
+      _stopping(false)
+{
+}
+
+ScriptWorkers::~ScriptWorkers() noexcept
+{
+	StopWorkers();
+}
+
+Context &ScriptWorkers::GetContext() noexcept
+{
+	return _context;
+}
+
+Log &ScriptWorkers::GetLog() noexcept
+{
+	return *_log;
+}
+
+void ScriptWorkers::Deinitialize() noexcept
+{
+	StopWorkers();
+
+	_moduleSources.clear();
+	_globalNames.clear();
+	_callbacks.clear();
+	_pendingJobs = 0;
+	_encode = sol::lua_nil;
+	_decode = sol::lua_nil;
+}
+
+void ScriptWorkers::ProcessTick() noexcept
+{
+	if (_pendingJobs == 0) [[likely]]
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_resultsMutex};
+		std::swap(_results, _dispatchingResults);
+	}
+
+	for (JobResult &result : _dispatchingResults)
+	{
+		--_pendingJobs;
+
+		auto it = _callbacks.find(result.id);
+		if (it == _callbacks.end())
+		{
+			continue;
+		}
+
+		sol::protected_function callback = std::move(it->second);
+		_callbacks.erase(it);
+
+		sol::protected_function_result ret;
+		if (result.success)
+		{
+			sol::protected_function_result decoded = _decode(std::string_view(result.data));
+			if (decoded.valid()) [[likely]]
+			{
+				ret = callback(decoded.get<sol::object>());
+			}
+			else [[unlikely]]
+			{
+				sol::error err = decoded;
+				ret = callback(sol::lua_nil, err.what());
+			}
+		}
+		else
+		{
+			ret = callback(sol::lua_nil, result.data);
+		}
+
+		if (!ret.valid()) [[unlikely]]
+		{
+			sol::error err = ret;
+			TE_ERROR("Error in callback of job <{}>: {}", result.id, err.what());
+		}
+	}
+
+	_dispatchingResults.clear();
+}
+
+ScriptWorkerJobID ScriptWorkers::Submit(std::string bytecode, std::string encodedArgs, sol::protected_function callback) noexcept
+{
+	if (_threads.empty() && !StartWorkers()) [[unlikely]]
+	{
+		return 0;
+	}
+
+	ScriptWorkerJobID jobID = ++_latestJobID;
+
+	if (callback.valid())
+	{
+		if (!_decode.valid()) [[unlikely]]
+		{
+			BindStringBuffer(callback.lua_state());
+		}
+		_callbacks.try_emplace(jobID, std::move(callback));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_jobsMutex};
+		_jobs.emplace_back(Job{
+		    .id = jobID,
+		    .bytecode = std::move(bytecode),
+		    .encodedArgs = std::move(encodedArgs),
+		});
+	}
+	_jobsCV.notify_one();
+
+	++_pendingJobs;
+	return jobID;
+}
+
+bool ScriptWorkers::Cancel(ScriptWorkerJobID jobID) noexcept
+{
+	bool cancelled = _callbacks.erase(jobID) > 0;
+
+	std::lock_guard<std::mutex> lock{_jobsMutex};
+	auto it = std::find_if(_jobs.begin(), _jobs.end(), [jobID](const Job &job) -> bool
+	{
+		return job.id == jobID;
+	});
+	if (it != _jobs.end())
+	{
+		_jobs.erase(it);
+		--_pendingJobs;
+		cancelled = true;
+	}
+
+	return cancelled;
+}
+
+std::size_t ScriptWorkers::GetPendingJobs() const noexcept
+{
+	return _pendingJobs;
+}
+
+std::size_t ScriptWorkers::GetWorkerCount() const noexcept
+{
+	return _threads.size();
+}
+
+void ScriptWorkers::BindStringBuffer(lua_State *L) noexcept
+{
+	sol::state_view lua{L};
+	sol::table buffer = lua.registry()["_LOADED"]["string.buffer"];
+	_encode = buffer["encode"];
+	_decode = buffer["decode"];
+}
+
+bool ScriptWorkers::StartWorkers() noexcept
+{
+	IScriptProvider &scriptProvider = GetScriptProvider();
+	for (std::string_view moduleName : workerModules)
+	{
+		std::shared_ptr<Text> code = scriptProvider.GetScriptCode(std::format("#{}", moduleName));
+		if (code != nullptr) [[likely]]
+		{
+			_moduleSources.try_emplace(std::string(moduleName), code->View());
+		}
+		else [[unlikely]]
+		{
+			TE_WARN("Static module \"{}\" not found, it will not be available in workers", moduleName);
+		}
+	}
+
+	for (std::string_view name : GetLuaBindings().GetModGlobalsMigration())
+	{
+		_globalNames.emplace(name);
+	}
+
+	std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+	std::uint32_t count = std::clamp<std::uint32_t>(hardwareThreads > 1 ? hardwareThreads - 1 : 1, 1, maxWorkers);
+
+	_stopping = false;
+	_threads.reserve(count);
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		try
+		{
+			_threads.emplace_back(&ScriptWorkers::WorkerMain, this, i);
+		}
+		catch (const std::system_error &e)
+		{
+			// Run with workers started so far, if any.
+			TE_ERROR("Failed to start script worker #{}: {}", i, e.what());
+			break;
+		}
+	}
+
+	if (_threads.empty()) [[unlikely]]
+	{
+		return false;
+	}
+
+	TE_DEBUG("Started {} script workers", _threads.size());
+	return true;
+}
+
+void ScriptWorkers::StopWorkers() noexcept
+{
+	if (_threads.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_jobsMutex};
+		_stopping = true;
+		_jobs.clear();
+	}
+	_jobsCV.notify_all();
+
+	for (std::thread &thread : _threads)
+	{
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+	}
+	_threads.clear();
+
+	std::lock_guard<std::mutex> lock{_resultsMutex};
+	_results.clear();
+}
+
+void ScriptWorkers::InstallWorkerState(sol::state &lua) noexcept
+{
+	// No `ffi`, `io`, `os` nor `debug`, jobs only see pure computational libraries, further narrowed down below.
+	lua.open_libraries(sol::lib::base);
+	lua.open_libraries(sol::lib::bit32);
+	lua.open_libraries(sol::lib::jit);
+	lua.open_libraries(sol::lib::math);
+	lua.open_libraries(sol::lib::package);
+	lua.open_libraries(sol::lib::string);
+	lua.open_libraries(sol::lib::table);
+
+	sol::table package = lua["package"];
+	sol::table preload = package["preload"];
+
+	for (auto &&[moduleName, source] : _moduleSources)
+	{
+		sol::load_result loaded = lua.load(source, std::format("#{}", moduleName), sol::load_mode::any);
+		if (loaded.valid()) [[likely]]
+		{
+			preload[moduleName] = loaded.get<sol::function>();
+		}
+		else [[unlikely]]
+		{
+			sol::error err = loaded;
+			TE_WARN("Failed to load static module \"{}\" in worker: {}", moduleName, err.what());
+		}
+	}
+
+	// Only keep the preload searcher, so that `require` can never reach the file system.
+	sol::table loaders = package["loaders"];
+	package["loaders"] = lua.create_table_with(1, loaders.get<sol::function>(1));
+	package["loadlib"] = sol::lua_nil;
+	package["path"] = "";
+	package["cpath"] = "";
+
+	auto isAllowed = [this](const sol::object &key) -> bool
+	{
+		if (key.get_type() != sol::type::string)
+		{
+			return false;
+		}
+		std::string name = key.as<std::string>();
+		return name == "_G" || name == "require" || _globalNames.contains(name) || _moduleSources.contains(name);
+	};
+
+	auto prune = [&isAllowed](sol::table table)
+	{
+		std::vector<sol::object> keys;
+		for (auto &&[key, value] : table)
+		{
+			if (!isAllowed(key))
+			{
+				keys.emplace_back(key);
+			}
+		}
+		for (const sol::object &key : keys)
+		{
+			table[key] = sol::lua_nil;
+		}
+	};
+
+	// Same globals as mod environments, so no `load`, `loadstring`, `getfenv`, `setfenv`, `collectgarbage` nor `jit`. Loaded
+	// and preloaded libraries are pruned as well, otherwise `require` would hand out `jit`, `jit.util` or `jit.profile`.
+	prune(preload);
+	prune(lua.registry()["_LOADED"]);
+	prune(lua.globals());
+}
+
+void ScriptWorkers::WorkerMain(std::size_t index) noexcept
+{
+	sol::state lua;
+	InstallWorkerState(lua);
+
+	sol::table buffer = lua["require"]("string.buffer");
+	sol::protected_function encode = buffer["encode"];
+	sol::protected_function decode = buffer["decode"];
+
+	TE_TRACE("Script worker #{} is ready", index);
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock{_jobsMutex};
+			_jobsCV.wait(lock, [this]() -> bool
+			{
+				return _stopping || !_jobs.empty();
+			});
+			if (_stopping)
+			{
+				break;
+			}
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		JobResult result{
+		    .id = job.id,
+		    .success = false,
+		    .data = {},
+		};
+
+		try
+		{
+			sol::load_result loaded = lua.load(std::string_view(job.bytecode), "=job", sol::load_mode::binary);
+			if (!loaded.valid()) [[unlikely]]
+			{
+				sol::error err = loaded;
+				result.data = err.what();
+			}
+			else
+			{
+				sol::object args = sol::lua_nil;
+				if (!job.encodedArgs.empty())
+				{
+					sol::protected_function_result decoded = decode(std::string_view(job.encodedArgs));
+					if (decoded.valid()) [[likely]]
+					{
+						args = decoded.get<sol::object>();
+					}
+				}
+
+				sol::protected_function func = loaded.get<sol::protected_function>();
+				sol::protected_function_result ret = func(args);
+				if (!ret.valid())
+				{
+					sol::error err = ret;
+					result.data = err.what();
+				}
+				else
+				{
+					sol::object value = ret.return_count() > 0 ? ret.get<sol::object>() : sol::make_object(lua, sol::lua_nil);
+					sol::protected_function_result encoded = encode(value);
+					if (encoded.valid()) [[likely]]
+					{
+						result.success = true;
+						result.data = encoded.get<std::string>();
+					}
+					else [[unlikely]]
+					{
+						sol::error err = encoded;
+						result.data = err.what();
+					}
+				}
+			}
+		}
+		catch (std::exception &e)
+		{
+			result.data = std::format("C++ exception: {}", e.what());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{_resultsMutex};
+			_results.emplace_back(std::move(result));
+		}
+	}
+
+	TE_TRACE("Script worker #{} stopped", index);
+}
+
+ScriptWorkerJobID ScriptWorkers::LuaSubmit(sol::object func, sol::object args, sol::object callback) noexcept
+{
+	if (!func.is<sol::function>()) [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Bad argument to #1 'func': function expected, got {}", GetLuaTypeStringView(func.get_type()));
+	}
+	if (!callback.is<sol::function>() && !callback.is<sol::nil_t>()) [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Bad argument to #3 'callback': function or nil expected, got {}", GetLuaTypeStringView(callback.get_type()));
+	}
+
+	lua_State *L = func.lua_state();
+
+	lua_Debug debug;
+	func.push(L);
+	lua_getinfo(L, ">Su", &debug);
+	if (std::string_view(debug.what) == "C") [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Bad argument to #1 'func': lua function expected, got C function");
+	}
+	if (debug.nups != 0) [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Bad argument to #1 'func': job function must not have upvalues, got {}", debug.nups);
+	}
+
+	if (!_encode.valid()) [[unlikely]]
+	{
+		BindStringBuffer(L);
+	}
+
+	std::string bytecode;
+	func.push(L);
+	lua_dump(L, DumpWriter, &bytecode);
+	lua_pop(L, 1);
+
+	std::string encodedArgs;
+	if (!args.is<sol::nil_t>())
+	{
+		sol::protected_function_result encoded = _encode(args);
+		if (!encoded.valid()) [[unlikely]]
+		{
+			sol::error err = encoded;
+			GetScriptEngine().ThrowError("Bad argument to #2 'args': {}", err.what());
+		}
+		encodedArgs = encoded.get<std::string>();
+	}
+
+	ScriptWorkerJobID jobID = Submit(std::move(bytecode), std::move(encodedArgs), callback.is<sol::function>() ? callback.as<sol::protected_function>() : sol::protected_function());
+	if (jobID == 0) [[unlikely]]
+	{
+		GetScriptEngine().ThrowError("Failed to start script workers");
+	}
+	return jobID;
+}
+
+bool ScriptWorkers::LuaCancel(sol::object jobID) noexcept
+{
+	return jobID.is<std::double_t>() && Cancel(static_cast<ScriptWorkerJobID>(jobID.as<std::double_t>()));
+}
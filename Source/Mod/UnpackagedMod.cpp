@@ -26,10 +26,10 @@
 #include "Util/FileSystemWatch.hpp"
 #include "Util/StringUtils.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <memory>
-#include <regex>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
@@ -38,13 +38,21 @@
 using namespace tudov;
 
 const std::filesystem::path &modConfigFile = "Mod.json";
+// Editors and git write files in bursts, wait until they are done.
+static constexpr std::chrono::milliseconds fileChangeWindow{150};
 
 UnpackagedMod::UnpackagedMod(ModManager &modManager, const std::filesystem::path &directory)
     : Mod(modManager, LoadConfig(directory)),
       _log(Log::Get("UnpackagedMod")),
       _loaded(false),
+      _fileChangeJournal(fileChangeWindow, [this]()
+      {
+	      GetEngine().TriggerLoadPending();
+      }),
+      _fileWatcher(nullptr),
       _directory(directory),
-      _fileWatcher(nullptr)
+      _preparedFiles(),
+      _prepared(false)
 {
 }
 
@@ -69,39 +77,45 @@ std::filesystem::path UnpackagedMod::GetDirectory() noexcept
 
 void UnpackagedMod::UpdateFileMatchPatterns()
 {
-	_scriptFilePatterns = std::vector<std::regex>(_config.scripts.files.size());
+	_scriptFilePatterns.clear();
+	_scriptFilePatterns.reserve(_config.scripts.files.size());
 	for (auto &&pattern : _config.scripts.files)
 	{
-		_scriptFilePatterns.emplace_back(std::regex(std::string(pattern), std::regex_constants::icase));
+		_scriptFilePatterns.emplace_back(pattern);
 	}
 
-	_fontFilePatterns = std::vector<std::regex>(_config.fonts.files.size());
+	_fontFilePatterns.clear();
+	_fontFilePatterns.reserve(_config.fonts.files.size());
 	for (auto &&pattern : _config.fonts.files)
 	{
-		_fontFilePatterns.emplace_back(std::regex(std::string(pattern), std::regex_constants::icase));
+		_fontFilePatterns.emplace_back(pattern);
 	}
-}
 
-inline bool RegexPatternMatch(std::string_view file, const std::vector<std::regex> &patterns) noexcept
-{
-	for (auto &&pattern : patterns)
+	_scriptsDirectory = (_directory / _config.scripts.directory).lexically_normal().generic_string();
+	if (!_scriptsDirectory.ends_with('/'))
 	{
-		if (std::regex_match(file.data(), pattern))
-		{
-			return true;
-		}
+		_scriptsDirectory.push_back('/');
 	}
-	return false;
 }
 
 bool UnpackagedMod::IsScript(std::string_view file) const
 {
-	return RegexPatternMatch(file, _scriptFilePatterns) && StringUtils::IsSubpath(_directory / _config.scripts.directory, file);
+	if (!FilePattern::MatchAny(file, _scriptFilePatterns))
+	{
+		return false;
+	}
+
+	// Paths here are built from mod directory and usually normal already.
+	if (file.starts_with(_scriptsDirectory)) [[likely]]
+	{
+		return true;
+	}
+	return std::filesystem::path(file).lexically_normal().generic_string().starts_with(_scriptsDirectory);
 }
 
 bool UnpackagedMod::IsFont(std::string_view file) const
 {
-	return RegexPatternMatch(file, _fontFilePatterns);
+	return FilePattern::MatchAny(file, _fontFilePatterns);
 }
 
 bool UnpackagedMod::IsValidDirectory(const std::filesystem::path &directory)
@@ -111,13 +125,17 @@ bool UnpackagedMod::IsValidDirectory(const std::filesystem::path &directory)
 
 void UnpackagedMod::Update()
 {
-	std::lock_guard lock{_fileWatchMutex};
-
-	while (!_fileWatchQueue.empty()) [[unlikely]]
+	std::vector<FileChangeJournal::Change> changes = _fileChangeJournal.TakeSettled();
+	if (changes.empty()) [[likely]]
 	{
-		auto [path, type, change] = _fileWatchQueue.front();
-		_fileWatchQueue.pop();
+		return;
+	}
+
+	TE_DEBUG("Processing {} file changes of \"{}\"", changes.size(), _directory.generic_string());
 
+	// Scripts changed here are collected by mod manager and hot reloaded together after all mods are updated.
+	for (const auto &[path, type, change] : changes)
+	{
 		std::string file = (_directory / path).generic_string();
 		switch (change)
 		{
@@ -144,26 +162,8 @@ void UnpackagedMod::Update()
 			}
 			break;
 		}
+		// Removed paths do not exist anymore, their path type is unknown.
 		case EFileChangeType::Removed:
-		{
-			if (type == EPathType::File && IsScript(file))
-			{
-				ScriptRemoved(file);
-			}
-			else
-			{
-				switch (type)
-				{
-				case EPathType::File:
-					FileRemoved(file);
-					break;
-				case EPathType::Directory:
-					break;
-				default:
-					break;
-				}
-			}
-		}
 		case EFileChangeType::RenamedOld:
 		{
 			if (IsScript(file))
@@ -243,11 +243,7 @@ void UnpackagedMod::Load()
 	{
 		if (_loaded)
 		{
-			std::lock_guard lock{_fileWatchMutex};
-
-			_fileWatchQueue.push(std::make_tuple(filePath, pathType, changeType));
-
-			GetEngine().TriggerLoadPending();
+			_fileChangeJournal.Record(filePath, pathType, changeType);
 		}
 	};
 	_fileWatcher->StartWatching();
@@ -263,34 +259,103 @@ void UnpackagedMod::Load()
 
 	TE_DEBUG("Loading unpacked mod from \"{}\" ...", dir);
 
-	UpdateFileMatchPatterns();
-
-	ModConfig &config = GetConfig();
-
-	for (const auto &entry : std::filesystem::recursive_directory_iterator(_directory))
+	if (!_prepared)
 	{
-		if (!entry.is_regular_file())
+		for (const std::function<void()> &job : Prepare())
 		{
-			continue;
+			job();
 		}
+	}
 
-		auto &&file = entry.path().generic_string();
-		if (IsScript(file))
+	for (PreparedFile &preparedFile : _preparedFiles)
+	{
+		if (!preparedFile.error.empty()) [[unlikely]]
+		{
+			TE_ERROR("Failed to read mod file \"{}\": {}", preparedFile.path.generic_string(), preparedFile.error);
+		}
+		else if (preparedFile.script)
 		{
-			ScriptAdded(file);
+			ScriptAdded(preparedFile.path, std::move(preparedFile.bytes));
 		}
 		else
 		{
-			FileAdded(file);
+			FileAdded(preparedFile.path, std::move(preparedFile.bytes));
 		}
 	}
+	std::vector<PreparedFile>().swap(_preparedFiles);
+	_prepared = false;
 
 	TE_DEBUG("Loaded unpacked mod from \"{}\"", dir);
 
 	_loaded = true;
 }
 
+std::vector<std::function<void()>> UnpackagedMod::Prepare()
+{
+	UpdateFileMatchPatterns();
+
+	_preparedFiles.clear();
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(_directory))
+	{
+		if (!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		std::string file = entry.path().generic_string();
+		bool script = IsScript(file);
+		_preparedFiles.emplace_back(PreparedFile{
+		    .path = std::move(file),
+		    .script = script,
+		    .bytes = {},
+		    .error = {},
+		});
+	}
+	_prepared = true;
+
+	// Not resized from here on, jobs fill their own elements.
+	std::vector<std::function<void()>> jobs;
+	jobs.reserve(_preparedFiles.size());
+	for (PreparedFile &preparedFile : _preparedFiles)
+	{
+		jobs.emplace_back([&preparedFile]()
+		{
+			// Runs on a worker thread, the error is logged by `Load`.
+			try
+			{
+				preparedFile.bytes = ReadFileToBytes(preparedFile.path.generic_string(), true);
+			}
+			catch (const std::exception &e)
+			{
+				preparedFile.error = e.what();
+			}
+		});
+	}
+	return jobs;
+}
+
+std::optional<std::vector<std::byte>> UnpackagedMod::ReadModFile(const std::filesystem::path &file) noexcept
+{
+	try
+	{
+		return ReadFileToBytes(file.generic_string(), true);
+	}
+	catch (const std::exception &e)
+	{
+		TE_ERROR("Failed to read mod file \"{}\": {}", file.generic_string(), e.what());
+		return std::nullopt;
+	}
+}
+
 void UnpackagedMod::ScriptAdded(const std::filesystem::path &file) noexcept
+{
+	if (std::optional<std::vector<std::byte>> scriptCode = ReadModFile(file); scriptCode.has_value()) [[likely]]
+	{
+		ScriptAdded(file, std::move(*scriptCode));
+	}
+}
+
+void UnpackagedMod::ScriptAdded(const std::filesystem::path &file, std::vector<std::byte> &&scriptCode) noexcept
 {
 	std::filesystem::path &&relative = std::filesystem::relative(file, _directory);
 	relative = std::filesystem::relative(relative, _config.scripts.directory);
@@ -298,9 +363,8 @@ void UnpackagedMod::ScriptAdded(const std::filesystem::path &file) noexcept
 	std::string filePathStr = file.generic_string();
 	std::string relativePath = relative.generic_string();
 	std::string scriptName = FilePathToLuaScriptName(std::format("{}.{}", _config.namespace_, relativePath));
-	std::vector<std::byte> scriptCode = ReadFileToBytes(filePathStr, true);
 
-	GetVirtualFileSystem().MountFile(file, scriptCode);
+	GetVirtualFileSystem().MountFile(file, std::move(scriptCode));
 
 	TextResources &textResources = GetGlobalResourcesCollection().GetTextResources();
 	TextID scriptTextID = textResources.GetResourceID(filePathStr);
@@ -314,7 +378,15 @@ void UnpackagedMod::ScriptAdded(const std::filesystem::path &file) noexcept
 
 void UnpackagedMod::FileAdded(const std::filesystem::path &file) noexcept
 {
-	GetVirtualFileSystem().MountFile(file, ReadFileToBytes(file.generic_string(), true));
+	if (std::optional<std::vector<std::byte>> bytes = ReadModFile(file); bytes.has_value()) [[likely]]
+	{
+		FileAdded(file, std::move(*bytes));
+	}
+}
+
+void UnpackagedMod::FileAdded(const std::filesystem::path &file, std::vector<std::byte> &&bytes) noexcept
+{
+	GetVirtualFileSystem().MountFile(file, std::move(bytes));
 }
 
 bool UnpackagedMod::ScriptRemoved(const std::filesystem::path &file) noexcept
@@ -347,9 +419,8 @@ bool UnpackagedMod::ScriptModified(const std::filesystem::path &file) noexcept
 		return false;
 	}
 
-	std::vector<std::byte> scriptCode = ReadFileToBytes(filePathStr, true);
-
-	if (!GetVirtualFileSystem().RemountFile(file, scriptCode))
+	std::optional<std::vector<std::byte>> scriptCode = ReadModFile(file);
+	if (!scriptCode.has_value() || !GetVirtualFileSystem().RemountFile(file, *scriptCode))
 	{
 		return false;
 	}
@@ -378,7 +449,10 @@ bool UnpackagedMod::ScriptModified(const std::filesystem::path &file) noexcept
 
 void UnpackagedMod::FileModified(const std::filesystem::path &file) noexcept
 {
-	GetVirtualFileSystem().RemountFile(file, ReadFileToBytes(file.generic_string(), true));
+	if (std::optional<std::vector<std::byte>> bytes = ReadModFile(file); bytes.has_value()) [[likely]]
+	{
+		GetVirtualFileSystem().RemountFile(file, *bytes);
+	}
 }
 
 void UnpackagedMod::Unload()
@@ -393,6 +467,8 @@ void UnpackagedMod::Unload()
 
 	TE_DEBUG("Unloading unpackaged mod from \"{}\"", dir);
 
+	_fileChangeJournal.Clear();
+
 	{
 		auto &modUID = Mod::GetConfig().uid;
 		GetScriptLoader().UnloadScriptsBy(modUID);
@@ -89,6 +89,11 @@ IScriptProvider &Context::GetScriptProvider()
 	return *GetEngine()._data->_scriptProvider;
 }
 
+IScriptWorkers &Context::GetScriptWorkers()
+{
+	return *GetEngine()._data->_scriptWorkers;
+}
+
 IGlobalStorageManager &Context::GetGlobalStorageManager()
 {
 	return *GetEngine()._data->_globalStorageManager;
@@ -32,6 +32,7 @@
 #include "Util/MicrosImpl.hpp"
 #include "Mod/ModManager.hpp"
 #include "Mod/ScriptErrors.hpp"
+#include "Mod/ScriptWorkers.hpp"
 
 #include "SDL3/SDL_events.h"
 #include "SDL3/SDL_timer.h"
@@ -247,6 +248,7 @@ void Engine::ProcessTick() noexcept
 {
 	if (!_data->_scriptErrors->HasLoadtimeError())
 	{
+		_data->_scriptWorkers->ProcessTick();
 		_data->_eventManager->GetCoreEvents().TickUpdate().Invoke();
 	}
 
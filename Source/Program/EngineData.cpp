@@ -32,6 +32,7 @@
 #include "Mod/ModManager.hpp"
 #include "Mod/ScriptErrors.hpp"
 #include "Mod/ScriptLoader.hpp"
+#include "Mod/ScriptWorkers.hpp"
 #include "scripts/GameScripts.hpp"
 
 
@@ -56,6 +57,7 @@ EngineData::EngineData(Context &context) noexcept
       _scriptLoader(std::make_shared<ScriptLoader>(context)),
       _scriptEngine(std::make_shared<ScriptEngine>(context)),
       _scriptErrors(std::make_shared<ScriptErrors>(context)),
+      _scriptWorkers(std::make_shared<ScriptWorkers>(context)),
       _eventManager(std::make_shared<EventManager>(context)),
       _gameScripts(std::make_shared<GameScripts>(context))
 {
@@ -73,6 +75,7 @@ EngineData::EngineData(Context &context) noexcept
 	    _scriptLoader,
 	    _scriptEngine,
 	    _scriptErrors,
+	    _scriptWorkers,
 	};
 
 	std::unordered_map<IEngineComponent *, std::int32_t> fallbackSequences{};
@@ -0,0 +1,287 @@
+/**
+ * @file Resource/DecodedImageCache.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Resource/DecodedImageCache.hpp"
+
+#include "Data/GlobalStorage.hpp"
+#include "Data/HierarchyIterationResult.hpp"
+#include "Data/PathInfo.hpp"
+#include "Data/PathType.hpp"
+#include "System/LogMicros.hpp"
+
+#include "SDL3/SDL_error.h"
+#include "SDL3/SDL_surface.h"
+#include "SDL3/SDL_version.h"
+#include "SDL3_image/SDL_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+using namespace tudov;
+
+namespace
+{
+	struct PersistedHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		// Versions of libraries that decoded pixels, other versions may decode differently.
+		std::int32_t decoderVersion;
+		std::int32_t sdlVersion;
+		BlobHash hash;
+		std::uint32_t format;
+		std::int32_t width;
+		std::int32_t height;
+		std::int32_t pitch;
+	};
+
+	constexpr std::uint32_t persistedMagic = 0x4D494554; // "TEIM"
+	constexpr std::uint32_t persistedVersion = 2;
+
+	std::shared_ptr<impl::SDL_Surface> MakeShared(SDL_Surface *surface) noexcept
+	{
+		return std::shared_ptr<impl::SDL_Surface>(surface, [](impl::SDL_Surface *surface)
+		{
+			SDL_DestroySurface(static_cast<SDL_Surface *>(surface));
+		});
+	}
+} // namespace
+
+DecodedImageCache::DecodedImageCache() noexcept
+    : _surfaces(),
+      _storage(nullptr),
+      _directory(),
+      _persistedSize(0)
+{
+}
+
+Log &DecodedImageCache::GetLog() noexcept
+{
+	return *Log::Get("DecodedImageCache");
+}
+
+void DecodedImageCache::SetStorage(GlobalStorage *storage, const std::filesystem::path &directory) noexcept
+{
+	_storage = storage;
+	_directory = directory;
+	_persistedSize = 0;
+
+	if (_storage != nullptr)
+	{
+		SweepPersisted();
+	}
+}
+
+std::shared_ptr<impl::SDL_Surface> DecodedImageCache::Decode(std::span<const std::byte> bytes, std::optional<BlobHash> hash_)
+{
+	BlobHash hash = hash_.has_value() ? *hash_ : BlobStore::Hash(bytes);
+
+	if (auto it = _surfaces.find(hash); it != _surfaces.end())
+	{
+		if (std::shared_ptr<impl::SDL_Surface> surface = it->second.lock(); surface != nullptr)
+		{
+			return surface;
+		}
+	}
+
+	std::shared_ptr<impl::SDL_Surface> surface = ReadPersisted(hash);
+	if (surface == nullptr)
+	{
+		SDL_IOStream *io = SDL_IOFromConstMem(bytes.data(), bytes.size());
+		if (!io) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("SDL_IOFromConstMem failed: {}", SDL_GetError()));
+		}
+
+		SDL_Surface *sdlSurface = IMG_Load_IO(io, true);
+		if (!sdlSurface) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("IMG_Load_IO failed: {}", SDL_GetError()));
+		}
+
+		surface = MakeShared(sdlSurface);
+		WritePersisted(hash, sdlSurface);
+	}
+
+	_surfaces[hash] = surface;
+	return surface;
+}
+
+void DecodedImageCache::Clear() noexcept
+{
+	_surfaces.clear();
+}
+
+std::filesystem::path DecodedImageCache::GetPersistedFile(BlobHash hash) const noexcept
+{
+	return _directory / std::format("{:016x}.bin", hash);
+}
+
+std::shared_ptr<impl::SDL_Surface> DecodedImageCache::ReadPersisted(BlobHash hash) noexcept
+{
+	if (_storage == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::filesystem::path file = GetPersistedFile(hash);
+	if (_storage->Check(file) == EHierarchyElement::None)
+	{
+		return nullptr;
+	}
+
+	std::vector<std::byte> data;
+	try
+	{
+		data = _storage->ReadFileToBytes(file);
+	}
+	catch (const std::exception &e)
+	{
+		TE_WARN("Failed to read decoded image \"{}\": {}", file.generic_string(), e.what());
+		return nullptr;
+	}
+
+	PersistedHeader header;
+	if (data.size() < sizeof(header)) [[unlikely]]
+	{
+		return nullptr;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	std::size_t pixelsSize = static_cast<std::size_t>(header.pitch) * static_cast<std::size_t>(header.height);
+	if (header.magic != persistedMagic || header.version != persistedVersion || header.decoderVersion != IMG_Version() ||
+	    header.sdlVersion != SDL_GetVersion() || header.hash != hash || header.width <= 0 || header.height <= 0 ||
+	    header.pitch <= 0 || data.size() - sizeof(header) != pixelsSize) [[unlikely]]
+	{
+		// Decoded again and rewritten by caller.
+		TE_DEBUG("Removing outdated or invalid decoded image \"{}\"", file.generic_string());
+		if (_storage->RemovePath(file))
+		{
+			_persistedSize -= std::min<std::uint64_t>(_persistedSize, data.size());
+		}
+		return nullptr;
+	}
+
+	SDL_Surface *sdlSurface = SDL_CreateSurface(header.width, header.height, static_cast<SDL_PixelFormat>(header.format));
+	if (sdlSurface == nullptr || sdlSurface->pitch != header.pitch) [[unlikely]]
+	{
+		SDL_DestroySurface(sdlSurface);
+		return nullptr;
+	}
+
+	std::memcpy(sdlSurface->pixels, data.data() + sizeof(header), pixelsSize);
+
+	TE_TRACE("Read decoded image \"{}\"", file.generic_string());
+	return MakeShared(sdlSurface);
+}
+
+void DecodedImageCache::WritePersisted(BlobHash hash, impl::SDL_Surface *surface) noexcept
+{
+	if (_storage == nullptr)
+	{
+		return;
+	}
+
+	auto *sdlSurface = static_cast<SDL_Surface *>(surface);
+	// Palettes and color keys are not persisted, decode these images every time.
+	if (SDL_ISPIXELFORMAT_INDEXED(sdlSurface->format) || SDL_SurfaceHasColorKey(sdlSurface) || SDL_MUSTLOCK(sdlSurface))
+	{
+		return;
+	}
+
+	PersistedHeader header{
+	    .magic = persistedMagic,
+	    .version = persistedVersion,
+	    .decoderVersion = IMG_Version(),
+	    .sdlVersion = SDL_GetVersion(),
+	    .hash = hash,
+	    .format = static_cast<std::uint32_t>(sdlSurface->format),
+	    .width = sdlSurface->w,
+	    .height = sdlSurface->h,
+	    .pitch = sdlSurface->pitch,
+	};
+	std::size_t pixelsSize = static_cast<std::size_t>(header.pitch) * static_cast<std::size_t>(header.height);
+	if (_persistedSize + sizeof(header) + pixelsSize > PersistedSizeLimit)
+	{
+		TE_TRACE("Decoded images reached size limit, skipped persisting {:016x}", hash);
+		return;
+	}
+
+	std::vector<std::byte> data(sizeof(header) + pixelsSize);
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), sdlSurface->pixels, pixelsSize);
+
+	std::filesystem::path file = GetPersistedFile(hash);
+	if (!_storage->WriteFileFromBytes(file, data))
+	{
+		TE_WARN("Failed to write decoded image \"{}\"", file.generic_string());
+		return;
+	}
+	_persistedSize += data.size();
+}
+
+void DecodedImageCache::SweepPersisted() noexcept
+{
+	struct PersistedFile
+	{
+		std::filesystem::path path;
+		std::uint64_t size;
+		std::int64_t usedTimeNS;
+	};
+
+	std::vector<PersistedFile> files;
+	_storage->Foreach(_directory, [this, &files](const std::filesystem::path &path, const std::filesystem::path &directory, void *) -> EHierarchyIterationResult
+	{
+		std::filesystem::path file = directory / path;
+		PathInfo info = _storage->GetPathInfo(file);
+		if (info.type == EPathType::File)
+		{
+			// Access time is not updated on every file system, modify time is used if it is older.
+			files.emplace_back(PersistedFile{
+			    .path = std::move(file),
+			    .size = info.size,
+			    .usedTimeNS = std::max(info.modifyTimeNS, info.accessTimeNS),
+			});
+			_persistedSize += info.size;
+		}
+
+		return EHierarchyIterationResult::Continue;
+	});
+
+	if (_persistedSize <= PersistedSizeLimit)
+	{
+		return;
+	}
+
+	std::sort(files.begin(), files.end(), [](const PersistedFile &lhs, const PersistedFile &rhs)
+	{
+		return lhs.usedTimeNS < rhs.usedTimeNS;
+	});
+
+	std::size_t removed = 0;
+	for (const PersistedFile &file : files)
+	{
+		if (_persistedSize <= PersistedSweepSize)
+		{
+			break;
+		}
+		if (_storage->RemovePath(file.path))
+		{
+			_persistedSize -= file.size;
+			++removed;
+		}
+	}
+
+	TE_DEBUG("Removed {} least recently used decoded images, {} bytes left", removed, _persistedSize);
+}
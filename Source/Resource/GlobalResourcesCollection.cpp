@@ -11,6 +11,8 @@
 
 #include "Resource/GlobalResourcesCollection.hpp"
 
+#include "Data/Constants.hpp"
+#include "Data/GlobalStorageManager.hpp"
 #include "Data/VirtualFileSystem.hpp"
 #include "Resource/AudioResources.hpp"
 #include "Resource/BinariesResources.hpp"
@@ -90,7 +92,7 @@ void GlobalResourcesCollection::PreInitialize() noexcept
 {
 	auto &virtualFileSystem = GetVirtualFileSystem();
 
-	_handlerIDOnVFSMountFile = virtualFileSystem.GetOnMountFile() += [this](const std::filesystem::path &path, const std::vector<std::byte> &bytes, EResourceType &resourceType)
+	_handlerIDOnVFSMountFile = virtualFileSystem.GetOnMountFile() += [this](const std::filesystem::path &path, std::span<const std::byte> bytes, EResourceType &resourceType)
 	{
 		auto [type, _] = LoadResource(path, bytes);
 		resourceType = type;
@@ -99,11 +101,23 @@ void GlobalResourcesCollection::PreInitialize() noexcept
 	{
 		UnloadResource(path);
 	};
-	_handlerIDOnVFSRemountFile = virtualFileSystem.GetOnRemountFile() += [this](const std::filesystem::path &path, const std::vector<std::byte> &bytes, const std::vector<std::byte> &, EResourceType &resourceType)
+	_handlerIDOnVFSRemountFile = virtualFileSystem.GetOnRemountFile() += [this](const std::filesystem::path &path, std::span<const std::byte> bytes, std::span<const std::byte>, EResourceType &resourceType)
 	{
 		auto [type, _, _1] = ReloadResource(path, bytes);
 		resourceType = type;
 	};
+
+	// Lazily mounted files are loaded once their resources are looked up.
+	auto resolver = [&virtualFileSystem](std::string_view path)
+	{
+		virtualFileSystem.LoadIndexed(path);
+	};
+	_binariesResources->SetResolver(resolver);
+	_fontResources->SetResolver(resolver);
+	_imageResources->SetResolver(resolver);
+	_textResources->SetResolver(resolver);
+
+	_imageResources->GetDecodedCache().SetStorage(&GetGlobalStorageManager().GetUserStorage(), Constants::DataDecodedImagesDirectory);
 }
 
 void GlobalResourcesCollection::Initialize() noexcept
@@ -125,6 +139,14 @@ void GlobalResourcesCollection::PostDeinitialize() noexcept
 	_handlerIDOnVFSMountFile = 0;
 	_handlerIDOnVFSDismountFile = 0;
 	_handlerIDOnVFSRemountFile = 0;
+
+	_binariesResources->SetResolver(nullptr);
+	_fontResources->SetResolver(nullptr);
+	_imageResources->SetResolver(nullptr);
+	_textResources->SetResolver(nullptr);
+
+	_imageResources->GetDecodedCache().SetStorage(nullptr, {});
+	_imageResources->GetDecodedCache().Clear();
 }
 
 BinariesResources &GlobalResourcesCollection::GetBinariesResources() noexcept
@@ -147,7 +169,7 @@ TextResources &GlobalResourcesCollection::GetTextResources() noexcept
 	return *_textResources;
 }
 
-std::tuple<EResourceType, ResourceID> GlobalResourcesCollection::LoadResource(const std::filesystem::path &path, const std::vector<std::byte> &bytes)
+std::tuple<EResourceType, ResourceID> GlobalResourcesCollection::LoadResource(const std::filesystem::path &path, std::span<const std::byte> bytes)
 {
 	if (!path.has_extension()) [[unlikely]]
 	{
@@ -164,7 +186,7 @@ std::tuple<EResourceType, ResourceID> GlobalResourcesCollection::LoadResource(co
 		id = _textResources->Load(path.generic_string(), bytes);
 		break;
 	case EResourceType::Image:
-		id = _imageResources->Load(path.generic_string(), bytes);
+		id = _imageResources->Load(path.generic_string(), bytes, &_imageResources->GetDecodedCache(), GetVirtualFileSystem().GetFileBlobHash(path));
 		break;
 	case EResourceType::Audio:
 		break;
@@ -212,7 +234,7 @@ inline EResourceType GlobalResourcesCollection::UnloadResource(const std::filesy
 	return type;
 }
 
-std::tuple<EResourceType, ResourceID, ResourceID> GlobalResourcesCollection::ReloadResource(const std::filesystem::path &path, const std::vector<std::byte> &bytes)
+std::tuple<EResourceType, ResourceID, ResourceID> GlobalResourcesCollection::ReloadResource(const std::filesystem::path &path, std::span<const std::byte> bytes)
 {
 	if (!path.has_extension()) [[unlikely]]
 	{
@@ -241,7 +263,7 @@ std::tuple<EResourceType, ResourceID, ResourceID> GlobalResourcesCollection::Rel
 		{
 			_imageResources->Unload(oldID);
 		}
-		newID = _imageResources->Load(pathStr, bytes);
+		newID = _imageResources->Load(pathStr, bytes, &_imageResources->GetDecodedCache(), GetVirtualFileSystem().GetFileBlobHash(path));
 		break;
 	case EResourceType::Audio:
 		break;
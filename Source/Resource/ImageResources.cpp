@@ -17,6 +17,11 @@ ImageResources::ImageResources() noexcept
 {
 }
 
+DecodedImageCache &ImageResources::GetDecodedCache() noexcept
+{
+	return _decodedCache;
+}
+
 void ImageResources::InstallToScriptEngine(std::string_view name, ScriptEngine &scriptEngine) noexcept
 {
 }
@@ -0,0 +1,113 @@
+/**
+ * @file Scripts/Client/ZombieManager.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Scripts/Client/ZombieManager.hpp"
+
+using namespace tudov;
+
+void ZombieManager::Update(float deltaTime) noexcept
+{
+	for (Zombie &zombie : _objects)
+	{
+		zombie.x += zombie.velocityX * deltaTime;
+		zombie.y += zombie.velocityY * deltaTime;
+	}
+}
+
+ObjectID ZombieManager::LuaSpawn(float x, float y, sol::object health)
+{
+	return Spawn(Zombie{
+	    .x = x,
+	    .y = y,
+	    .velocityX = 0.0f,
+	    .velocityY = 0.0f,
+	    .health = health.is<float>() ? health.as<float>() : 1.0f,
+	    .flags = 0,
+	});
+}
+
+std::tuple<sol::object, sol::object> ZombieManager::LuaGetPosition(ObjectID objectID, sol::this_state ts) const noexcept
+{
+	const Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return {sol::lua_nil, sol::lua_nil};
+	}
+	return {sol::make_object(ts, zombie->x), sol::make_object(ts, zombie->y)};
+}
+
+bool ZombieManager::LuaSetPosition(ObjectID objectID, float x, float y) noexcept
+{
+	Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return false;
+	}
+	zombie->x = x;
+	zombie->y = y;
+	return true;
+}
+
+std::tuple<sol::object, sol::object> ZombieManager::LuaGetVelocity(ObjectID objectID, sol::this_state ts) const noexcept
+{
+	const Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return {sol::lua_nil, sol::lua_nil};
+	}
+	return {sol::make_object(ts, zombie->velocityX), sol::make_object(ts, zombie->velocityY)};
+}
+
+bool ZombieManager::LuaSetVelocity(ObjectID objectID, float velocityX, float velocityY) noexcept
+{
+	Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return false;
+	}
+	zombie->velocityX = velocityX;
+	zombie->velocityY = velocityY;
+	return true;
+}
+
+sol::object ZombieManager::LuaGetHealth(ObjectID objectID, sol::this_state ts) const noexcept
+{
+	const Zombie *zombie = Get(objectID);
+	return zombie != nullptr ? sol::make_object(ts, zombie->health) : sol::lua_nil;
+}
+
+bool ZombieManager::LuaSetHealth(ObjectID objectID, float health) noexcept
+{
+	Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return false;
+	}
+	zombie->health = health;
+	return true;
+}
+
+sol::object ZombieManager::LuaGetFlags(ObjectID objectID, sol::this_state ts) const noexcept
+{
+	const Zombie *zombie = Get(objectID);
+	return zombie != nullptr ? sol::make_object(ts, zombie->flags) : sol::lua_nil;
+}
+
+bool ZombieManager::LuaSetFlags(ObjectID objectID, std::uint32_t flags) noexcept
+{
+	Zombie *zombie = Get(objectID);
+	if (zombie == nullptr)
+	{
+		return false;
+	}
+	zombie->flags = flags;
+	return true;
+}
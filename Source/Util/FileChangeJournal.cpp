@@ -0,0 +1,172 @@
+/**
+ * @file Util/FileChangeJournal.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Util/FileChangeJournal.hpp"
+
+#include "Data/PathType.hpp"
+#include "Util/FileChangeType.hpp"
+
+using namespace tudov;
+
+FileChangeJournal::FileChangeJournal(std::chrono::steady_clock::duration window, SettledCallback onSettled) noexcept
+    : _window(window),
+      _onSettled(std::move(onSettled)),
+      _changes(),
+      _lastRecordTime(),
+      _stopping(false)
+{
+}
+
+FileChangeJournal::~FileChangeJournal() noexcept
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock{_mutex};
+			_stopping = true;
+		}
+		_cv.notify_all();
+		_thread.join();
+	}
+}
+
+void FileChangeJournal::Record(const std::filesystem::path &path, EPathType pathType, EFileChangeType changeType) noexcept
+{
+	switch (changeType)
+	{
+	case EFileChangeType::RenamedOld:
+		changeType = EFileChangeType::Removed;
+		break;
+	case EFileChangeType::RenamedNew:
+		changeType = EFileChangeType::Added;
+		break;
+	default:
+		break;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+
+		if (!_thread.joinable()) [[unlikely]]
+		{
+			_thread = std::thread(&FileChangeJournal::WorkerMain, this);
+		}
+
+		_lastRecordTime = std::chrono::steady_clock::now();
+
+		auto it = _changes.find(path);
+		if (it == _changes.end())
+		{
+			_changes.emplace(path, std::make_tuple(pathType, changeType));
+		}
+		else
+		{
+			auto &[previousPathType, previousChangeType] = it->second;
+
+			// Net effect relative to the state before first change.
+			switch (previousChangeType)
+			{
+			case EFileChangeType::Added:
+				if (changeType == EFileChangeType::Removed)
+				{
+					_changes.erase(it);
+					break;
+				}
+				previousPathType = pathType;
+				break;
+			case EFileChangeType::Removed:
+				previousPathType = pathType;
+				previousChangeType = changeType == EFileChangeType::Removed ? EFileChangeType::Removed : EFileChangeType::Modified;
+				break;
+			default:
+				previousPathType = pathType;
+				previousChangeType = changeType == EFileChangeType::Removed ? EFileChangeType::Removed : EFileChangeType::Modified;
+				break;
+			}
+		}
+	}
+	_cv.notify_one();
+}
+
+std::vector<FileChangeJournal::Change> FileChangeJournal::TakeSettled() noexcept
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+
+	if (_changes.empty() || std::chrono::steady_clock::now() - _lastRecordTime < _window)
+	{
+		return {};
+	}
+
+	std::vector<Change> changes;
+	changes.reserve(_changes.size());
+	for (auto &[path, change] : _changes)
+	{
+		auto &[pathType, changeType] = change;
+		changes.emplace_back(Change{
+		    .path = path,
+		    .pathType = pathType,
+		    .changeType = changeType,
+		});
+	}
+	_changes.clear();
+
+	return changes;
+}
+
+void FileChangeJournal::Clear() noexcept
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	_changes.clear();
+}
+
+void FileChangeJournal::WorkerMain() noexcept
+{
+	std::unique_lock<std::mutex> lock{_mutex};
+
+	while (true)
+	{
+		_cv.wait(lock, [this]()
+		{
+			return _stopping || !_changes.empty();
+		});
+
+		if (_stopping)
+		{
+			return;
+		}
+
+		// Sleep until no change was recorded for a whole window.
+		std::chrono::steady_clock::time_point deadline = _lastRecordTime + _window;
+		while (!_stopping && std::chrono::steady_clock::now() < deadline)
+		{
+			_cv.wait_until(lock, deadline);
+			deadline = _lastRecordTime + _window;
+		}
+
+		if (_stopping)
+		{
+			return;
+		}
+
+		if (!_changes.empty())
+		{
+			lock.unlock();
+			_onSettled();
+			lock.lock();
+
+			// Taking may be delayed by a load in progress, remind again later.
+			_cv.wait_for(lock, _window, [this]()
+			{
+				return _stopping;
+			});
+		}
+	}
+}
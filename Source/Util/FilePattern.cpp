@@ -0,0 +1,128 @@
+/**
+ * @file Util/FilePattern.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Util/FilePattern.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace tudov;
+
+static char ToLowerASCII(char ch) noexcept
+{
+	return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+static bool EqualsIgnoreCase(std::string_view str, std::string_view lowerLiteral) noexcept
+{
+	return str.size() == lowerLiteral.size() && std::equal(str.begin(), str.end(), lowerLiteral.begin(), [](char l, char r)
+	{
+		return ToLowerASCII(l) == r;
+	});
+}
+
+FilePattern::FilePattern(std::string_view pattern)
+    : _kind(EKind::Regex),
+      _literal(),
+      _regex(nullptr)
+{
+	// Matching is always against whole path, anchors change nothing.
+	std::string_view body = pattern;
+	if (body.starts_with('^'))
+	{
+		body.remove_prefix(1);
+	}
+	if (body.ends_with('$') && !body.ends_with("\\$"))
+	{
+		body.remove_suffix(1);
+	}
+
+	if (body == ".*")
+	{
+		_kind = EKind::Any;
+		return;
+	}
+
+	if (body.starts_with(".*") && ToLiteral(body.substr(2), _literal))
+	{
+		_kind = EKind::Suffix;
+		return;
+	}
+
+	if (ToLiteral(body, _literal))
+	{
+		_kind = EKind::Exact;
+		return;
+	}
+
+	_literal.clear();
+	_regex = std::make_unique<std::regex>(std::string(pattern), std::regex_constants::icase | std::regex_constants::optimize);
+}
+
+FilePattern::EKind FilePattern::GetKind() const noexcept
+{
+	return _kind;
+}
+
+bool FilePattern::Match(std::string_view file) const noexcept
+{
+	switch (_kind)
+	{
+	case EKind::Any:
+		return true;
+	case EKind::Exact:
+		return EqualsIgnoreCase(file, _literal);
+	case EKind::Suffix:
+		return file.size() >= _literal.size() && EqualsIgnoreCase(file.substr(file.size() - _literal.size()), _literal);
+	case EKind::Regex:
+		return std::regex_match(file.begin(), file.end(), *_regex);
+	default:
+		return false;
+	}
+}
+
+bool FilePattern::MatchAny(std::string_view file, std::span<const FilePattern> patterns) noexcept
+{
+	return std::any_of(patterns.begin(), patterns.end(), [file](const FilePattern &pattern)
+	{
+		return pattern.Match(file);
+	});
+}
+
+bool FilePattern::ToLiteral(std::string_view pattern, std::string &literal) noexcept
+{
+	static constexpr std::string_view specialCharacters = ".[]{}()*+?|^$";
+
+	literal.clear();
+	literal.reserve(pattern.size());
+
+	for (std::size_t i = 0; i < pattern.size(); ++i)
+	{
+		char ch = pattern[i];
+		if (ch == '\\')
+		{
+			// Only escaped punctuation is literal, e.g. "\d" is a character class.
+			if (i + 1 >= pattern.size() || std::isalnum(static_cast<unsigned char>(pattern[i + 1])))
+			{
+				return false;
+			}
+			ch = pattern[++i];
+		}
+		else if (specialCharacters.find(ch) != std::string_view::npos)
+		{
+			return false;
+		}
+
+		literal.push_back(ToLowerASCII(ch));
+	}
+
+	return true;
+}
@@ -12,6 +12,9 @@
 #include "Util/NoiseRandoms.hpp"
 
 #include "FastNoiseLite.hpp"
+#include "sol/state_view.hpp"
+
+#include <algorithm>
 #include <cmath>
 
 using namespace tudov;
@@ -60,12 +63,14 @@ void PerlinNoiseRandom::SetSeed(std::int32_t value) noexcept
 {
 	_seed = value;
 	static_cast<FastNoiseLite *>(_data)->SetSeed(value);
+	_cachedGrids.clear();
 }
 
 void PerlinNoiseRandom::SetFrequency(std::float_t value) noexcept
 {
 	_frequency = value;
 	static_cast<FastNoiseLite *>(_data)->SetFrequency(value);
+	_cachedGrids.clear();
 }
 
 std::float_t PerlinNoiseRandom::Noise1(std::float_t x) noexcept
@@ -98,19 +103,187 @@ std::float_t PerlinNoiseRandom::Float3(std::float_t x, std::float_t y, std::floa
 	return min + (Noise3(x, y, z) + 1.0f) * 0.5f * (max - min);
 }
 
-static constexpr std::float_t granularity = 2 ^ 24 - 1;
+static constexpr std::float_t granularity = static_cast<std::float_t>((1 << 24) - 1);
+
+static std::int32_t NoiseToInt(std::float_t noise, std::int32_t min, std::int32_t max) noexcept
+{
+	return min + static_cast<std::int32_t>((noise + 1.0f) * 0.5f * granularity) % (max - min + 1);
+}
 
 std::int32_t PerlinNoiseRandom::Int1(std::float_t x, std::int32_t min, std::int32_t max) noexcept
 {
-	return min + static_cast<std::int32_t>((Noise1(x) + 1.0f) * 0.5f * granularity) % (max - min + 1);
+	return NoiseToInt(Noise1(x), min, max);
 }
 
 std::int32_t PerlinNoiseRandom::Int2(std::float_t x, std::float_t y, std::int32_t min, std::int32_t max) noexcept
 {
-	return min + static_cast<std::int32_t>((Noise2(x, y) + 1.0f) * 0.5f * granularity) % (max - min + 1);
+	return NoiseToInt(Noise2(x, y), min, max);
 }
 
 std::int32_t PerlinNoiseRandom::Int3(std::float_t x, std::float_t y, std::float_t z, std::int32_t min, std::int32_t max) noexcept
 {
-	return min + static_cast<std::int32_t>((Noise3(x, y, z) + 1.0f) * 0.5f * granularity) % (max - min + 1);
+	return NoiseToInt(Noise3(x, y, z), min, max);
+}
+
+void PerlinNoiseRandom::FillNoise2(std::span<std::float_t> output, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height) noexcept
+{
+	auto &noise = *static_cast<FastNoiseLite *>(_data);
+	height = width > 0 ? std::min<std::int32_t>(height, static_cast<std::int32_t>(output.size() / width)) : 0;
+
+	std::float_t *out = output.data();
+	for (std::int32_t j = 0; j < height; ++j)
+	{
+		auto fy = static_cast<std::float_t>(y + j);
+		for (std::int32_t i = 0; i < width; ++i)
+		{
+			*out++ = noise.GetNoise(static_cast<std::float_t>(x + i), fy);
+		}
+	}
+}
+
+void PerlinNoiseRandom::FillInt2(std::span<std::int32_t> output, std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max) noexcept
+{
+	auto &noise = *static_cast<FastNoiseLite *>(_data);
+	height = width > 0 ? std::min<std::int32_t>(height, static_cast<std::int32_t>(output.size() / width)) : 0;
+
+	std::int32_t *out = output.data();
+	for (std::int32_t j = 0; j < height; ++j)
+	{
+		auto fy = static_cast<std::float_t>(y + j);
+		for (std::int32_t i = 0; i < width; ++i)
+		{
+			*out++ = NoiseToInt(noise.GetNoise(static_cast<std::float_t>(x + i), fy), min, max);
+		}
+	}
+}
+
+void PerlinNoiseRandom::SampleNoise2(std::span<const std::float_t> coords, std::span<std::float_t> output) noexcept
+{
+	auto &noise = *static_cast<FastNoiseLite *>(_data);
+	std::size_t count = std::min(coords.size() / 2, output.size());
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		output[i] = noise.GetNoise(coords[i * 2], coords[i * 2 + 1]);
+	}
+}
+
+void PerlinNoiseRandom::SampleInt2(std::span<const std::float_t> coords, std::span<std::int32_t> output, std::int32_t min, std::int32_t max) noexcept
+{
+	auto &noise = *static_cast<FastNoiseLite *>(_data);
+	std::size_t count = std::min(coords.size() / 2, output.size());
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		output[i] = NoiseToInt(noise.GetNoise(coords[i * 2], coords[i * 2 + 1]), min, max);
+	}
+}
+
+std::span<const std::int32_t> PerlinNoiseRandom::GetInt2Grid(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max) noexcept
+{
+	width = std::max(width, 0);
+	height = std::max(height, 0);
+
+	auto it = std::find_if(_cachedGrids.begin(), _cachedGrids.end(), [&](const CachedGrid &grid)
+	{
+		return grid.seed == _seed && grid.frequency == _frequency && grid.x == x && grid.y == y && grid.width == width &&
+		       grid.height == height && grid.min == min && grid.max == max;
+	});
+
+	if (it != _cachedGrids.end()) [[likely]]
+	{
+		std::rotate(it, it + 1, _cachedGrids.end());
+		return _cachedGrids.back().values;
+	}
+
+	if (_cachedGrids.size() >= MaxCachedGrids)
+	{
+		_cachedGrids.erase(_cachedGrids.begin());
+	}
+
+	CachedGrid &grid = _cachedGrids.emplace_back(CachedGrid{
+	    .seed = _seed,
+	    .frequency = _frequency,
+	    .x = x,
+	    .y = y,
+	    .width = width,
+	    .height = height,
+	    .min = min,
+	    .max = max,
+	    .values = std::vector<std::int32_t>(static_cast<std::size_t>(width) * height),
+	});
+	FillInt2(grid.values, x, y, width, height, min, max);
+	return grid.values;
+}
+
+static sol::table GetOrCreateBuffer(sol::object buffer, std::size_t size, sol::this_state ts) noexcept
+{
+	if (buffer.is<sol::table>())
+	{
+		return buffer.as<sol::table>();
+	}
+	return sol::state_view(ts).create_table(static_cast<int>(size), 0);
+}
+
+sol::table PerlinNoiseRandom::LuaFillNoise2(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, sol::object buffer, sol::this_state ts) noexcept
+{
+	std::vector<std::float_t> values(static_cast<std::size_t>(std::max(width, 0)) * std::max(height, 0));
+	FillNoise2(values, x, y, width, height);
+
+	sol::table result = GetOrCreateBuffer(buffer, values.size(), ts);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		result[i + 1] = values[i];
+	}
+	return result;
+}
+
+sol::table PerlinNoiseRandom::LuaFillInt2(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max, sol::object buffer, sol::this_state ts) noexcept
+{
+	std::span<const std::int32_t> values = GetInt2Grid(x, y, width, height, min, max);
+
+	sol::table result = GetOrCreateBuffer(buffer, values.size(), ts);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		result[i + 1] = values[i];
+	}
+	return result;
+}
+
+sol::table PerlinNoiseRandom::LuaSampleNoise2(sol::table coords, sol::object buffer, sol::this_state ts) noexcept
+{
+	std::vector<std::float_t> coords_(coords.size());
+	for (std::size_t i = 0; i < coords_.size(); ++i)
+	{
+		coords_[i] = coords.get_or<std::float_t>(i + 1, 0.0f);
+	}
+
+	std::vector<std::float_t> values(coords_.size() / 2);
+	SampleNoise2(coords_, values);
+
+	sol::table result = GetOrCreateBuffer(buffer, values.size(), ts);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		result[i + 1] = values[i];
+	}
+	return result;
+}
+
+sol::table PerlinNoiseRandom::LuaSampleInt2(sol::table coords, std::int32_t min, std::int32_t max, sol::object buffer, sol::this_state ts) noexcept
+{
+	std::vector<std::float_t> coords_(coords.size());
+	for (std::size_t i = 0; i < coords_.size(); ++i)
+	{
+		coords_[i] = coords.get_or<std::float_t>(i + 1, 0.0f);
+	}
+
+	std::vector<std::int32_t> values(coords_.size() / 2);
+	SampleInt2(coords_, values, min, max);
+
+	sol::table result = GetOrCreateBuffer(buffer, values.size(), ts);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		result[i + 1] = values[i];
+	}
+	return result;
 }
\ No newline at end of file
@@ -0,0 +1,592 @@
+/**
+ * @file Util/SchemaCodec.cpp
+ * @author JagYayu
+ * @brief
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "Util/SchemaCodec.hpp"
+
+#include "bitsery/adapter/buffer.h"
+#include "bitsery/bitsery.h"
+#include "bitsery/ext/compact_value.h"
+#include "bitsery/traits/string.h"
+#include "sol/state_view.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+using namespace tudov;
+
+namespace
+{
+	using Buffer = std::string;
+	using Writer = bitsery::Serializer<bitsery::OutputBufferAdapter<Buffer>>;
+	using Reader = bitsery::Deserializer<bitsery::InputBufferAdapter<Buffer>>;
+
+	constexpr std::size_t maxTextSize = std::numeric_limits<std::uint32_t>::max();
+
+	/**
+	 * 2 bits per field.
+	 */
+	enum EFieldState : std::uint8_t
+	{
+		FieldNil = 0,
+		// Integer, string, or `false` for boolean fields.
+		FieldValue = 1,
+		// Double, or `true` for boolean fields.
+		FieldAltValue = 2,
+		// Anything else, tagged.
+		FieldAny = 3,
+	};
+
+	enum class EValueTag : std::uint8_t
+	{
+		Nil = 0,
+		False,
+		True,
+		Integer,
+		Double,
+		String,
+		Table,
+	};
+
+	/**
+	 * -0.0 is not an integer here, it would decode as 0.
+	 */
+	bool IsInteger(std::double_t value) noexcept
+	{
+		return value == std::floor(value) && std::abs(value) <= 9007199254740992.0 && !(value == 0 && std::signbit(value));
+	}
+
+	/**
+	 * Hash part entry of a table, keys are sorted so encoding does not depend on `next` order of the lua state.
+	 */
+	struct KeyedItem
+	{
+		// Booleans, then numbers, then strings.
+		std::uint8_t rank;
+		std::double_t number;
+		std::string string;
+		sol::object key;
+		sol::object item;
+	};
+
+	bool operator<(const KeyedItem &l, const KeyedItem &r) noexcept
+	{
+		if (l.rank != r.rank)
+		{
+			return l.rank < r.rank;
+		}
+		return l.rank == 2 ? l.string < r.string : l.number < r.number;
+	}
+
+	void WriteInteger(Writer &writer, std::double_t value)
+	{
+		auto integer = static_cast<std::int64_t>(value);
+		writer.ext8b(integer, bitsery::ext::CompactValue{});
+	}
+
+	std::double_t ReadInteger(Reader &reader)
+	{
+		std::int64_t integer = 0;
+		reader.ext8b(integer, bitsery::ext::CompactValue{});
+		return static_cast<std::double_t>(integer);
+	}
+
+	void WriteAny(Writer &writer, const sol::object &value, std::size_t depth)
+	{
+		if (depth > SchemaCodec::MaxDepth) [[unlikely]]
+		{
+			throw std::runtime_error("Table is nested too deep");
+		}
+
+		switch (value.get_type())
+		{
+		case sol::type::lua_nil:
+		case sol::type::none:
+			writer.value1b(EValueTag::Nil);
+			break;
+		case sol::type::boolean:
+			writer.value1b(value.as<bool>() ? EValueTag::True : EValueTag::False);
+			break;
+		case sol::type::number:
+		{
+			auto number = value.as<std::double_t>();
+			if (IsInteger(number))
+			{
+				writer.value1b(EValueTag::Integer);
+				WriteInteger(writer, number);
+			}
+			else
+			{
+				writer.value1b(EValueTag::Double);
+				writer.value8b(number);
+			}
+			break;
+		}
+		case sol::type::string:
+			writer.value1b(EValueTag::String);
+			writer.text1b(value.as<std::string>(), maxTextSize);
+			break;
+		case sol::type::table:
+		{
+			auto table = value.as<sol::table>();
+
+			// Array part in index order, then the rest in key order.
+			std::size_t arraySize = 0;
+			while (table.raw_get<sol::object>(arraySize + 1).get_type() != sol::type::lua_nil)
+			{
+				++arraySize;
+			}
+
+			std::vector<KeyedItem> keyedItems;
+			for (auto &&[key, item] : table)
+			{
+				KeyedItem keyedItem{
+				    .rank = 0,
+				    .number = 0,
+				    .string = {},
+				    .key = key,
+				    .item = item,
+				};
+
+				switch (key.get_type())
+				{
+				case sol::type::boolean:
+					keyedItem.number = key.as<bool>() ? 1 : 0;
+					break;
+				case sol::type::number:
+					keyedItem.rank = 1;
+					keyedItem.number = key.as<std::double_t>();
+					if (keyedItem.number >= 1 && keyedItem.number <= static_cast<std::double_t>(arraySize) && IsInteger(keyedItem.number))
+					{
+						continue;
+					}
+					break;
+				case sol::type::string:
+					keyedItem.rank = 2;
+					keyedItem.string = key.as<std::string>();
+					break;
+				default:
+					throw std::runtime_error(std::format("Can not encode table key of type '{}'", sol::type_name(key.lua_state(), key.get_type())));
+				}
+
+				keyedItems.emplace_back(std::move(keyedItem));
+			}
+			std::sort(keyedItems.begin(), keyedItems.end());
+
+			writer.value1b(EValueTag::Table);
+			writer.ext8b(static_cast<std::uint64_t>(arraySize + keyedItems.size()), bitsery::ext::CompactValue{});
+			for (std::size_t i = 1; i <= arraySize; ++i)
+			{
+				writer.value1b(EValueTag::Integer);
+				WriteInteger(writer, static_cast<std::double_t>(i));
+				WriteAny(writer, table.raw_get<sol::object>(i), depth + 1);
+			}
+			for (const KeyedItem &keyedItem : keyedItems)
+			{
+				WriteAny(writer, keyedItem.key, depth + 1);
+				WriteAny(writer, keyedItem.item, depth + 1);
+			}
+			break;
+		}
+		default:
+			throw std::runtime_error(std::format("Can not encode value of type '{}'", sol::type_name(value.lua_state(), value.get_type())));
+		}
+	}
+
+	sol::object ReadAny(Reader &reader, sol::state_view &lua, std::size_t depth)
+	{
+		if (depth > SchemaCodec::MaxDepth) [[unlikely]]
+		{
+			throw std::runtime_error("Table is nested too deep");
+		}
+
+		EValueTag tag = EValueTag::Nil;
+		reader.value1b(tag);
+
+		switch (tag)
+		{
+		case EValueTag::Nil:
+			return sol::lua_nil;
+		case EValueTag::False:
+			return sol::make_object(lua, false);
+		case EValueTag::True:
+			return sol::make_object(lua, true);
+		case EValueTag::Integer:
+			return sol::make_object(lua, ReadInteger(reader));
+		case EValueTag::Double:
+		{
+			std::double_t number = 0;
+			reader.value8b(number);
+			return sol::make_object(lua, number);
+		}
+		case EValueTag::String:
+		{
+			std::string string;
+			reader.text1b(string, maxTextSize);
+			return sol::make_object(lua, string);
+		}
+		case EValueTag::Table:
+		{
+			std::uint64_t count = 0;
+			reader.ext8b(count, bitsery::ext::CompactValue{});
+
+			sol::table table = lua.create_table();
+			for (std::uint64_t i = 0; i < count; ++i)
+			{
+				sol::object key = ReadAny(reader, lua, depth + 1);
+				sol::object item = ReadAny(reader, lua, depth + 1);
+				if (key.get_type() == sol::type::lua_nil || reader.adapter().error() != bitsery::ReaderError::NoError) [[unlikely]]
+				{
+					throw std::runtime_error("Corrupted table data");
+				}
+				table.raw_set(key, item);
+			}
+			return table;
+		}
+		default:
+			throw std::runtime_error(std::format("Invalid value tag {}", static_cast<std::uint32_t>(tag)));
+		}
+	}
+
+	void WriteRecord(Writer &writer, const SchemaCodec::Schema &schema, sol::table record)
+	{
+		const std::vector<SchemaCodec::Field> &fields = schema.fields;
+
+		std::vector<sol::object> values;
+		std::vector<EFieldState> states;
+		values.reserve(fields.size());
+		states.reserve(fields.size());
+
+		for (const SchemaCodec::Field &field : fields)
+		{
+			sol::object value = record.raw_get<sol::object>(field.key);
+			sol::type type = value.get_type();
+
+			EFieldState state = FieldAny;
+			if (type == sol::type::lua_nil || type == sol::type::none)
+			{
+				state = FieldNil;
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::Boolean && type == sol::type::boolean)
+			{
+				state = value.as<bool>() ? FieldAltValue : FieldValue;
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::Number && type == sol::type::number)
+			{
+				state = IsInteger(value.as<std::double_t>()) ? FieldValue : FieldAltValue;
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::String && type == sol::type::string)
+			{
+				state = FieldValue;
+			}
+
+			values.emplace_back(std::move(value));
+			states.emplace_back(state);
+		}
+
+		writer.enableBitPacking([&states](auto &packer)
+		{
+			for (EFieldState state : states)
+			{
+				packer.adapter().writeBits(static_cast<std::uint8_t>(state), 2u);
+			}
+		});
+
+		for (std::size_t i = 0; i < fields.size(); ++i)
+		{
+			EFieldState state = states[i];
+			const sol::object &value = values[i];
+
+			if (state == FieldAny)
+			{
+				WriteAny(writer, value, 1);
+			}
+			else if (fields[i].kind == SchemaCodec::EFieldKind::Number)
+			{
+				if (state == FieldValue)
+				{
+					WriteInteger(writer, value.as<std::double_t>());
+				}
+				else if (state == FieldAltValue)
+				{
+					writer.value8b(value.as<std::double_t>());
+				}
+			}
+			else if (fields[i].kind == SchemaCodec::EFieldKind::String && state == FieldValue)
+			{
+				writer.text1b(value.as<std::string>(), maxTextSize);
+			}
+		}
+
+		// Keys not in schema.
+		std::vector<std::pair<sol::object, sol::object>> extras;
+		for (auto &&[key, value] : record)
+		{
+			if (key.get_type() != sol::type::string || !schema.indices.contains(key.as<std::string>()))
+			{
+				extras.emplace_back(key, value);
+			}
+		}
+
+		auto extraCount = static_cast<std::uint64_t>(extras.size());
+		writer.ext8b(extraCount, bitsery::ext::CompactValue{});
+		for (auto &&[key, value] : extras)
+		{
+			WriteAny(writer, key, 1);
+			WriteAny(writer, value, 1);
+		}
+	}
+
+	sol::table ReadRecord(Reader &reader, const SchemaCodec::Schema &schema, sol::state_view &lua)
+	{
+		const std::vector<SchemaCodec::Field> &fields = schema.fields;
+
+		std::vector<EFieldState> states(fields.size(), FieldNil);
+		reader.enableBitPacking([&states](auto &unpacker)
+		{
+			for (EFieldState &state : states)
+			{
+				std::uint8_t bits = 0;
+				unpacker.adapter().readBits(bits, 2u);
+				state = static_cast<EFieldState>(bits);
+			}
+		});
+
+		sol::table record = lua.create_table(0, static_cast<int>(fields.size()));
+		for (std::size_t i = 0; i < fields.size(); ++i)
+		{
+			const SchemaCodec::Field &field = fields[i];
+			EFieldState state = states[i];
+
+			if (state == FieldNil)
+			{
+				continue;
+			}
+			else if (state == FieldAny)
+			{
+				record.raw_set(field.key, ReadAny(reader, lua, 1));
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::Boolean)
+			{
+				record.raw_set(field.key, state == FieldAltValue);
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::Number)
+			{
+				if (state == FieldValue)
+				{
+					record.raw_set(field.key, ReadInteger(reader));
+				}
+				else
+				{
+					std::double_t number = 0;
+					reader.value8b(number);
+					record.raw_set(field.key, number);
+				}
+			}
+			else if (field.kind == SchemaCodec::EFieldKind::String)
+			{
+				std::string string;
+				reader.text1b(string, maxTextSize);
+				record.raw_set(field.key, std::move(string));
+			}
+			else [[unlikely]]
+			{
+				throw std::runtime_error(std::format("Corrupted data of field '{}'", field.key));
+			}
+		}
+
+		std::uint64_t extraCount = 0;
+		reader.ext8b(extraCount, bitsery::ext::CompactValue{});
+		for (std::uint64_t i = 0; i < extraCount; ++i)
+		{
+			sol::object key = ReadAny(reader, lua, 1);
+			sol::object value = ReadAny(reader, lua, 1);
+			if (key.get_type() == sol::type::lua_nil || reader.adapter().error() != bitsery::ReaderError::NoError) [[unlikely]]
+			{
+				throw std::runtime_error("Corrupted record data");
+			}
+			record.raw_set(key, value);
+		}
+
+		return record;
+	}
+
+	void CheckVersion(Reader &reader)
+	{
+		std::uint8_t version = 0;
+		reader.value1b(version);
+		if (version != SchemaCodec::FormatVersion) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Unsupported format version {}", version));
+		}
+	}
+
+	void CheckReader(Reader &reader)
+	{
+		if (reader.adapter().error() != bitsery::ReaderError::NoError || !reader.adapter().isCompletedSuccessfully()) [[unlikely]]
+		{
+			throw std::runtime_error("Corrupted data");
+		}
+	}
+} // namespace
+
+void SchemaCodec::Compile(SchemaID schemaID, sol::table defaults) noexcept
+{
+	Schema schema;
+
+	for (auto &&[key, value] : defaults)
+	{
+		if (key.get_type() != sol::type::string)
+		{
+			continue;
+		}
+
+		EFieldKind kind = EFieldKind::Any;
+		switch (value.get_type())
+		{
+		case sol::type::boolean:
+			kind = EFieldKind::Boolean;
+			break;
+		case sol::type::number:
+			kind = EFieldKind::Number;
+			break;
+		case sol::type::string:
+			kind = EFieldKind::String;
+			break;
+		default:
+			break;
+		}
+
+		schema.fields.emplace_back(Field{
+		    .key = key.as<std::string>(),
+		    .kind = kind,
+		});
+	}
+
+	// Iteration order of lua tables is unspecified, sort so that every peer compiles the same layout.
+	std::sort(schema.fields.begin(), schema.fields.end(), [](const Field &l, const Field &r)
+	{
+		return l.key < r.key;
+	});
+
+	for (std::size_t i = 0; i < schema.fields.size(); ++i)
+	{
+		schema.indices.try_emplace(schema.fields[i].key, i);
+	}
+
+	_schemas.insert_or_assign(schemaID, std::move(schema));
+}
+
+bool SchemaCodec::HasSchema(SchemaID schemaID) const noexcept
+{
+	return _schemas.contains(schemaID);
+}
+
+const SchemaCodec::Schema *SchemaCodec::GetSchema(SchemaID schemaID) const noexcept
+{
+	auto it = _schemas.find(schemaID);
+	return it != _schemas.end() ? &it->second : nullptr;
+}
+
+void SchemaCodec::Clear() noexcept
+{
+	_schemas.clear();
+}
+
+std::string SchemaCodec::Encode(SchemaID schemaID, sol::table record) const
+{
+	const Schema &schema = GetSchemaOrThrow(schemaID);
+
+	Buffer buffer;
+	Writer writer{buffer};
+	writer.value1b(FormatVersion);
+	WriteRecord(writer, schema, record);
+
+	writer.adapter().flush();
+	buffer.resize(writer.adapter().writtenBytesCount());
+	return buffer;
+}
+
+std::string SchemaCodec::EncodeList(SchemaID schemaID, sol::table records) const
+{
+	const Schema &schema = GetSchemaOrThrow(schemaID);
+
+	Buffer buffer;
+	Writer writer{buffer};
+	writer.value1b(FormatVersion);
+
+	auto count = static_cast<std::uint64_t>(records.size());
+	writer.ext8b(count, bitsery::ext::CompactValue{});
+	for (std::uint64_t i = 1; i <= count; ++i)
+	{
+		sol::optional<sol::table> record = records.raw_get<sol::optional<sol::table>>(i);
+		if (!record.has_value()) [[unlikely]]
+		{
+			throw std::runtime_error(std::format("Record #{} is not a table", i));
+		}
+		WriteRecord(writer, schema, *record);
+	}
+
+	writer.adapter().flush();
+	buffer.resize(writer.adapter().writtenBytesCount());
+	return buffer;
+}
+
+sol::table SchemaCodec::Decode(SchemaID schemaID, const std::string &data, sol::this_state ts) const
+{
+	const Schema &schema = GetSchemaOrThrow(schemaID);
+	sol::state_view lua{ts};
+
+	Reader reader{bitsery::InputBufferAdapter<Buffer>{data.begin(), data.size()}};
+	CheckVersion(reader);
+	sol::table record = ReadRecord(reader, schema, lua);
+	CheckReader(reader);
+
+	return record;
+}
+
+sol::table SchemaCodec::DecodeList(SchemaID schemaID, const std::string &data, sol::this_state ts) const
+{
+	const Schema &schema = GetSchemaOrThrow(schemaID);
+	sol::state_view lua{ts};
+
+	Reader reader{bitsery::InputBufferAdapter<Buffer>{data.begin(), data.size()}};
+	CheckVersion(reader);
+
+	std::uint64_t count = 0;
+	reader.ext8b(count, bitsery::ext::CompactValue{});
+	// Every record takes at least one byte, a larger count means corrupted data.
+	if (count > data.size()) [[unlikely]]
+	{
+		throw std::runtime_error("Corrupted data");
+	}
+
+	sol::table records = lua.create_table(static_cast<int>(count), 0);
+	for (std::uint64_t i = 1; i <= count; ++i)
+	{
+		records.raw_set(i, ReadRecord(reader, schema, lua));
+	}
+	CheckReader(reader);
+
+	return records;
+}
+
+const SchemaCodec::Schema &SchemaCodec::GetSchemaOrThrow(SchemaID schemaID) const
+{
+	auto it = _schemas.find(schemaID);
+	if (it == _schemas.end()) [[unlikely]]
+	{
+		throw std::runtime_error(std::format("Schema {} not compiled", schemaID));
+	}
+	return it->second;
+}
@@ -0,0 +1,461 @@
+/**
+ * @file Tools/Pack/Main.cpp
+ * @author JagYayu
+ * @brief Package builder, turns a developer assets directory into a runtime package.
+ * @version 1.0
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025 JagYayu. Licensed under MIT License.
+ *
+ */
+
+#include "lua.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Packages are plain zip files, so any zip tool can inspect them. Differences from a zip tool's output:
+ * - Every entry is stored, runtime serves stored entries as views into the mapped package without copying.
+ * - Contents start at an aligned offset, padded with local header extra field like `zipalign` does.
+ * - Entries are sorted by name and have fixed timestamps, same input always gives same package.
+ * - Optionally, lua scripts are compiled to LuaJIT bytecode and keep their names, runtime loads either form.
+ */
+
+namespace
+{
+	constexpr std::uint32_t localHeaderSignature = 0x04034B50;
+	constexpr std::uint32_t centralHeaderSignature = 0x02014B50;
+	constexpr std::uint32_t endOfCentralDirectorySignature = 0x06054B50;
+	constexpr std::uint16_t versionStored = 10;
+	constexpr std::uint16_t flagUTF8 = 0x0800;
+	constexpr std::uint16_t methodStored = 0;
+	// 1980-01-01 00:00:00 in MS-DOS format.
+	constexpr std::uint16_t dosTime = 0;
+	constexpr std::uint16_t dosDate = (1 << 5) | 1;
+	// Extra field id used by Android's zipalign for padding.
+	constexpr std::uint16_t paddingExtraId = 0xD935;
+	constexpr std::size_t localHeaderSize = 30;
+	constexpr std::size_t extraHeaderSize = 4;
+
+	struct Options
+	{
+		std::filesystem::path input;
+		std::filesystem::path output;
+		std::size_t alignment = 64;
+		bool bytecode = false;
+		bool verbose = false;
+	};
+
+	struct Entry
+	{
+		std::string name;
+		std::uint32_t size;
+		std::uint32_t crc;
+		std::uint32_t localHeaderOffset;
+	};
+
+	std::uint32_t CRC32(std::span<const std::byte> bytes) noexcept
+	{
+		static const std::array<std::uint32_t, 256> table = []()
+		{
+			std::array<std::uint32_t, 256> table{};
+			for (std::uint32_t i = 0; i < 256; ++i)
+			{
+				std::uint32_t value = i;
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+				}
+				table[i] = value;
+			}
+			return table;
+		}();
+
+		std::uint32_t crc = 0xFFFFFFFF;
+		for (std::byte byte : bytes)
+		{
+			crc = table[(crc ^ static_cast<std::uint32_t>(byte)) & 0xFF] ^ (crc >> 8);
+		}
+		return crc ^ 0xFFFFFFFF;
+	}
+
+	class Writer
+	{
+	  private:
+		std::ofstream _stream;
+		std::uint64_t _offset;
+
+	  public:
+		explicit Writer(const std::filesystem::path &path)
+		    : _stream(path, std::ios::binary | std::ios::trunc),
+		      _offset(0)
+		{
+			if (!_stream)
+			{
+				throw std::runtime_error(std::format("Cannot open \"{}\" for writing", path.generic_string()));
+			}
+		}
+
+		std::uint64_t GetOffset() const noexcept
+		{
+			return _offset;
+		}
+
+		void U16(std::uint16_t value)
+		{
+			const char data[2]{
+			    static_cast<char>(value & 0xFF),
+			    static_cast<char>((value >> 8) & 0xFF),
+			};
+			Bytes(data, sizeof(data));
+		}
+
+		void U32(std::uint32_t value)
+		{
+			const char data[4]{
+			    static_cast<char>(value & 0xFF),
+			    static_cast<char>((value >> 8) & 0xFF),
+			    static_cast<char>((value >> 16) & 0xFF),
+			    static_cast<char>((value >> 24) & 0xFF),
+			};
+			Bytes(data, sizeof(data));
+		}
+
+		void Zeros(std::size_t count)
+		{
+			static constexpr char zeros[64]{};
+			while (count > 0)
+			{
+				std::size_t size = std::min(count, sizeof(zeros));
+				Bytes(zeros, size);
+				count -= size;
+			}
+		}
+
+		void Bytes(const void *data, std::size_t size)
+		{
+			_stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+			if (!_stream)
+			{
+				throw std::runtime_error("Failed to write package");
+			}
+			_offset += size;
+		}
+	};
+
+	std::uint16_t ToU16(std::size_t value, std::string_view what)
+	{
+		if (value > std::numeric_limits<std::uint16_t>::max())
+		{
+			throw std::runtime_error(std::format("Too many {} for a zip without zip64: {}", what, value));
+		}
+		return static_cast<std::uint16_t>(value);
+	}
+
+	std::uint32_t ToU32(std::uint64_t value, std::string_view what)
+	{
+		if (value > std::numeric_limits<std::uint32_t>::max())
+		{
+			throw std::runtime_error(std::format("{} is too large for a zip without zip64: {}", what, value));
+		}
+		return static_cast<std::uint32_t>(value);
+	}
+
+	std::vector<std::byte> ReadFile(const std::filesystem::path &path)
+	{
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream)
+		{
+			throw std::runtime_error(std::format("Cannot open \"{}\"", path.generic_string()));
+		}
+
+		std::vector<std::byte> bytes(static_cast<std::size_t>(stream.tellg()));
+		stream.seekg(0);
+		stream.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		if (!stream)
+		{
+			throw std::runtime_error(std::format("Failed to read \"{}\"", path.generic_string()));
+		}
+		return bytes;
+	}
+
+	/**
+	 * Compile lua source into LuaJIT bytecode, debug info is kept so that errors still point at the script.
+	 * @throw std::runtime_error Script has syntax errors.
+	 */
+	std::vector<std::byte> CompileScript(lua_State *L, std::string_view name, std::span<const std::byte> source)
+	{
+		std::string chunkName = std::format("@{}", name);
+		if (luaL_loadbuffer(L, reinterpret_cast<const char *>(source.data()), source.size(), chunkName.c_str()) != 0)
+		{
+			std::string error = lua_tostring(L, -1);
+			lua_pop(L, 1);
+			throw std::runtime_error(error);
+		}
+
+		std::vector<std::byte> bytecode;
+		lua_dump(L, [](lua_State *, const void *data, std::size_t size, void *userdata) -> int
+		{
+			auto &bytecode = *static_cast<std::vector<std::byte> *>(userdata);
+			auto *begin = static_cast<const std::byte *>(data);
+			bytecode.insert(bytecode.end(), begin, begin + size);
+			return 0;
+		}, &bytecode);
+		lua_pop(L, 1);
+
+		return bytecode;
+	}
+
+	std::vector<Entry> CollectEntries(const Options &options)
+	{
+		std::vector<Entry> entries;
+		for (const std::filesystem::directory_entry &entry : std::filesystem::recursive_directory_iterator(options.input))
+		{
+			if (entry.is_regular_file())
+			{
+				entries.emplace_back(Entry{
+				    .name = std::filesystem::relative(entry.path(), options.input).generic_string(),
+				    .size = 0,
+				    .crc = 0,
+				    .localHeaderOffset = 0,
+				});
+			}
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry &l, const Entry &r)
+		{
+			return l.name < r.name;
+		});
+
+		return entries;
+	}
+
+	void WriteEntry(const Options &options, Writer &writer, lua_State *L, Entry &entry)
+	{
+		std::vector<std::byte> bytes = ReadFile(options.input / entry.name);
+
+		if (L != nullptr && std::filesystem::path(entry.name).extension() == ".lua")
+		{
+			try
+			{
+				bytes = CompileScript(L, entry.name, bytes);
+			}
+			catch (const std::exception &e)
+			{
+				throw std::runtime_error(std::format("Failed to compile \"{}\": {}", entry.name, e.what()));
+			}
+		}
+
+		std::uint64_t headerOffset = writer.GetOffset();
+		std::uint64_t dataOffset = headerOffset + localHeaderSize + entry.name.size();
+
+		std::size_t extraSize = 0;
+		if (std::size_t misaligned = dataOffset % options.alignment; misaligned != 0)
+		{
+			extraSize = options.alignment - misaligned;
+			while (extraSize < extraHeaderSize)
+			{
+				extraSize += options.alignment;
+			}
+		}
+
+		entry.size = ToU32(bytes.size(), entry.name);
+		entry.crc = CRC32(bytes);
+		entry.localHeaderOffset = ToU32(headerOffset, "Package");
+
+		writer.U32(localHeaderSignature);
+		writer.U16(versionStored);
+		writer.U16(flagUTF8);
+		writer.U16(methodStored);
+		writer.U16(dosTime);
+		writer.U16(dosDate);
+		writer.U32(entry.crc);
+		writer.U32(entry.size);
+		writer.U32(entry.size);
+		writer.U16(ToU16(entry.name.size(), "name characters"));
+		writer.U16(static_cast<std::uint16_t>(extraSize));
+		writer.Bytes(entry.name.data(), entry.name.size());
+		if (extraSize != 0)
+		{
+			writer.U16(paddingExtraId);
+			writer.U16(static_cast<std::uint16_t>(extraSize - extraHeaderSize));
+			writer.Zeros(extraSize - extraHeaderSize);
+		}
+		writer.Bytes(bytes.data(), bytes.size());
+
+		if (options.verbose)
+		{
+			std::cout << std::format("{:>10} {}\n", entry.size, entry.name);
+		}
+	}
+
+	void WritePackage(const Options &options, std::vector<Entry> &entries)
+	{
+		std::uint16_t count = ToU16(entries.size(), "files");
+
+		Writer writer{options.output};
+
+		if (options.bytecode)
+		{
+			lua_State *L = luaL_newstate();
+			if (L == nullptr) [[unlikely]]
+			{
+				throw std::runtime_error("Failed to create lua state");
+			}
+
+			try
+			{
+				for (Entry &entry : entries)
+				{
+					WriteEntry(options, writer, L, entry);
+				}
+			}
+			catch (...)
+			{
+				lua_close(L);
+				throw;
+			}
+			lua_close(L);
+		}
+		else
+		{
+			for (Entry &entry : entries)
+			{
+				WriteEntry(options, writer, nullptr, entry);
+			}
+		}
+
+		std::uint64_t centralDirectoryOffset = writer.GetOffset();
+
+		for (const Entry &entry : entries)
+		{
+			writer.U32(centralHeaderSignature);
+			writer.U16(versionStored);
+			writer.U16(versionStored);
+			writer.U16(flagUTF8);
+			writer.U16(methodStored);
+			writer.U16(dosTime);
+			writer.U16(dosDate);
+			writer.U32(entry.crc);
+			writer.U32(entry.size);
+			writer.U32(entry.size);
+			writer.U16(static_cast<std::uint16_t>(entry.name.size()));
+			writer.U16(0); // Extra field, padding is only needed in local headers.
+			writer.U16(0); // Comment.
+			writer.U16(0); // Disk number.
+			writer.U16(0); // Internal attributes.
+			writer.U32(0); // External attributes.
+			writer.U32(entry.localHeaderOffset);
+			writer.Bytes(entry.name.data(), entry.name.size());
+		}
+
+		std::uint64_t centralDirectorySize = writer.GetOffset() - centralDirectoryOffset;
+
+		writer.U32(endOfCentralDirectorySignature);
+		writer.U16(0);
+		writer.U16(0);
+		writer.U16(count);
+		writer.U16(count);
+		writer.U32(ToU32(centralDirectorySize, "Central directory"));
+		writer.U32(ToU32(centralDirectoryOffset, "Package"));
+		writer.U16(0);
+	}
+
+	bool ParseArguments(std::span<char *> args, Options &options)
+	{
+		std::vector<std::string_view> positional;
+
+		for (std::string_view arg : args)
+		{
+			if (arg == "--bytecode")
+			{
+				options.bytecode = true;
+			}
+			else if (arg == "--verbose")
+			{
+				options.verbose = true;
+			}
+			else if (arg.starts_with("--align="))
+			{
+				std::string_view value = arg.substr(8);
+				std::size_t alignment = 0;
+				auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), alignment);
+				if (ec != std::errc() || end != value.data() + value.size() || alignment == 0 || (alignment & (alignment - 1)) != 0 ||
+				    alignment > 4096)
+				{
+					std::cerr << std::format("Alignment must be a power of two up to 4096: \"{}\"\n", value);
+					return false;
+				}
+				options.alignment = alignment;
+			}
+			else if (arg.starts_with("--"))
+			{
+				std::cerr << std::format("Unknown option \"{}\"\n", arg);
+				return false;
+			}
+			else
+			{
+				positional.emplace_back(arg);
+			}
+		}
+
+		if (positional.size() != 2)
+		{
+			return false;
+		}
+
+		options.input = positional[0];
+		options.output = positional[1];
+		return true;
+	}
+} // namespace
+
+int main(int argc, char **argv)
+{
+	Options options{};
+	if (!ParseArguments(std::span<char *>(argv + 1, argc > 0 ? argc - 1 : 0), options))
+	{
+		std::cerr << "Usage: tudov-pack <input directory> <output .pck> [--bytecode] [--align=64] [--verbose]\n"
+		             "  --bytecode  Compile lua scripts to LuaJIT bytecode\n"
+		             "  --align=N   Align file contents to N bytes, power of two\n"
+		             "  --verbose   List packed files\n";
+		return 2;
+	}
+
+	try
+	{
+		if (!std::filesystem::is_directory(options.input))
+		{
+			throw std::runtime_error(std::format("Input \"{}\" is not a directory", options.input.generic_string()));
+		}
+
+		std::vector<Entry> entries = CollectEntries(options);
+		WritePackage(options, entries);
+
+		std::cout << std::format("Packed {} files into \"{}\"\n", entries.size(), options.output.generic_string());
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << '\n';
+		std::error_code ec;
+		std::filesystem::remove(options.output, ec);
+		return 1;
+	}
+
+	return 0;
+}